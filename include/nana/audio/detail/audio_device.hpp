@@ -5,6 +5,7 @@
 
 #ifdef NANA_ENABLE_AUDIO
 
+#include <nana/audio/player.hpp>
 #include <nana/audio/detail/buffer_preparation.hpp>
 #include <vector>
 #if defined(NANA_WINDOWS)
@@ -26,14 +27,17 @@ namespace nana{	namespace audio
 			~audio_device();
 
 			bool empty() const;
-			bool open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample);
+			bool open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample, const player::parameters&);
 			void close();
 			void prepare(buffer_preparation & buf_prep);
 			void write(buffer_preparation::meta * m);
 			void wait_for_drain() const;
+			std::size_t underruns() const;
 		private:
 #if defined(NANA_WINDOWS)
 			static void __stdcall _m_dev_callback(HWAVEOUT handle, UINT msg, audio_device * self, DWORD_PTR, DWORD_PTR);
+#elif defined(NANA_LINUX)
+			bool _m_recover(int err);
 #endif
 
 #if defined(NANA_WINDOWS)
@@ -46,6 +50,7 @@ namespace nana{	namespace audio
 			std::size_t channels_;
 			std::size_t bytes_per_sample_;
 			std::size_t bytes_per_frame_;
+			snd_pcm_uframes_t period_size_;
 #elif defined(NANA_POSIX)
 			int handle_;
 			int rate_;
@@ -54,6 +59,7 @@ namespace nana{	namespace audio
 			int bytes_per_frame_;
 #endif
 			buffer_preparation * buf_prep_;
+			std::atomic<std::size_t> underruns_;
 		};
 
 	}//end namespace detail
@@ -16,7 +16,7 @@
     #include <thread>
 #endif
 
-#include <sstream>
+#include <atomic>
 #include <vector>
 
 #if defined(NANA_WINDOWS)
@@ -27,6 +27,92 @@ namespace nana{	namespace audio
 {
 	namespace detail
 	{
+		/// A lock-free queue for exactly one producer thread and one consumer thread.
+		template<typename T>
+		class spsc_ring
+		{
+		public:
+			explicit spsc_ring(std::size_t capacity)
+				: slots_(capacity + 1)
+			{}
+
+			/// Called by the producer, returns false if the ring is full.
+			bool push(T value)
+			{
+				auto const tail = tail_.load(std::memory_order_relaxed);
+				auto const next = (tail + 1 == slots_.size() ? 0 : tail + 1);
+				if (next == head_.load(std::memory_order_acquire))
+					return false;
+
+				slots_[tail] = value;
+				tail_.store(next, std::memory_order_release);
+				return true;
+			}
+
+			/// Called by the consumer, returns false if the ring is empty.
+			bool pop(T& value)
+			{
+				auto const head = head_.load(std::memory_order_relaxed);
+				if (head == tail_.load(std::memory_order_acquire))
+					return false;
+
+				value = slots_[head];
+				head_.store((head + 1 == slots_.size() ? 0 : head + 1), std::memory_order_release);
+				return true;
+			}
+
+			bool empty() const
+			{
+				return (head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire));
+			}
+
+			std::size_t size() const
+			{
+				auto const head = head_.load(std::memory_order_acquire);
+				auto const tail = tail_.load(std::memory_order_acquire);
+				return (tail >= head ? tail - head : tail + slots_.size() - head);
+			}
+		private:
+			std::vector<T> slots_;
+
+			//The indexes are kept in different cache lines, the producer and the consumer don't share a line.
+			char pad_front_[64];
+			std::atomic<std::size_t> head_{ 0 };
+			char pad_middle_[64 - sizeof(std::atomic<std::size_t>)];
+			std::atomic<std::size_t> tail_{ 0 };
+			char pad_back_[64 - sizeof(std::atomic<std::size_t>)];
+		};
+
+		/// Blocks a thread until a condition is satisfied. The notifier takes the mutex only if
+		/// there is a waiting thread, so the data path between threads is free of locks.
+		class wait_point
+		{
+		public:
+			template<typename Predicate>
+			void wait(Predicate ready)
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				sleeping_.store(true);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				cond_.wait(lock, ready);
+				sleeping_.store(false);
+			}
+
+			void notify()
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (sleeping_.load())
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					cond_.notify_one();
+				}
+			}
+		private:
+			std::atomic<bool> sleeping_{ false };
+			std::mutex mutex_;
+			std::condition_variable cond_;
+		};
+
 		class buffer_preparation
 		{
 		public:
@@ -41,7 +127,8 @@ namespace nana{	namespace audio
 #endif
 
 		public:
-			buffer_preparation(audio_stream& as, std::size_t seconds);
+			/// Prepares the PCM data in blocks of block_bytes, at most the specified number of blocks are buffered.
+			buffer_preparation(audio_stream& as, std::size_t block_bytes, std::size_t blocks);
 
 			~buffer_preparation();
 
@@ -52,13 +139,16 @@ namespace nana{	namespace audio
 		private:
 			void _m_prepare_routine();
 		private:
-			volatile bool running_;
-			volatile bool wait_for_buffer_;
+			std::atomic<bool> running_;
 			std::thread thr_;
-			mutable std::mutex token_buffer_, token_prepared_;
-			mutable std::condition_variable	cond_buffer_, cond_prepared_;
 
-			std::vector<meta*> buffer_, prepared_;
+			std::vector<meta*> blocks_;
+			meta * drained_;	//The block which is not used when PCM data is drained.
+
+			spsc_ring<meta*> prepared_;	//Blocks to be filled by the preparation thread.
+			spsc_ring<meta*> buffer_;	//Blocks filled with PCM data.
+			wait_point wait_prepared_, wait_buffer_;
+
 			std::size_t block_size_;
 			audio_stream & as_;
 		};
@@ -6,6 +6,7 @@
 #ifdef NANA_ENABLE_AUDIO
 
 #include <nana/traits.hpp>
+#include <string>
 
 namespace nana{	namespace audio
 {       /// class player
@@ -17,13 +18,25 @@ namespace nana{	namespace audio
 	{
 		struct implementation;
 	public:
+		/// Parameters of the audio output device
+		struct parameters
+		{
+			std::string device;				///< The name of PCM device, e.g. "null" of ALSA. Empty for the default device.
+			std::size_t period_ms{ 5 };		///< The length of a period, the PCM data is transferred to the device in periods.
+			std::size_t periods{ 4 };		///< The number of periods of the device buffer.
+		};
+
 		player();
 		player(const std::string& file);
 		~player();
 
 		bool open(const std::string& file);
+		bool open(const std::string& file, const parameters&);
 		void play();
 		void close();
+
+		/// Returns the number of underruns of the device since it is opened.
+		std::size_t underruns() const;
 	private:
 		implementation* impl_;
 	};
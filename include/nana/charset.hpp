@@ -13,6 +13,7 @@
 #ifndef NANA_CHARSET_HPP
 #define NANA_CHARSET_HPP
 #include <string>
+#include <cstddef>
 
 namespace nana
 {
@@ -32,6 +33,38 @@ namespace nana
 		/// @returns A unicode character. '\0' if pos is out of range.
 		wchar_t char_at(const char* text_utf8, unsigned pos, unsigned * len);
 		wchar_t char_at(const ::std::string& text_utf8, unsigned pos, unsigned * len);
+
+		/// The result of a transcoding.
+		struct transcode_result
+		{
+			std::size_t read;		///< The number of code units consumed from the input.
+			std::size_t written;	///< The number of code units written to the output, or required if the output is a nullptr.
+			bool valid;				///< false if an ill-formed sequence is found at the position 'read' of the input.
+		};
+
+		/// Converts a text between UTF-8(char), UTF-16(char16_t) and UTF-32(char32_t) without allocating memory.
+		/**
+		 * wchar_t is treated as UTF-16 if it is 2 bytes, otherwise UTF-32.
+		 * The conversion stops at an ill-formed sequence, or at a character which doesn't fit in the output.
+		 * @param in The input text.
+		 * @param len The number of code units of the input.
+		 * @param out A buffer to receive the converted text. If it is a nullptr, the input is only validated and
+		 *		the exact number of code units required for the output is returned.
+		 * @param out_len The number of code units of the output buffer.
+		 */
+		transcode_result transcode(const char* in, std::size_t len, char16_t* out, std::size_t out_len);
+		transcode_result transcode(const char* in, std::size_t len, char32_t* out, std::size_t out_len);
+		transcode_result transcode(const char* in, std::size_t len, wchar_t* out, std::size_t out_len);
+		transcode_result transcode(const char16_t* in, std::size_t len, char* out, std::size_t out_len);
+		transcode_result transcode(const char16_t* in, std::size_t len, char32_t* out, std::size_t out_len);
+		transcode_result transcode(const char32_t* in, std::size_t len, char* out, std::size_t out_len);
+		transcode_result transcode(const char32_t* in, std::size_t len, char16_t* out, std::size_t out_len);
+		transcode_result transcode(const wchar_t* in, std::size_t len, char* out, std::size_t out_len);
+
+		/// Converts a string with the exact-size allocation.
+		/// @return false if the input is ill-formed, the output is unchanged.
+		bool transcode(const ::std::string& utf8, ::std::wstring& out);
+		bool transcode(const ::std::wstring& in, ::std::string& utf8);
 	}
 
 	enum class unicode
@@ -34,7 +34,9 @@ namespace nana
 	public:
 		frameset();
 		void push_back(paint::image);        ///< Inserts frames at the end.
-		void push_back(framebuilder fb, std::size_t length);  ///< Insters a framebuilder and the number of frames that it generates.
+		/// Insters a framebuilder and the number of frames that it generates.
+		/// The generated frames are cached, the builder is invoked only once for each pos.
+		void push_back(framebuilder fb, std::size_t length);
 	private:
 		std::shared_ptr<impl> impl_;
 	};
@@ -233,6 +233,13 @@ namespace detail
 			basic_window *active_window;	///< if flags.take_active is false, the active_window still keeps the focus,
 											///< if the active_window is null, the parent of this window keeps focus.
 			paint::graphics glass_buffer;	///< if effect.bground is avaiable. Refer to window_layout::make_bground.
+
+			struct glass_cache_tag
+			{
+				paint::graphics	source;			///< The composed background before the effect is taken, kept only if the effect spreads pixels.
+				std::size_t		signature{ 0 };	///< Identifies the windows and geometry the background was composed from.
+				bool			valid{ false };
+			}glass_cache;
 			update_state	upd_state;
 
 			union
@@ -2,27 +2,35 @@
 #define NANA_DETAIL_EVENTS_OPERATION_HPP
 
 #include <nana/gui/detail/general_events.hpp>
-#include <unordered_set>
-
-#if defined(STD_THREAD_NOT_SUPPORTED)
-#include <nana/std_mutex.hpp>
-#else
-#include <mutex>
-#endif
+#include <vector>
 
 namespace nana
 {
 	namespace detail
 	{
+		/// A table of event handles.
+		/**
+		 * An event handle refers to a slot of the table and the generation of the slot. The generation is
+		 * increased when the handle is cancelled, so that the slot can be reused without a stale handle
+		 * referring to a new event handler. All the operations require the internal lock.
+		 */
 		class events_operation
 		{
+			struct slot
+			{
+				event_interface* event;
+				std::size_t generation;
+				std::size_t next_free;
+			};
 		public:
-			void register_evt(event_handle);
+			event_handle register_evt(event_interface*);
 			void cancel(event_handle);
 			void erase(event_handle);
 		private:
-			std::recursive_mutex mutex_;
-			std::unordered_set<event_handle>	handles_;
+			slot* _m_find(event_handle);
+		private:
+			std::vector<slot> slots_;
+			std::size_t free_{ static_cast<std::size_t>(-1) };
 		};
 	}//end namespace detail
 }//end namespace nana
@@ -18,15 +18,17 @@
 #include "event_code.hpp"
 #include "internal_scope_guard.hpp"
 #include <type_traits>
+#include <algorithm>
 #include <functional>
 #include <vector>
+#include <memory>
+#include <atomic>
 
 namespace nana
 {
 	namespace detail
 	{
 		bool check_window(window);
-		void events_operation_register(event_handle);
 
 		class event_interface
 		{
@@ -35,54 +37,28 @@ namespace nana
 			virtual void remove(event_handle) = 0;
 		};
 
-		class docker_interface
-		{
-		public:
-			virtual ~docker_interface() = default;
-			virtual event_interface*	get_event() const = 0;
-		};
-
-
-		struct docker_base
-			: public docker_interface
-		{
-			event_interface * event_ptr;
-			bool flag_deleted{ false };
-			const bool unignorable;
-
-			docker_base(event_interface*, bool unignorable_flag);
-
-			detail::event_interface * get_event() const override;
-		};
+		//Allocates and releases a handle of an event handler. The handles are generation-checked slots
+		//which are owned by bedrock, a stale handle is rejected by umake_event.
+		//Both of them require the internal lock.
+		event_handle events_operation_register(event_interface*);
+		void events_operation_cancel(event_handle);
 
 		class event_base
 			: public detail::event_interface
 		{
 		public:
-			~event_base();
-
-			std::size_t length() const;
-			void clear() noexcept;
-
-			void remove(event_handle evt) override;
-		protected:
-			//class emit_counter is a RAII helper for emitting count
-			//It is used for avoiding a try{}catch block which is required for some finial works when
-			//event handlers throw exceptions. Precondition event_base.dockers_ != nullptr.
-			class emit_counter
+			/// Returns the number of the connected event handlers.
+			std::size_t length() const
 			{
-			public:
-				emit_counter(event_base*);
-				~emit_counter();
-			private:
-				event_base * const evt_;
-			};
-			
-			event_handle _m_emplace(detail::docker_interface*, bool in_front);
+				return length_.load(std::memory_order_relaxed);
+			}
 		protected:
 			unsigned emitting_count_{ 0 };
 			bool deleted_flags_{ false };
-			std::vector<detail::docker_interface*> * dockers_{ nullptr };
+
+			//It is updated under the internal lock, and it is read without the lock
+			//for returning from an emission of an event which has no handler.
+			std::atomic<std::size_t> length_{ 0 };
 		};
 	}//end namespace detail
 
@@ -115,27 +91,60 @@ namespace nana
 	public:
 		using arg_reference = const typename std::remove_reference<Arg>::type &;
 	private:
+		/// The event handlers are stored by value in a contiguous sequence.
 		struct docker
-			: public detail::docker_base
-		{	
+		{
+			event_handle handle;
+
 			/// the callback/response function taking the typed argument
 			std::function<void(arg_reference)> invoke;
 
-			docker(basic_event * evt, std::function<void(arg_reference)> && ivk, bool unignorable_flag)
-				: docker_base(evt, unignorable_flag), invoke(std::move(ivk))
-			{}
+			bool unignorable;
+			bool in_front;		///< Used by a handler which is connected while emitting
+			bool flag_deleted;
+		};
+
+		struct storage
+		{
+			std::vector<docker> dockers;
+
+			//The handlers which are connected while emitting. They are moved into dockers after the emission,
+			//so that the dockers never reallocate when they are traversed.
+			std::vector<docker> pending;
+		};
 
-			docker(basic_event * evt, const std::function<void(arg_reference)> & ivk, bool unignorable_flag)
-				: docker_base(evt, unignorable_flag), invoke(ivk)
-			{}
+		//class emit_counter is a RAII helper for emitting count
+		//It is used for avoiding a try{}catch block which is required for some finial works when
+		//event handlers throw exceptions. Precondition basic_event.storage_ != nullptr.
+		class emit_counter
+		{
+		public:
+			emit_counter(basic_event* evt)
+				: evt_{ evt }
+			{
+				++evt->emitting_count_;
+			}
+
+			~emit_counter()
+			{
+				if (0 == --evt_->emitting_count_)
+					evt_->_m_settle();
+			}
+		private:
+			basic_event * const evt_;
 		};
 	public:
+		~basic_event()
+		{
+			clear();
+		}
+
 		/// Creates an event handler at the beginning of event chain
 		template<typename Function>
 		event_handle connect_front(Function && fn)
 		{	
 			using prototype = typename std::remove_reference<Function>::type;
-			return _m_emplace(new docker(this, factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), false), true);
+			return _m_emplace(factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), false, true);
 		}
 
 		/// It will not get called if stop_propagation() was called.
@@ -151,7 +160,7 @@ namespace nana
 		event_handle connect(Function && fn)
 		{
 			using prototype = typename std::remove_reference<Function>::type;
-			return _m_emplace(new docker(this, factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), false), false);
+			return _m_emplace(factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), false, false);
 		}
 
 		/// It will not get called if stop_propagation() was called.
@@ -167,29 +176,32 @@ namespace nana
 		{			
 			using prototype = typename std::remove_reference<Function>::type;
 
-			return _m_emplace(new docker(this, factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), true), in_front);
+			return _m_emplace(factory<prototype, std::is_bind_expression<prototype>::value>::build(std::forward<Function>(fn)), true, in_front);
 		}
 
 		void emit(arg_reference& arg, window window_handle)
 		{
+			//Most of the events of a widget have no handler, returns without acquiring the lock.
+			if (0 == length_.load(std::memory_order_acquire))
+				return;
+
 			internal_scope_guard lock;
-			if (nullptr == dockers_)
+			if (nullptr == storage_)
 				return;
 
 			emit_counter ec(this);
 
-			//The dockers may resize when a new event handler is created by a calling handler.
-			//Traverses with position can avaid crash error which caused by a iterator which becomes invalid.
-
-			auto i = dockers_->data();
-			auto const end = i + dockers_->size();
+			//The handlers connected by a calling handler are pending until the emission is finished,
+			//and the removed handlers are only flagged, therefore the dockers are not changed during traversal.
+			auto i = storage_->dockers.data();
+			auto const end = i + storage_->dockers.size();
 
 			for (; i != end; ++i)
 			{
-				if (static_cast<docker*>(*i)->flag_deleted)
+				if (i->flag_deleted)
 					continue;
 
-				static_cast<docker*>(*i)->invoke(arg);
+				i->invoke(arg);
 
 				if (window_handle && (!detail::check_window(window_handle)))
 					break;
@@ -198,10 +210,10 @@ namespace nana
 				{
 					for (++i; i != end; ++i)
 					{
-						if (!static_cast<docker*>(*i)->unignorable || static_cast<docker*>(*i)->flag_deleted)
+						if (!i->unignorable || i->flag_deleted)
 							continue;
 
-						static_cast<docker*>(*i)->invoke(arg);
+						i->invoke(arg);
 						if (window_handle && (!detail::check_window(window_handle)))
 							break;
 					}
@@ -209,6 +221,114 @@ namespace nana
 				}
 			}
 		}
+
+		void clear() noexcept
+		{
+			internal_scope_guard lock;
+			if (nullptr == storage_)
+				return;
+
+			for (auto & dk : storage_->pending)
+				detail::events_operation_cancel(dk.handle);
+			storage_->pending.clear();
+
+			for (auto & dk : storage_->dockers)
+			{
+				if (!dk.flag_deleted)
+				{
+					detail::events_operation_cancel(dk.handle);
+					dk.flag_deleted = true;
+				}
+			}
+
+			length_.store(0, std::memory_order_release);
+
+			//The dockers are being traversed, they will be erased after the emission.
+			if (emitting_count_)
+				deleted_flags_ = true;
+			else
+				storage_.reset();
+		}
+
+		void remove(event_handle evt) override
+		{
+			internal_scope_guard lock;
+			if (nullptr == storage_)
+				return;
+
+			auto & pending = storage_->pending;
+			for (auto i = pending.begin(); i != pending.end(); ++i)
+			{
+				if (i->handle == evt)
+				{
+					detail::events_operation_cancel(evt);
+					pending.erase(i);
+					--length_;
+					return;
+				}
+			}
+
+			auto & dockers = storage_->dockers;
+			for (auto i = dockers.begin(); i != dockers.end(); ++i)
+			{
+				if ((i->handle == evt) && !i->flag_deleted)
+				{
+					detail::events_operation_cancel(evt);
+					--length_;
+
+					//Checks whether this event is working now.
+					if (emitting_count_)
+					{
+						i->flag_deleted = true;
+						deleted_flags_ = true;
+					}
+					else
+						dockers.erase(i);
+					return;
+				}
+			}
+		}
+	private:
+		event_handle _m_emplace(std::function<void(arg_reference)>&& fn, bool unignorable, bool in_front)
+		{
+			internal_scope_guard lock;
+			if (nullptr == storage_)
+				storage_.reset(new storage);
+
+			auto evt = detail::events_operation_register(this);
+
+			if (emitting_count_)
+				storage_->pending.push_back(docker{ evt, std::move(fn), unignorable, in_front, false });
+			else if (in_front)
+				storage_->dockers.insert(storage_->dockers.begin(), docker{ evt, std::move(fn), unignorable, in_front, false });
+			else
+				storage_->dockers.push_back(docker{ evt, std::move(fn), unignorable, in_front, false });
+
+			length_.fetch_add(1, std::memory_order_release);
+			return evt;
+		}
+
+		//Erases the flagged handlers and appends the pending handlers when the emission is finished.
+		void _m_settle()
+		{
+			auto & dockers = storage_->dockers;
+			if (deleted_flags_)
+			{
+				deleted_flags_ = false;
+				dockers.erase(std::remove_if(dockers.begin(), dockers.end(), [](const docker& dk){
+					return dk.flag_deleted;
+				}), dockers.end());
+			}
+
+			for (auto & dk : storage_->pending)
+			{
+				if (dk.in_front)
+					dockers.insert(dockers.begin(), std::move(dk));
+				else
+					dockers.push_back(std::move(dk));
+			}
+			storage_->pending.clear();
+		}
 	private:
 		template<typename Fn, bool IsBind>
 		struct factory
@@ -385,6 +505,8 @@ namespace nana
 				};
 			}
 		};
+	private:
+		std::unique_ptr<storage> storage_;
 	};
  
 	struct arg_mouse
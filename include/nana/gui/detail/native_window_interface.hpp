@@ -41,6 +41,10 @@ namespace detail
 		//Execute a function in a thread which is associated with the specified native window.
 		static void affinity_execute(native_window_type, const std::function<void()>&);
 
+		//Post a function to the message queue of the thread which is associated with the specified native window.
+		//It returns false if the function can't be posted.
+		static bool post(native_window_type, std::function<void()>&&);
+
 		static nana::size	primary_monitor_size();
 		static rectangle screen_area_from_point(const point&);
 		static window_result create_window(native_window_type, bool nested, const rectangle&, const appearance&);
@@ -92,6 +96,10 @@ namespace detail
 
 		static native_window_type find_window(int x, int y);
 		static nana::size check_track_size(nana::size sz, unsigned extra_width, unsigned extra_height, bool true_for_max);
+
+		/// Returns the number of window geometry queries answered from the cache instead of the display server.
+		/// It is always 0 on Windows, where these queries do not involve a round trip.
+		static std::size_t round_trips_avoided();
 	};
 
 
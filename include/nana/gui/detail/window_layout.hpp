@@ -84,10 +84,23 @@ namespace detail
 		 */
 		static void _m_paste_children(core_window_t* window, bool has_refreshed, bool request_refresh_children, const nana::rectangle& parent_rect, nana::paint::graphics& graph, const nana::point& graph_rpos);
 
-		static void _m_paint_glass_window(core_window_t*, bool is_redraw, bool is_child_refreshed, bool called_by_notify, bool notify_other);
+		/// Paints a glass window.
+		/// @param damage The changed area(in root coordinate) under the glass window, nullptr if the area under the window is not changed.
+		static void _m_paint_glass_window(core_window_t*, bool is_redraw, bool is_child_refreshed, bool called_by_notify, bool notify_other, const nana::rectangle* damage);
 
 		//Notify the windows which have brground to update their background buffer.
-		static void _m_notify_glasses(core_window_t* const sigwd);
+		//The damage is the changed area of sigwd in root coordinate, nullptr means the whole sigwd.
+		static void _m_notify_glasses(core_window_t* const sigwd, const nana::rectangle* damage);
+
+		//Composes the content under the specified area(in the coordinate of the glass window) of a glass window.
+		static void _m_compose_bground(core_window_t* const, nana::paint::graphics&, const nana::rectangle& area);
+
+		//Updates the cached background of a glass window for a damage in root coordinate.
+		//Returns the changed area of the glass buffer, it is empty if the cached background is reused.
+		static nana::rectangle _m_update_bground(core_window_t* const, const nana::rectangle* damage);
+
+		//Returns a value identifies the windows and their geometry which the background of a glass window is composed from.
+		static std::size_t _m_bground_signature(core_window_t* const);
 	private:
 		struct data_section
 		{
@@ -30,6 +30,11 @@ namespace nana
 
 			virtual ~bground_interface() = 0;
 			virtual void take_effect(window, graph_reference) const = 0;
+
+			/// Returns how many pixels a changed background pixel affects around it.
+			/// A negative value indicates the effect depends on the whole background, and the background is
+			/// rebuilt entirely when a part of it is changed. The default implementation returns -1.
+			virtual int spread() const;
 		};
 
 		class bground_factory_interface
@@ -107,6 +107,17 @@ namespace API
 		 */
 		void lazy_refresh();
 
+		/// Defers the screen updates of a window and its children
+		/**
+		 * The children are drawn to their buffers but are not copied to the screen until the deferral ends.
+		 * @return true if the caller should end the deferral by calling end_deferred_updates(). It returns false if the window
+		 * is processing an event, then the deferred updates are flushed when the event is finished.
+		 */
+		bool defer_updates(window);
+
+		/// Ends the deferral of screen updates, the window is composed and copied to the screen once.
+		void end_deferred_updates(window);
+
 		void draw_shortkey_underline(paint::graphics&, const std::string& text, wchar_t shortkey, std::size_t shortkey_position, const point& text_pos, const color&);
 	}//end namespace dev
 
@@ -302,6 +313,32 @@ namespace API
 	size window_outline_size(window);
 	void window_outline_size(window, const size&);
 
+	/// Collects the moves and resizes of windows and applies them at once.
+	/**
+	 * The requests are applied when commit() is called or when the transaction is destroyed. The requests for a same window
+	 * are merged, so that each window emits the move and resized events at most once, and the changed areas of widgets are
+	 * composed and copied to the screen once for each native window.
+	 */
+	class geometry_transaction
+	{
+		struct implementation;
+	public:
+		geometry_transaction();
+		~geometry_transaction();	///< Commits the requests which are not committed.
+
+		geometry_transaction(const geometry_transaction&) = delete;
+		geometry_transaction& operator=(const geometry_transaction&) = delete;
+
+		void move(window, const point&);
+		void move(window, const rectangle&);
+		void size(window, const ::nana::size&);
+
+		/// Applies the collected requests.
+		void commit();
+	private:
+		std::unique_ptr<implementation> impl_;
+	};
+
 	nana::optional<rectangle> window_rectangle(window);
 	bool get_window_rectangle(window, rectangle&);
 	bool track_window_size(window, const size&, bool true_for_max);   ///< Sets the minimum or maximum tracking size of a window.
@@ -317,6 +354,22 @@ namespace API
 	void refresh_window_tree(window);      ///< Refreshes the specified window and all its children windows, then display it immediately
 	void update_window(window);            ///< Copies the off-screen buffer to the screen for immediate display.
 
+	/// Posts a function to the thread which owns the window and returns immediately.
+	/*
+	 * The function is executed in the event loop of the thread which created the window, and it is skipped if the
+	 * window is destroyed before. It can be called from any thread, e.g. a worker thread which updates a widget.
+	 * @return true if the function is posted.
+	 */
+	bool post(window, std::function<void()>);
+
+	/// Posts a function like post(), but the function replaces the pending one that is posted with the same key for the window.
+	/*
+	 * The pending functions of a window are executed at most once per frame tick(about 16 milliseconds), so a burst of
+	 * posts with the same key results in a single execution of the latest function, and a high-frequency data feed
+	 * updates the widget at most once per frame.
+	 */
+	bool post_coalesced(window, std::size_t key, std::function<void()>);
+
 	void window_caption(window, const std::string& title_utf8);
 	void window_caption(window, const std::wstring& title);
 	::std::string window_caption(window);
@@ -38,6 +38,10 @@ namespace nana
 			{
 				std::vector<std::shared_ptr<item_interface>> items;
 
+				/// The positions of the displayed items. All the items are displayed if filtered is false.
+				std::vector<std::size_t> view;
+				bool filtered{ false };
+
 				std::size_t max_items{ 10 };				// the number of items display.
 				mutable std::size_t index{ ::nana::npos };	// the result of the selection.
 				mutable bool have_selected{ false };
@@ -96,6 +100,9 @@ namespace nana
 		float_listbox(window, const rectangle&, bool is_ignore_first_mouse_up);
 
 		void set_module(const module_type&, unsigned image_pixels);
+
+		/// Updates the float_listbox when the view of the module is changed.
+		void update_module();
 		void scroll_items(bool upwards);
 		void move_items(bool upwards, bool circle);
 		void renderer(item_renderer*);
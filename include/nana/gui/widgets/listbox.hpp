@@ -28,6 +28,7 @@
 #include <nana/key_type.hpp>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <mutex>
 #include <typeinfo>
 
@@ -1022,6 +1023,29 @@ namespace nana
 					return iter;
 				}
 
+				/// Appends a range of items at the end of this category using the oresolver to generate the texts of each item.
+				/**
+				 * The items are inserted with one lock, they are merged into the sort order of the category if
+				 * the listbox is sorted, and the listbox is updated once instead of once per item.
+				 * @param first The beginning of the range of values which are resolved by oresolver.
+				 * @param last The end of the range.
+				 */
+				template<typename InputIterator>
+				void append_range(InputIterator first, InputIterator last)
+				{
+					std::vector<std::vector<cell>> rows;
+					_m_reserve_rows(rows, first, last, typename std::iterator_traits<InputIterator>::iterator_category{});
+
+					for (; first != last; ++first)
+					{
+						oresolver ores(ess_);
+						ores << *first;
+						rows.emplace_back(ores.move_cells());
+					}
+
+					_m_append(std::move(rows));
+				}
+
 				template<typename T>
 				void append_model(const T& t)
 				{
@@ -1130,7 +1154,19 @@ namespace nana
 
 				void inline_factory(size_type column, pat::cloneable<pat::abstract_factory<inline_notifier_interface>> factory);
 			private:
+				template<typename InputIterator>
+				static void _m_reserve_rows(std::vector<std::vector<cell>>& rows, InputIterator first, InputIterator last, std::forward_iterator_tag)
+				{
+					rows.reserve(static_cast<std::size_t>(std::distance(first, last)));
+				}
+
+				template<typename InputIterator>
+				static void _m_reserve_rows(std::vector<std::vector<cell>>&, InputIterator, InputIterator, std::input_iterator_tag)
+				{
+				}
+
 				void _m_append(std::vector<cell> && cells);
+				void _m_append(std::vector<std::vector<cell>> && rows);
 				void _m_try_append_model(const const_virtual_pointer&);
 				void _m_cat_by_pos() noexcept;
 				void _m_update() noexcept;
@@ -1508,6 +1544,15 @@ the nana::detail::basic_window member pointer scheme
 		void unsort();
 		bool freeze_sort(bool freeze);
 
+		/// Enables/disables sorting the large categories asynchronously.
+		/**
+		 * A large category which is sorted by the default comparer is sorted on worker threads, if the asynchronous
+		 * sort is enabled, the current order is displayed until the new order is ready, so that the GUI thread is not blocked.
+		 * The new order is discarded if the category is changed or another sort is requested before it is ready.
+		 */
+		void async_sort(bool enable);
+		bool async_sort() const;
+
 		index_pairs selected() const;		///<Get the absolute indexs of all the selected items
 
 		void show_header(bool);
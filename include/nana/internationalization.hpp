@@ -27,18 +27,30 @@ namespace nana
 		/// Sets a handler to handle a msgid which hasn't been translated.
 		static void set_missing(std::function<void(const std::string& msgid_utf8)> handler);
 
+		/// Loads a text catalog or a compiled catalog.
+		/**
+		 * A compiled catalog is mapped into memory and it is not parsed, the encoding of a compiled catalog is always UTF-8.
+		 */
 		void load(const std::string& file);
 		void load_utf8(const std::string& file);
 
+		/// Compiles a text catalog into a binary catalog which can be loaded by load() and load_utf8().
+		/**
+		 * The msgids of a compiled catalog are looked up through a perfect hash, and the arguments of the msgstrs are parsed in advance.
+		 * @param file The text catalog.
+		 * @param catalog The path of the binary catalog to be generated.
+		 * @param utf8 Indicates whether the text catalog is encoded in UTF-8.
+		 * @return true if the catalog is generated.
+		 */
+		static bool compile(const std::string& file, const std::string& catalog, bool utf8 = true);
+
 		template<typename ...Args>
 		::std::string get(std::string msgid_utf8, Args&&... args) const
 		{
 			std::vector<std::string> arg_strs;
 			_m_fetch_args(arg_strs, std::forward<Args>(args)...);
 			
-			auto msgstr = _m_get(std::move(msgid_utf8));
-			_m_replace_args(msgstr, &arg_strs);
-			return msgstr;
+			return _m_translate(msgid_utf8, &arg_strs);
 		}
 
 		::std::string get(std::string msgid_utf8) const;
@@ -50,7 +62,7 @@ namespace nana
 			return get(msgid_utf8, std::forward<Args>(args)...);
 		}
 	private:
-		std::string _m_get(std::string&& msgid) const;
+		std::string _m_translate(const std::string& msgid, std::vector<std::string>* arg_strs) const;
 		void _m_replace_args(::std::string& str, std::vector<::std::string> * arg_strs) const;
 
 		void _m_fetch_args(std::vector<std::string>&) const; //Termination of _m_fetch_args
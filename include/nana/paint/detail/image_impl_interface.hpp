@@ -16,6 +16,11 @@ namespace nana{	namespace paint{
 	public:
 		using graph_reference = nana::paint::graphics&;
 		virtual ~image_impl_interface() = 0;	//The destructor is defined in ../image.cpp
+
+		/// Requests the decoder to reduce the image toward the specified size while opening it. It is a hint,
+		/// a decoder which doesn't support scaled decoding ignores it. It should be called before open().
+		virtual void request_size(const nana::size&){}
+
 		virtual bool open(const std::experimental::filesystem::path& file) = 0;
 		virtual bool open(const void* data, std::size_t bytes) = 0; // reads image from memory
 		virtual bool alpha_channel() const = 0;
@@ -12,6 +12,7 @@
 #ifndef NANA_PAINT_DETAIL_PLATFORM_HPP
 #define NANA_PAINT_DETAIL_PLATFORM_HPP
 #include <nana/basic_types.hpp>
+#include <functional>
 
 namespace nana
 {
@@ -29,12 +30,31 @@ namespace detail
 	nana::pixel_color_t fade_color_intermedia(pixel_color_t fgcolor, const unsigned char* fade_table);
 	nana::pixel_color_t fade_color_by_intermedia(pixel_color_t bgcolor, nana::pixel_color_t fgcolor_intermedia, const unsigned char* const fade_table);
 
+	//Calls fn(begin_row, end_row) for the stripes of rows of an image. The stripes are processed in parallel
+	//by a shared pool of threads when the image is large, it returns when all the rows are processed.
+	void parallel_rows(std::size_t rows, std::size_t pixels_per_row, const std::function<void(std::size_t, std::size_t)>& fn);
+
 	//dw color = dw color * fade_rate + bdcolor * (1 - fade_rate)
 	void blend(drawable_type dw, const nana::rectangle& r, pixel_color_t bdcolor, double fade_rate);
 
 	nana::size raw_text_extent_size(drawable_type, const wchar_t*, std::size_t len);
 	nana::size text_extent_size(drawable_type, const wchar_t*, std::size_t len);
 	void draw_string(drawable_type, const nana::point&, const wchar_t *, std::size_t len);
+
+	//UTF-8 versions, the text is passed to the platform without a conversion to wide string where possible.
+	nana::size raw_text_extent_size(drawable_type, const char* text_utf8, std::size_t len);
+	nana::size text_extent_size(drawable_type, const char* text_utf8, std::size_t len);
+	void draw_string(drawable_type, const nana::point&, const char* text_utf8, std::size_t len);
+
+	//The measurement cache of texts shared by all drawables, the results are keyed by the font, the tab length and the text.
+	//text_extent_size() is cached implicitly, the glyph advances are fetched and stored by graphics::glyph_pixels.
+	bool fetch_glyph_pixels(drawable_type, const wchar_t*, std::size_t len, unsigned* pxbuf);
+	bool fetch_glyph_pixels(drawable_type, const char* text_utf8, std::size_t len, unsigned* pxbuf);
+	void store_glyph_pixels(drawable_type, const wchar_t*, std::size_t len, const unsigned* pxbuf, std::size_t count);
+	void store_glyph_pixels(drawable_type, const char* text_utf8, std::size_t len, const unsigned* pxbuf, std::size_t count);
+
+	//Returns the number of hits, misses and entries of the measurement cache.
+	void text_cache_statistics(std::size_t& hits, std::size_t& misses, std::size_t& entries);
 }//end namespace detail
 }//end namespace paint
 }//end namespace nana
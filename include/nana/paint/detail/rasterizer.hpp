@@ -0,0 +1,75 @@
+/*
+ *	Scanline Rasterizer
+ *	Nana C++ Library(http://www.nanapro.org)
+ *	Copyright(C) 2003-2018 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/paint/detail/rasterizer.hpp
+ */
+
+#ifndef NANA_PAINT_DETAIL_RASTERIZER_HPP
+#define NANA_PAINT_DETAIL_RASTERIZER_HPP
+
+#include <nana/basic_types.hpp>
+#include <vector>
+
+namespace nana
+{
+namespace paint
+{
+	class pixel_buffer;
+
+namespace detail
+{
+	/// Renders anti-aliased shapes to a pixel_buffer.
+	/**
+	 * The outlines of shapes are collected as edges, render() accumulates the area covered by the edges for each
+	 * pixel and blends the color by the coverage. The rows are composed by spans, the runs of fully covered pixels
+	 * are filled at once. The overlapped areas of shapes are filled once, by the nonzero rule.
+	 */
+	class rasterizer
+	{
+	public:
+		using point_type = basic_point<double>;
+
+		void clear();
+
+		/// Adds a closed polygon.
+		void polygon(const point_type* points, std::size_t count);
+
+		/// Adds the outline of a polyline with the specified width. The segments have butt ends.
+		void polyline(const point_type* points, std::size_t count, double width, bool closed);
+
+		/// Adds a rectangle with rounded corners, it adds the outline of the rectangle if width is greater than 0.
+		void round_rectangle(const point_type& left_top, const point_type& right_bottom, double radius, double width);
+
+		/// Returns the bounding rectangle of the added edges in pixels.
+		::nana::rectangle bounds() const;
+
+		/// Blends the color to the covered pixels, the alpha channel of color is used for the opacity.
+		/**
+		 * @param origin The position of the pixel buffer in the coordinate of shapes.
+		 */
+		void render(pixel_buffer&, const point& origin, const ::nana::color&);
+	private:
+		void _m_positive_polygon(const point_type* points, std::size_t count);
+		void _m_accumulate(point_type from, point_type to, std::size_t width, std::size_t height);
+		void _m_accumulate_line(const point_type& from, const point_type& to, float dir, std::size_t width, std::size_t height);
+	private:
+		struct edge
+		{
+			point_type from;
+			point_type to;
+		};
+
+		std::vector<edge> edges_;
+		std::vector<float> cover_;	//The accumulation buffer of coverage
+	};
+}//end namespace detail
+}//end namespace paint
+}//end namespace nana
+
+#endif
@@ -14,6 +14,7 @@
 #define NANA_PAINT_GRAPHICS_HPP
 
 #include <memory>
+#include <vector>
 
 #include "../basic_types.hpp"
 #include "../gui/basis.hpp"
@@ -117,6 +118,22 @@ namespace nana
 			::nana::size	glyph_extent_size(const wchar_t*, std::size_t length, std::size_t begin, std::size_t end) const;
 			::nana::size	glyph_extent_size(const ::std::wstring&, std::size_t length, std::size_t begin, std::size_t end) const;
 			bool glyph_pixels(const wchar_t *, std::size_t length, unsigned* pxbuf) const;
+
+			/// Computes the advance of each character of a UTF-8 string.
+			/// @param pxbuf A buffer to receive the pixels, one element for each unicode character, not for each byte.
+			bool glyph_pixels(const char* text_utf8, std::size_t len, unsigned* pxbuf) const;
+
+			/// Statistics of the text measurement cache.
+			struct text_cache_stats
+			{
+				std::size_t hits;
+				std::size_t misses;
+				std::size_t entries;
+			};
+
+			/// Returns the statistics of the cache of text_extent_size() and glyph_pixels() results, which is shared by all graphics objects.
+			static text_cache_stats text_cache();
+
 			::nana::size	bidi_extent_size(const std::wstring&) const;
 			::nana::size	bidi_extent_size(const std::string&) const;
 
@@ -169,6 +186,7 @@ namespace nana
 
 			void string(const point&, const std::string& text_utf8);
 			void string(const point&, const std::string& text_utf8, const color&);
+			void string(const point&, const char* text_utf8, std::size_t len);
 
 			void string(point, const wchar_t*, std::size_t len);
 			void string(const point&, const wchar_t*);
@@ -189,6 +207,15 @@ namespace nana
 
 			void gradual_rectangle(const ::nana::rectangle&, const color& from, const color& to, bool vertical);
 			void round_rectangle(const ::nana::rectangle&, unsigned radius_x, unsigned radius_y, const color&, bool solid, const color& color_if_solid);
+
+			/// Anti-aliased drawing, the alpha channel of color is used for the opacity.
+			/**
+			 * The shapes are rasterized to the covered part of graphics at once, a chart should be drawn by a polyline
+			 * rather than by its segments.
+			 */
+			void polyline(const std::vector<basic_point<double>>&, double width, const color&, bool closed = false);
+			void polygon(const std::vector<basic_point<double>>&, const color&);
+			void round_rectangle(const ::nana::rectangle&, double radius, const color&, bool solid);
 		private:
 			struct implementation;
 			std::unique_ptr<implementation> impl_;
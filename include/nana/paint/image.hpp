@@ -15,6 +15,7 @@
 #define NANA_PAINT_IMAGE_HPP
 
 #include "graphics.hpp"
+#include <functional>
 
 namespace nana
 {
@@ -39,6 +40,25 @@ namespace paint
 		image& operator=(image&&);
 		bool open(const ::std::string& file);
 		bool open(const ::std::wstring& file);
+
+		/// Opens a picture file and allows the decoder to reduce the picture toward the requested size, e.g. for thumbnails.
+		/**
+		 * JPEG and PNG pictures are decoded at a reduced scale which is not smaller than the requested size, other
+		 * formats are decoded at full size. The picture may be stretched to the exact size when it is drawn.
+		 */
+		bool open(const ::std::string& file, const nana::size& request);
+		bool open(const ::std::wstring& file, const nana::size& request);
+
+		/// Opens a picture file on a worker thread and returns immediately.
+		/**
+		 * The image is empty until the decoding is finished. The ready function is invoked on the
+		 * worker thread with the result of the decoding, it may be used to refresh the window which shows the image.
+		 * The decoded pixels are shared with other images opened from the same unchanged file.
+		 */
+		void open_async(const ::std::string& file, std::function<void(bool)> ready = {});
+		void open_async(const ::std::wstring& file, std::function<void(bool)> ready = {});
+		void open_async(const ::std::string& file, const nana::size& request, std::function<void(bool)> ready = {});	///< Opens a picture file on a worker thread, reducing it toward the requested size.
+		void open_async(const ::std::wstring& file, const nana::size& request, std::function<void(bool)> ready = {});
 		
 		/// Opens an icon from a specified buffer
 		bool open(const void* data, std::size_t bytes);
@@ -15,6 +15,7 @@
 
 #include <nana/gui/basis.hpp>
 #include <memory>
+#include <vector>
 
 namespace nana{	namespace paint
 {
@@ -75,7 +76,13 @@ namespace nana{	namespace paint
 		void blend(const nana::rectangle& s_r, drawable_type dw_dst, const nana::point& d_pos, double fade_rate) const;
 		void blur(const nana::rectangle& r, std::size_t radius);
 
-		pixel_buffer rotate(double angle, const color& extend_color);
+		/// Anti-aliased drawing, the alpha channel of color is used for the opacity.
+		void polyline(const std::vector<basic_point<double>>&, double width, const ::nana::color&, bool closed = false);
+		void polygon(const std::vector<basic_point<double>>&, const ::nana::color&);
+		void round_rectangle(const ::nana::rectangle&, double radius, const ::nana::color&, bool solid);
+
+		/// Rotates counterclockwise by the angle in degrees, bilinear interpolation is ignored for quarter turns.
+		pixel_buffer rotate(double angle, const color& extend_color, bool bilinear = false);
 	private:
 		std::shared_ptr<pixel_buffer_storage> storage_;
 	};
@@ -50,6 +50,10 @@ namespace nana
 		};
 
 		std::vector<entity> reorder(const char_type*, std::size_t len);
+
+		/// Returns true if the text contains an RTL or AN character, or an explicit embedding/override.
+		/// Otherwise, the text is displayed in logical order.
+		static bool requires_reordering(const char_type*, std::size_t len);
 	private:
 		static unsigned _m_paragraph_level(const char_type * begin, const char_type * end);
 
@@ -69,6 +73,7 @@ namespace nana
 		std::vector<entity>	levels_;
 	};
 
+	/// Reorders a text, the results of recently reordered texts are cached.
 	std::vector<unicode_bidi::entity> unicode_reorder(const wchar_t* text, std::size_t length);
 
 }
@@ -5,6 +5,9 @@
 
 #include <nana/system/platform.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 #if defined(NANA_POSIX)
 	#include <pthread.h>
 	#include <unistd.h>
@@ -55,7 +58,8 @@ namespace nana{namespace audio
 #elif defined(NANA_POSIX)
 				handle_(-1),
 #endif
-				buf_prep_(nullptr)
+				buf_prep_(nullptr),
+				underruns_(0)
 			{}
 
 			audio_device::~audio_device()
@@ -72,8 +76,9 @@ namespace nana{namespace audio
 #endif
 			}
 
-			bool audio_device::open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample)
+			bool audio_device::open(std::size_t channels, std::size_t rate, std::size_t bits_per_sample, const player::parameters& params)
 			{
+				underruns_ = 0;
 #if defined(NANA_WINDOWS)
 				close();
 
@@ -93,7 +98,8 @@ namespace nana{namespace audio
                 // assumes ALSA sub-system
 				if(nullptr == handle_)
 				{
-					if(::snd_pcm_open(&handle_, "plughw:0,0", SND_PCM_STREAM_PLAYBACK, 0) < 0)
+					const char * name = (params.device.empty() ? "plughw:0,0" : params.device.c_str());
+					if(::snd_pcm_open(&handle_, name, SND_PCM_STREAM_PLAYBACK, 0) < 0)
 						return false;
 				}
 
@@ -104,24 +110,25 @@ namespace nana{namespace audio
 					bytes_per_sample_ = (bits_per_sample >> 3);
 					bytes_per_frame_ = bytes_per_sample_ * channels;
 
-					snd_pcm_hw_params_t * params;
-					if(snd_pcm_hw_params_malloc(&params) < 0)
+					snd_pcm_hw_params_t * hwparams;
+					if(snd_pcm_hw_params_malloc(&hwparams) < 0)
 					{
 						close();
 						return false;
 					}
 
-					if(::snd_pcm_hw_params_any(handle_, params) < 0)
+					if(::snd_pcm_hw_params_any(handle_, hwparams) < 0)
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
+						::snd_pcm_hw_params_free(hwparams);
 						return false;
 					}
 
-					if(::snd_pcm_hw_params_set_access(handle_, params, SND_PCM_ACCESS_RW_INTERLEAVED) < 0)
+					//The PCM data is copied into the ring buffer of device directly.
+					if(::snd_pcm_hw_params_set_access(handle_, hwparams, SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0)
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
+						::snd_pcm_hw_params_free(hwparams);
 						return false;
 					}
 
@@ -136,36 +143,74 @@ namespace nana{namespace audio
 						format = SND_PCM_FORMAT_S32_LE;	break;
 					}
 
-					if(::snd_pcm_hw_params_set_format(handle_, params, format) < 0)
+					if(::snd_pcm_hw_params_set_format(handle_, hwparams, format) < 0)
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
+						::snd_pcm_hw_params_free(hwparams);
 						return false;
 					}
 
 					unsigned tmp = rate;
-					if(::snd_pcm_hw_params_set_rate_near(handle_, params, &tmp, 0) < 0)
+					if(::snd_pcm_hw_params_set_rate_near(handle_, hwparams, &tmp, 0) < 0)
+					{
+						close();
+						::snd_pcm_hw_params_free(hwparams);
+						return false;
+					}
+
+					if(::snd_pcm_hw_params_set_channels(handle_, hwparams, channels) < 0)
+					{
+						close();
+						::snd_pcm_hw_params_free(hwparams);
+						return false;
+					}
+
+					unsigned period_time = static_cast<unsigned>(params.period_ms * 1000);
+					if(::snd_pcm_hw_params_set_period_time_near(handle_, hwparams, &period_time, 0) < 0)
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
+						::snd_pcm_hw_params_free(hwparams);
 						return false;
 					}
 
-					if(::snd_pcm_hw_params_set_channels(handle_, params, channels) < 0)
+					unsigned buffer_time = static_cast<unsigned>(period_time * params.periods);
+					if(::snd_pcm_hw_params_set_buffer_time_near(handle_, hwparams, &buffer_time, 0) < 0)
+					{
+						close();
+						::snd_pcm_hw_params_free(hwparams);
+						return false;
+					}
+
+					if(::snd_pcm_hw_params(handle_, hwparams) < 0)
+					{
+						close();
+						::snd_pcm_hw_params_free(hwparams);
+						return false;
+					}
+
+					::snd_pcm_hw_params_get_period_size(hwparams, &period_size_, 0);
+					::snd_pcm_hw_params_free(hwparams);
+
+					//Starts the playback when a period is transferred, rather than the whole buffer is filled,
+					//and wakes the writer up when a period is available.
+					snd_pcm_sw_params_t * swparams;
+					if(::snd_pcm_sw_params_malloc(&swparams) < 0)
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
 						return false;
 					}
 
-					if(::snd_pcm_hw_params(handle_, params) < 0)
+					if((::snd_pcm_sw_params_current(handle_, swparams) < 0) ||
+						(::snd_pcm_sw_params_set_start_threshold(handle_, swparams, period_size_) < 0) ||
+						(::snd_pcm_sw_params_set_avail_min(handle_, swparams, period_size_) < 0) ||
+						(::snd_pcm_sw_params(handle_, swparams) < 0))
 					{
 						close();
-						::snd_pcm_hw_params_free(params);
+						::snd_pcm_sw_params_free(swparams);
 						return false;
 					}
 
-					::snd_pcm_hw_params_free(params);
+					::snd_pcm_sw_params_free(swparams);
 					::snd_pcm_prepare(handle_);
 					return true;
 				}
@@ -238,6 +283,11 @@ namespace nana{namespace audio
 			void audio_device::prepare(buffer_preparation & buf_prep)
 			{
 				buf_prep_ = & buf_prep;
+#if defined(NANA_LINUX)
+				//The device is stopped by the drain of last playback.
+				if(::snd_pcm_state(handle_) != SND_PCM_STATE_PREPARED)
+					::snd_pcm_prepare(handle_);
+#endif
 			}
 
 			void audio_device::write(buffer_preparation::meta * m)
@@ -251,18 +301,56 @@ namespace nana{namespace audio
 				wave_native_if.out_prepare(handle_, m, sizeof(WAVEHDR));
 				wave_native_if.out_write(handle_, m, sizeof(WAVEHDR));
 #elif defined(NANA_LINUX)
-				std::size_t frames = m->bufsize / bytes_per_frame_;
-				std::size_t buffered = 0; //in bytes
-				while(frames > 0)
+				snd_pcm_uframes_t remain = m->bufsize / bytes_per_frame_;
+				const char * src = m->buf;
+				while(remain > 0)
 				{
-					int err = ::snd_pcm_writei(handle_, m->buf + buffered, frames);
-					if(err > 0)
+					snd_pcm_sframes_t avail = ::snd_pcm_avail_update(handle_);
+					if(avail < 0)
+					{
+						if(_m_recover(static_cast<int>(avail)))
+							continue;
+						break;
+					}
+
+					if(static_cast<snd_pcm_uframes_t>(avail) < (std::min)(remain, period_size_))
+					{
+						//The buffer is full. The device doesn't start if the threshold is
+						//not reached, e.g. the buffer is smaller than a period.
+						if(::snd_pcm_state(handle_) == SND_PCM_STATE_PREPARED)
+							::snd_pcm_start(handle_);
+
+						int err = ::snd_pcm_wait(handle_, 1000);
+						if((err < 0) && !_m_recover(err))
+							break;
+						continue;
+					}
+
+					const snd_pcm_channel_area_t * areas;
+					snd_pcm_uframes_t offset;
+					snd_pcm_uframes_t frames = remain;
+					int err = ::snd_pcm_mmap_begin(handle_, &areas, &offset, &frames);
+					if(err < 0)
+					{
+						if(_m_recover(err))
+							continue;
+						break;
+					}
+
+					//The access is interleaved, the frames are contiguous in the first area.
+					char * dst = reinterpret_cast<char*>(areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+					std::memcpy(dst, src, frames * bytes_per_frame_);
+
+					snd_pcm_sframes_t committed = ::snd_pcm_mmap_commit(handle_, offset, frames);
+					if((committed < 0) || (static_cast<snd_pcm_uframes_t>(committed) != frames))
 					{
-						frames -= err;
-						buffered += err * bytes_per_frame_;
+						if(_m_recover(committed < 0 ? static_cast<int>(committed) : -EPIPE))
+							continue;
+						break;
 					}
-					else if(-EPIPE == err)
-						::snd_pcm_prepare(handle_);
+
+					src += frames * bytes_per_frame_;
+					remain -= frames;
 				}
 				buf_prep_->revert(m);
 #elif defined(NANA_POSIX)
@@ -279,11 +367,19 @@ namespace nana{namespace audio
 				while(buf_prep_->data_finished() == false)
 					nana::system::sleep(200);
 #elif defined(NANA_LINUX)
-				while(::snd_pcm_state(handle_) == SND_PCM_STATE_RUNNING)
-					nana::system::sleep(200);
+				//A short sound may not reach the start threshold.
+				if(::snd_pcm_state(handle_) == SND_PCM_STATE_PREPARED)
+					::snd_pcm_start(handle_);
+
+				::snd_pcm_drain(handle_);
 #endif
 			}
 
+			std::size_t audio_device::underruns() const
+			{
+				return underruns_;
+			}
+
 #if defined(NANA_WINDOWS)
 			void __stdcall audio_device::_m_dev_callback(HWAVEOUT handle, UINT msg, audio_device * self, DWORD_PTR, DWORD_PTR)
 			{
@@ -299,6 +395,15 @@ namespace nana{namespace audio
 					self->buf_prep_->revert(m);
 				}
 			}
+#elif defined(NANA_LINUX)
+			bool audio_device::_m_recover(int err)
+			{
+				if(-EPIPE == err)
+					++underruns_;
+
+				//Recovers the device from an underrun or a suspend.
+				return (::snd_pcm_recover(handle_, err, 1) >= 0);
+			}
 #endif
 		//end class audio_device
 	}//end namespace detail
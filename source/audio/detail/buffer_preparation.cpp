@@ -9,18 +9,22 @@ namespace nana{	namespace audio
 	namespace detail
 	{
 		//class buffer_preparation
-			buffer_preparation::buffer_preparation(audio_stream& as, std::size_t seconds)
-				: running_(true), wait_for_buffer_(false), as_(as)
+			buffer_preparation::buffer_preparation(audio_stream& as, std::size_t block_bytes, std::size_t blocks)
+				: running_(true), drained_(nullptr), prepared_(blocks), buffer_(blocks), as_(as)
 			{
 				//Allocate the space
-				buffer_.reserve(seconds);
-				prepared_.reserve(seconds);
+				blocks_.reserve(blocks);
 
 				const wave_spec::format_chunck & ck = as.format();
-				block_size_ = ck.nAvgBytesPerSec;
-				for(std::size_t i = 0; i < seconds; ++i)
+
+				//A block is made up of whole frames.
+				block_size_ = block_bytes - block_bytes % (ck.nBlockAlign ? ck.nBlockAlign : 1);
+				if(0 == block_size_)
+					block_size_ = (ck.nBlockAlign ? ck.nBlockAlign : 1);
+
+				for(std::size_t i = 0; i < blocks; ++i)
 				{
-					char * rawbuf = new char[sizeof(meta) + ck.nAvgBytesPerSec];
+					char * rawbuf = new char[sizeof(meta) + block_size_];
 					meta * m = reinterpret_cast<meta*>(rawbuf);
 #if defined(NANA_WINDOWS)
 					memset(m, 0, sizeof(meta));
@@ -28,10 +32,11 @@ namespace nana{	namespace audio
 					m->lpData = rawbuf + sizeof(meta);
 #elif defined(__FreeBSD__)
 #elif defined(NANA_LINUX)
-					m->bufsize = ck.nAvgBytesPerSec;
+					m->bufsize = block_size_;
 					m->buf = rawbuf + sizeof(meta);
 #endif
-					prepared_.emplace_back(m);
+					blocks_.emplace_back(m);
+					prepared_.push(m);
 				}
 
 				thr_ = std::thread{[this](){this->_m_prepare_routine();}};
@@ -41,108 +46,88 @@ namespace nana{	namespace audio
 			{
 				running_ = false;
 
-				cond_prepared_.notify_one();
-				cond_buffer_.notify_one();
+				wait_prepared_.notify();
+				wait_buffer_.notify();
 
 				if(thr_.joinable())
 					thr_.join();
 
-				for(auto metaptr : prepared_)
+				for(auto metaptr : blocks_)
 					delete [] reinterpret_cast<char*>(metaptr);
 			}
 
 			buffer_preparation::meta * buffer_preparation::read()
 			{
-				std::unique_lock<decltype(token_buffer_)> lock(token_buffer_);
-
-				//Wait for the buffer
-				if(0 == buffer_.size())
+				meta * m = nullptr;
+				while(!buffer_.pop(m))
 				{
 					//Before waiting, checks the thread whether it is finished
 					//it indicates the preparation is finished.
 					if(false == running_)
-						return nullptr;
-
-					wait_for_buffer_ = true;
-					cond_buffer_.wait(lock);
+					{
+						//Takes the last block which is pushed before the thread finished.
+						return (buffer_.pop(m) ? m : nullptr);
+					}
 
-					//NO more buffers
-					if(0 == buffer_.size())
-						return nullptr;
+					wait_buffer_.wait([this]{
+						return (!buffer_.empty() || !running_);
+					});
 				}
-				meta * m = buffer_.front();
-				buffer_.erase(buffer_.begin());
 				return m;
 			}
 
 			//Revert the meta that returned by read()
 			void buffer_preparation::revert(meta * m)
 			{
-				std::lock_guard<decltype(token_prepared_)> lock(token_prepared_);
-				auto const if_signal = prepared_.empty();
-				prepared_.emplace_back(m);
-				if(if_signal)
-					cond_prepared_.notify_one();
+				prepared_.push(m);
+				wait_prepared_.notify();
 			}
 
 			bool buffer_preparation::data_finished() const
 			{
-				std::lock_guard<decltype(token_prepared_)> lock(token_prepared_);
-				return ((prepared_.size() == prepared_.capacity()) && (running_ == false));
+				if(running_)
+					return false;
+
+				return (prepared_.size() + (drained_ ? 1 : 0) == blocks_.size());
 			}
 
 			void buffer_preparation::_m_prepare_routine()
 			{
-				const std::size_t fixed_bufsize = 1024;
-				char buf[fixed_bufsize];
 				const std::size_t block_size = block_size_;
 
 				while(running_)
 				{
-					meta * m = 0;
+					meta * m = nullptr;
+					if(!prepared_.pop(m))
 					{
-						std::unique_lock<decltype(token_prepared_)> lock(token_prepared_);
-
-						if(prepared_.size() == 0)
-						{
-							cond_prepared_.wait(lock);
-
-							if(false == running_)
-								return;
-						}
-						m = prepared_.back();
-						prepared_.pop_back();
+						wait_prepared_.wait([this]{
+							return (!prepared_.empty() || !running_);
+						});
+						continue;
 					}
 
+#if defined(NANA_WINDOWS)
+					char * const buf = m->lpData;
+#elif defined(NANA_POSIX)
+					char * const buf = m->buf;
+#endif
+					//Reads the PCM data into the block directly.
 					std::size_t buffered = 0;
 					while(buffered != block_size)
 					{
-						std::size_t want_bytes = block_size - buffered;
-						if(want_bytes > fixed_bufsize)	want_bytes = fixed_bufsize;
-
-						std::size_t read_bytes = as_.read(buf, want_bytes);
+						std::size_t read_bytes = as_.read(buf + buffered, block_size - buffered);
 						if(read_bytes)
-						{
-#if defined(NANA_WINDOWS)
-							memcpy(m->lpData + buffered, buf, read_bytes);
-#elif defined(__FreeBSD__)
-#elif defined(NANA_LINUX)
-							memcpy(m->buf + buffered, buf, read_bytes);
-#endif
 							buffered += read_bytes;
-						}
 						else if(0 == as_.data_length())
-						{
-							if(buffered == 0)
-							{
-								//PCM data is drained
-								std::lock_guard<decltype(token_buffer_)> lock(token_buffer_);
-								cond_buffer_.notify_one();
-								running_ = false;
-								return;
-							}
 							break;
-						}
+					}
+
+					if(0 == buffered)
+					{
+						//PCM data is drained. The block is kept aside, because only
+						//revert() is allowed to push the prepared ring.
+						drained_ = m;
+						break;
 					}
 #if defined(NANA_WINDOWS)
 					m->dwBufferLength = static_cast<unsigned long>(buffered);
@@ -150,16 +135,15 @@ namespace nana{	namespace audio
 #elif defined(NANA_LINUX)
 					m->bufsize = buffered;
 #endif
-					std::lock_guard<decltype(token_buffer_)> lock(token_buffer_);
-					buffer_.emplace_back(m);
-					if(wait_for_buffer_)
-					{
-						cond_buffer_.notify_one();
-						wait_for_buffer_ = false;
-					}
+					buffer_.push(m);
+					wait_buffer_.notify();
+
 					if(0 == as_.data_length())
-						running_ = false;
+						break;
 				}
+
+				running_ = false;
+				wait_buffer_.notify();
 			}
 		//end class buffer_preparation
 	}//end namespace detail
@@ -10,6 +10,8 @@
 #include <nana/audio/detail/buffer_preparation.hpp>
 #include <nana/system/platform.hpp>
 
+#include <algorithm>
+
 namespace nana{	namespace audio
 {
 	//class player
@@ -17,6 +19,7 @@ namespace nana{	namespace audio
 		{
 			detail::audio_stream	stream;
 			detail::audio_device	dev;
+			parameters				params;
 		};
 
 		player::player()
@@ -36,10 +39,22 @@ namespace nana{	namespace audio
 
 		bool player::open(const std::string& file)
 		{
+			return open(file, parameters{});
+		}
+
+		bool player::open(const std::string& file, const parameters& params)
+		{
+			impl_->params = params;
+			if(0 == impl_->params.period_ms)
+				impl_->params.period_ms = 1;
+
+			if(impl_->params.periods < 2)
+				impl_->params.periods = 2;
+
 			if(impl_->stream.open(file))
 			{
 				const detail::wave_spec::format_chunck & ck = impl_->stream.format();
-				return impl_->dev.open(ck.nChannels, ck.nSamplePerSec, ck.wBitsPerSample);
+				return impl_->dev.open(ck.nChannels, ck.nSamplePerSec, ck.wBitsPerSample, impl_->params);
 			}
 			return false;
 		}
@@ -50,9 +65,14 @@ namespace nana{	namespace audio
 
 			//Locate the PCM
 			impl_->stream.locate();
-			const std::size_t seconds = 5;
 
-			detail::buffer_preparation buffer(impl_->stream, seconds);
+			//The PCM data is prepared in periods, so that the output starts as soon as the first
+			//period is read. A quarter second is decoded ahead to absorb the stalls of reading.
+			const detail::wave_spec::format_chunck & ck = impl_->stream.format();
+			const std::size_t period_bytes = ck.nAvgBytesPerSec * impl_->params.period_ms / 1000;
+			const std::size_t blocks = (std::max)(impl_->params.periods * 2, 250 / impl_->params.period_ms);
+
+			detail::buffer_preparation buffer(impl_->stream, period_bytes, blocks);
 			impl_->dev.prepare(buffer);
 			detail::buffer_preparation::meta * meta;
 			while((meta = buffer.read()))
@@ -67,6 +87,11 @@ namespace nana{	namespace audio
 			impl_->dev.close();
 			impl_->stream.close();
 		}
+
+		std::size_t player::underruns() const
+		{
+			return impl_->dev.underruns();
+		}
 }//end namespace audio
 }//end namespace nana
 
@@ -33,6 +33,11 @@
 	#include <windows.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define NANA_CHARSET_SSE2
+	#include <emmintrin.h>
+#endif
+
 namespace nana
 {
 	namespace utf
@@ -214,6 +219,344 @@ namespace nana
 
 			return 0;
 		}
+
+		//Implementation of transcode
+		namespace transcoding
+		{
+			//The unicode transformation format is selected by size of code unit.
+			//1 = UTF-8, 2 = UTF-16, 4 = UTF-32
+
+			//Returns the number of leading ASCII code units
+			inline std::size_t ascii_run(const unsigned char* p, std::size_t len)
+			{
+				std::size_t i = 0;
+#if defined(NANA_CHARSET_SSE2)
+				for (; i + 16 <= len; i += 16)
+				{
+					if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))))
+						break;
+				}
+#endif
+				while ((i < len) && (p[i] < 0x80))
+					++i;
+				return i;
+			}
+
+			template<typename CharT>
+			std::size_t ascii_run(const CharT* p, std::size_t len)
+			{
+				std::size_t i = 0;
+#if defined(NANA_CHARSET_SSE2)
+				if (2 == sizeof(CharT))
+				{
+					const auto high_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+					for (; i + 8 <= len; i += 8)
+					{
+						auto v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), high_bits);
+						if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF)
+							break;
+					}
+				}
+				else
+				{
+					const auto high_bits = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+					for (; i + 4 <= len; i += 4)
+					{
+						auto v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), high_bits);
+						if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF)
+							break;
+					}
+				}
+#endif
+				while ((i < len) && (static_cast<unsigned long>(p[i]) < 0x80))
+					++i;
+				return i;
+			}
+
+			//Copies ASCII code units by widening or narrowing
+			template<typename InChar, typename OutChar>
+			void copy_ascii(const InChar* in, std::size_t len, OutChar* out)
+			{
+				std::size_t i = 0;
+#if defined(NANA_CHARSET_SSE2)
+				if ((1 == sizeof(InChar)) && (1 != sizeof(OutChar)))
+				{
+					const auto zero = _mm_setzero_si128();
+					for (; i + 16 <= len; i += 16)
+					{
+						auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						auto lo = _mm_unpacklo_epi8(v, zero);
+						auto hi = _mm_unpackhi_epi8(v, zero);
+						auto dst = reinterpret_cast<__m128i*>(out + i);
+						if (2 == sizeof(OutChar))
+						{
+							_mm_storeu_si128(dst, lo);
+							_mm_storeu_si128(dst + 1, hi);
+						}
+						else
+						{
+							_mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+							_mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+							_mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+							_mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+						}
+					}
+				}
+				else if ((1 != sizeof(InChar)) && (1 == sizeof(OutChar)))
+				{
+					auto src = reinterpret_cast<const __m128i*>(in);
+					for (; i + 16 <= len; i += 16)
+					{
+						__m128i lo, hi;
+						if (2 == sizeof(InChar))
+						{
+							lo = _mm_loadu_si128(src + i / 8);
+							hi = _mm_loadu_si128(src + i / 8 + 1);
+						}
+						else
+						{
+							lo = _mm_packs_epi32(_mm_loadu_si128(src + i / 4), _mm_loadu_si128(src + i / 4 + 1));
+							hi = _mm_packs_epi32(_mm_loadu_si128(src + i / 4 + 2), _mm_loadu_si128(src + i / 4 + 3));
+						}
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+					}
+				}
+#endif
+				for (; i < len; ++i)
+					out[i] = static_cast<OutChar>(in[i]);
+			}
+
+			//Decodes a code point, returns the number of code units, or 0 if the sequence is ill-formed.
+			inline std::size_t decode(const unsigned char* p, std::size_t len, char32_t& code)
+			{
+				const unsigned ch = p[0];
+				if (ch < 0x80)
+				{
+					code = ch;
+					return 1;
+				}
+
+				std::size_t bytes;
+				char32_t min_code;
+				if ((ch & 0xE0) == 0xC0)
+				{
+					bytes = 2;
+					min_code = 0x80;
+					code = ch & 0x1F;
+				}
+				else if ((ch & 0xF0) == 0xE0)
+				{
+					bytes = 3;
+					min_code = 0x800;
+					code = ch & 0xF;
+				}
+				else if ((ch & 0xF8) == 0xF0)
+				{
+					bytes = 4;
+					min_code = 0x10000;
+					code = ch & 0x7;
+				}
+				else
+					return 0;
+
+				if (len < bytes)
+					return 0;
+
+				for (std::size_t i = 1; i < bytes; ++i)
+				{
+					if ((p[i] & 0xC0) != 0x80)
+						return 0;
+					code = (code << 6) | (p[i] & 0x3F);
+				}
+
+				//Rejects overlong forms, surrogates and the code points beyond U+10FFFF
+				if ((code < min_code) || (code > 0x10FFFF) || ((code & 0xFFFFF800) == 0xD800))
+					return 0;
+
+				return bytes;
+			}
+
+			template<typename CharT>
+			std::size_t decode(const CharT* p, std::size_t len, char32_t& code)
+			{
+				code = static_cast<char32_t>(p[0]);
+				if (2 == sizeof(CharT))
+				{
+					code &= 0xFFFF;
+					if ((code & 0xF800) != 0xD800)
+						return 1;
+
+					//A high surrogate must be followed by a low surrogate
+					if ((code > 0xDBFF) || (len < 2) || ((static_cast<char32_t>(p[1]) & 0xFC00) != 0xDC00))
+						return 0;
+
+					code = 0x10000 + (((code & 0x3FF) << 10) | (static_cast<char32_t>(p[1]) & 0x3FF));
+					return 2;
+				}
+
+				if ((code > 0x10FFFF) || ((code & 0xFFFFF800) == 0xD800))
+					return 0;
+				return 1;
+			}
+
+			inline std::size_t encoded_units(char32_t code, std::size_t unit_bytes)
+			{
+				if (1 == unit_bytes)
+					return (code < 0x80 ? 1 : (code < 0x800 ? 2 : (code < 0x10000 ? 3 : 4)));
+				else if (2 == unit_bytes)
+					return (code < 0x10000 ? 1 : 2);
+				return 1;
+			}
+
+			template<typename CharT>
+			void encode(char32_t code, CharT* out)
+			{
+				if (1 == sizeof(CharT))
+				{
+					if (code < 0x80)
+						out[0] = static_cast<CharT>(code);
+					else if (code < 0x800)
+					{
+						out[0] = static_cast<CharT>(0xC0 | (code >> 6));
+						out[1] = static_cast<CharT>(0x80 | (code & 0x3F));
+					}
+					else if (code < 0x10000)
+					{
+						out[0] = static_cast<CharT>(0xE0 | (code >> 12));
+						out[1] = static_cast<CharT>(0x80 | ((code >> 6) & 0x3F));
+						out[2] = static_cast<CharT>(0x80 | (code & 0x3F));
+					}
+					else
+					{
+						out[0] = static_cast<CharT>(0xF0 | (code >> 18));
+						out[1] = static_cast<CharT>(0x80 | ((code >> 12) & 0x3F));
+						out[2] = static_cast<CharT>(0x80 | ((code >> 6) & 0x3F));
+						out[3] = static_cast<CharT>(0x80 | (code & 0x3F));
+					}
+				}
+				else if ((2 == sizeof(CharT)) && (code >= 0x10000))
+				{
+					out[0] = static_cast<CharT>(0xD800 | ((code - 0x10000) >> 10));
+					out[1] = static_cast<CharT>(0xDC00 | ((code - 0x10000) & 0x3FF));
+				}
+				else
+					out[0] = static_cast<CharT>(code);
+			}
+
+			template<typename InChar, typename OutChar>
+			transcode_result transcode(const InChar* in, std::size_t len, OutChar* out, std::size_t out_len)
+			{
+				transcode_result result{ 0, 0, true };
+
+				std::size_t & i = result.read;
+				std::size_t & n = result.written;
+				while (i < len)
+				{
+					//ASCII fast path
+					auto run = ascii_run(in + i, len - i);
+					if (run)
+					{
+						if (out)
+						{
+							if (run > out_len - n)
+								run = out_len - n;
+
+							copy_ascii(in + i, run, out + n);
+						}
+						i += run;
+						n += run;
+
+						if (i == len || (out && (n == out_len)))
+							break;
+					}
+
+					char32_t code;
+					auto units = decode(in + i, len - i, code);
+					if (0 == units)
+					{
+						result.valid = false;
+						break;
+					}
+
+					auto out_units = encoded_units(code, sizeof(OutChar));
+					if (out)
+					{
+						if (out_units > out_len - n)
+							break;
+						encode(code, out + n);
+					}
+					i += units;
+					n += out_units;
+				}
+				return result;
+			}
+
+			template<typename InChar, typename OutString>
+			bool transcode(const InChar* in, std::size_t len, OutString& out)
+			{
+				using out_char = typename OutString::value_type;
+
+				//Gets the exact size of output
+				auto result = transcode(in, len, static_cast<out_char*>(nullptr), 0);
+				if (!result.valid)
+					return false;
+
+				out.resize(result.written);
+				if (result.written)
+					transcode(in, len, &out[0], out.size());
+				return true;
+			}
+		}//end namespace transcoding
+
+		transcode_result transcode(const char* in, std::size_t len, char16_t* out, std::size_t out_len)
+		{
+			return transcoding::transcode(reinterpret_cast<const unsigned char*>(in), len, out, out_len);
+		}
+
+		transcode_result transcode(const char* in, std::size_t len, char32_t* out, std::size_t out_len)
+		{
+			return transcoding::transcode(reinterpret_cast<const unsigned char*>(in), len, out, out_len);
+		}
+
+		transcode_result transcode(const char* in, std::size_t len, wchar_t* out, std::size_t out_len)
+		{
+			return transcoding::transcode(reinterpret_cast<const unsigned char*>(in), len, out, out_len);
+		}
+
+		transcode_result transcode(const char16_t* in, std::size_t len, char* out, std::size_t out_len)
+		{
+			return transcoding::transcode(in, len, out, out_len);
+		}
+
+		transcode_result transcode(const char16_t* in, std::size_t len, char32_t* out, std::size_t out_len)
+		{
+			return transcoding::transcode(in, len, out, out_len);
+		}
+
+		transcode_result transcode(const char32_t* in, std::size_t len, char* out, std::size_t out_len)
+		{
+			return transcoding::transcode(in, len, out, out_len);
+		}
+
+		transcode_result transcode(const char32_t* in, std::size_t len, char16_t* out, std::size_t out_len)
+		{
+			return transcoding::transcode(in, len, out, out_len);
+		}
+
+		transcode_result transcode(const wchar_t* in, std::size_t len, char* out, std::size_t out_len)
+		{
+			return transcoding::transcode(in, len, out, out_len);
+		}
+
+		bool transcode(const std::string& utf8, std::wstring& out)
+		{
+			return transcoding::transcode(reinterpret_cast<const unsigned char*>(utf8.data()), utf8.size(), out);
+		}
+
+		bool transcode(const std::wstring& in, std::string& utf8)
+		{
+			return transcoding::transcode(in.data(), in.size(), utf8);
+		}
 	}
 
 	namespace detail
@@ -503,7 +846,9 @@ namespace nana
 								);
 						case unicode::utf32:
 							{
-								std::u32string u32str = std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>().from_bytes(data_);
+								std::u32string u32str;
+								if (!utf::transcoding::transcode(reinterpret_cast<const unsigned char*>(data_.data()), data_.size(), u32str))
+									u32str = std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>().from_bytes(data_);
 								return std::string(reinterpret_cast<const char*>(u32str.c_str()), u32str.size() * sizeof(char32_t));
 							}
 						default:
@@ -530,6 +875,11 @@ namespace nana
 						switch(encoding)
 						{
 						case unicode::utf8:
+							{
+								std::string utf8str;
+								if (utf::transcoding::transcode(reinterpret_cast<const char32_t*>(data_.c_str()), data_.size() / sizeof(char32_t), utf8str))
+									return utf8str;
+							}
 							return std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>().to_bytes(
 									std::u32string(reinterpret_cast<const char32_t*>(data_.c_str()), data_.size() / sizeof(char32_t))
 								);
@@ -578,6 +928,11 @@ namespace nana
 					switch(utf_x_)
 					{
 					case unicode::utf8:
+						{
+							std::wstring wcstr;
+							if (utf::transcode(data_, wcstr))
+								return wcstr;
+						}
 						return std::wstring_convert<std::codecvt_utf8<wchar_t, 0x10FFFF, std::little_endian>>().from_bytes(data_);
 					case unicode::utf16:
 						return std::wstring_convert<std::codecvt_utf16<wchar_t, 0x10FFFF, std::little_endian>>().from_bytes(data_);
@@ -643,6 +998,11 @@ namespace nana
 				switch(encoding)
 				{
 				case unicode::utf8:
+					{
+						std::string utf8str;
+						if (utf::transcode(data_, utf8str))
+							return utf8str;
+					}
 					return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(data_);
 				case unicode::utf16:
 					return std::wstring_convert<std::codecvt_utf16<wchar_t, 0x10FFFF, std::little_endian>>().to_bytes(data_);
@@ -870,6 +1230,29 @@ namespace nana
 			}
 		}
 
+		//Returns true if the host byte order is little endian
+		static bool host_le()
+		{
+			const unsigned short one = 1;
+			return (1 == *reinterpret_cast<const unsigned char*>(&one));
+		}
+
+		//Appends the converted code units in host byte order through the transcoder, the output is
+		//reserved in exact size. It returns false if the input is ill-formed and nothing is appended.
+		template<typename OutChar, typename InChar>
+		static bool append_transcoded(std::string& out, const InChar* in, std::size_t len)
+		{
+			auto result = utf::transcode(in, len, static_cast<OutChar*>(nullptr), 0);
+			if (!result.valid)
+				return false;
+
+			auto const offset = out.size();
+			out.resize(offset + result.written * sizeof(OutChar));
+			if (result.written)
+				utf::transcode(in, len, reinterpret_cast<OutChar*>(&out[offset]), result.written);
+			return true;
+		}
+
 		std::string utf8_to_utf16(const std::string& s, bool le_or_be)
 		{
 			const unsigned char * bytes = reinterpret_cast<const unsigned char*>(s.c_str());
@@ -887,6 +1270,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && append_transcoded<char16_t>(utf16str, reinterpret_cast<const char*>(bytes), end - bytes))
+				return utf16str;
+
 			while(bytes != end)
 			{
 				put_utf16char(utf16str, utf8char(bytes, end), le_or_be);
@@ -910,6 +1296,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && append_transcoded<char32_t>(utf32str, reinterpret_cast<const char*>(bytes), end - bytes))
+				return utf32str;
+
 			while(bytes != end)
 			{
 				put_utf32char(utf32str, utf8char(bytes, end), le_or_be);
@@ -945,6 +1334,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && ((end - bytes) % 2 == 0) && append_transcoded<char>(utf8str, reinterpret_cast<const char16_t*>(bytes), (end - bytes) / 2))
+				return utf8str;
+
 			while(bytes != end)
 			{
 				put_utf8char(utf8str, utf16char(bytes, end, le_or_be));
@@ -975,6 +1367,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && ((end - bytes) % 2 == 0) && append_transcoded<char32_t>(utf32str, reinterpret_cast<const char16_t*>(bytes), (end - bytes) / 2))
+				return utf32str;
+
 			while(bytes != end)
 			{
 				put_utf32char(utf32str, utf16char(bytes, end, le_or_be), le_or_be);
@@ -1010,6 +1405,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && append_transcoded<char>(utf8str, reinterpret_cast<const char32_t*>(bytes), (end - bytes) / 4))
+				return utf8str;
+
 			while(bytes < end)
 			{
 				put_utf8char(utf8str, utf32char(bytes, end, le_or_be));
@@ -1041,6 +1439,9 @@ namespace nana
 				}
 			}
 
+			if ((le_or_be == host_le()) && append_transcoded<char16_t>(utf16str, reinterpret_cast<const char32_t*>(bytes), (end - bytes) / 4))
+				return utf16str;
+
 			while(bytes < end)
 			{
 				put_utf16char(utf16str, utf32char(bytes, end, le_or_be), le_or_be);
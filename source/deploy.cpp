@@ -132,11 +132,19 @@ namespace nana
 
 	std::string to_utf8(const std::wstring& text)
 	{
+		std::string utf8_str;
+		if (utf::transcode(text, utf8_str))
+			return utf8_str;
+
 		return ::nana::charset(text).to_bytes(::nana::unicode::utf8);
 	}
 
 	std::wstring to_wstring(const std::string& utf8_str)
 	{
+		std::wstring wstr;
+		if (utf::transcode(utf8_str, wstr))
+			return wstr;
+
 		return ::nana::charset(utf8_str, ::nana::unicode::utf8);
 	}
 
@@ -165,7 +173,7 @@ namespace nana
 #if defined(NANA_WINDOWS)
 	const detail::native_string_type to_nstring(const std::string& text)
 	{
-		return ::nana::charset(text, ::nana::unicode::utf8);
+		return to_wstring(text);
 	}
 
 	const detail::native_string_type& to_nstring(const std::wstring& text)
@@ -175,7 +183,7 @@ namespace nana
 
 	detail::native_string_type to_nstring(std::string&& text)
 	{
-		return ::nana::charset(text, ::nana::unicode::utf8);
+		return to_wstring(text);
 	}
 
 	detail::native_string_type&& to_nstring(std::wstring&& text)
@@ -205,7 +213,7 @@ namespace nana
 
 	const detail::native_string_type to_nstring(const std::wstring& text)
 	{
-		return ::nana::charset(text).to_bytes(::nana::unicode::utf8);
+		return to_utf8(text);
 	}
 
 	detail::native_string_type&& to_nstring(std::string&& text)
@@ -215,7 +223,7 @@ namespace nana
 
 	detail::native_string_type to_nstring(std::wstring&& text)
 	{
-		return ::nana::charset(text).to_bytes(::nana::unicode::utf8);
+		return to_utf8(text);
 	}
 
 	detail::native_string_type to_nstring(int n)
@@ -74,6 +74,9 @@ namespace detail
 			//Execute a function in a thread with is associated with a specified native window
 			affinity_execute,
 
+			//Execute a posted function, wParam is a pointer to std::function<void()> which is deleted after execution.
+			async_execute,
+
 			user,
 		};
 	};
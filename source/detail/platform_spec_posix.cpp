@@ -449,7 +449,7 @@ namespace detail
 	{}
 
 	platform_spec::platform_spec()
-		:display_(0), colormap_(0), def_X11_error_handler_(0), grab_(0)
+		:round_trips_avoided(0), display_(0), colormap_(0), def_X11_error_handler_(0), grab_(0)
 	{
 		::XInitThreads();
 		const char * langstr = getenv("LC_CTYPE");
@@ -518,6 +518,13 @@ namespace detail
 		msg_dispatcher_ = new msg_dispatcher(display_);
 
 		platform_abstraction::initialize();
+
+		int first_event, first_error;
+		if (!::XQueryExtension(display_, "RENDER", &allocation_.render_opcode, &first_event, &first_error))
+			allocation_.render_opcode = 0;
+
+		//The filter is installed at last, because it refers to the instance.
+		allocation_.next_handler = ::XSetErrorHandler(&platform_spec::_m_allocation_error_filter);
 	}
 
 	platform_spec::~platform_spec()
@@ -641,7 +648,14 @@ namespace detail
 		}
 		delete vec;
 		wincontext_.erase(i);
-		iconbase_.erase(wd);
+
+		auto icon = iconbase_.find(wd);
+		if (icon != iconbase_.end())
+		{
+			platform_scope_guard psg;
+			::XFreePixmap(display_, icon->second);
+			iconbase_.erase(icon);
+		}
 	}
 
 
@@ -916,6 +930,314 @@ namespace detail
 		return error_code;
 	}
 
+	void platform_spec::watch_allocation(Pixmap pixmap, GC context, unsigned long first_serial, unsigned long last_serial)
+	{
+		//The errors of the requests which are processed by the server have been read.
+		auto processed = ::XLastKnownRequestProcessed(display_);
+
+		std::lock_guard<std::mutex> lock(allocation_.mutex);
+		allocation_.watches.erase(std::remove_if(allocation_.watches.begin(), allocation_.watches.end(), [processed](const allocation_tag::watch& w){
+			return (static_cast<long>(processed - w.last_serial) >= 0);
+		}), allocation_.watches.end());
+
+		allocation_.watches.push_back(allocation_tag::watch{ pixmap, context, first_serial, last_serial });
+	}
+
+	bool platform_spec::allocation_failed(Pixmap pixmap)
+	{
+		std::lock_guard<std::mutex> lock(allocation_.mutex);
+		return (allocation_.failed.count(pixmap) != 0);
+	}
+
+	void platform_spec::geometry_register(native_window_type wd, native_window_type parent, const nana::rectangle& r)
+	{
+		platform_scope_guard psg;
+		auto & g = geometry_[reinterpret_cast<Window>(wd)];
+		g.parent = reinterpret_cast<Window>(parent);
+		g.rect = r;
+		g.border = 0;
+		g.rect_valid = true;
+		g.origin_valid = false;
+		if (g.parent == root_window())
+		{
+			g.origin = r.position();
+			g.origin_valid = true;
+		}
+		g.mapped_valid = true;
+		g.mapped = false;
+		g.configuring = false;
+	}
+
+	void platform_spec::geometry_invalidate(native_window_type wd)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i != geometry_.end())
+		{
+			i->second.rect_valid = i->second.origin_valid = false;
+
+			//It is called after the request, the entry is revalidated by the notify of this request.
+			i->second.configuring = true;
+			i->second.request_serial = NextRequest(display_) - 1;
+		}
+	}
+
+	void platform_spec::geometry_reparent(native_window_type wd, native_window_type parent)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i == geometry_.end())
+			return;
+
+		//The window is placed at (0, 0) of the new parent, the notifies of the earlier requests are stale.
+		auto & g = i->second;
+		g.parent = reinterpret_cast<Window>(parent);
+		g.rect.x = g.rect.y = 0;
+		g.origin_valid = false;
+		if (g.parent == root_window())
+		{
+			g.origin.x = g.origin.y = static_cast<int>(g.border);
+			g.origin_valid = true;
+		}
+
+		g.configuring = true;
+		g.request_serial = NextRequest(display_) - 1;
+	}
+
+	bool platform_spec::cached_parent(native_window_type wd, native_window_type& parent)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i == geometry_.end())
+			return false;
+
+		parent = reinterpret_cast<native_window_type>(i->second.parent);
+		return true;
+	}
+
+	bool platform_spec::cached_origin(native_window_type wd, nana::point& origin)
+	{
+		platform_scope_guard psg;
+		return _m_cached_origin(reinterpret_cast<Window>(wd), origin);
+	}
+
+	void platform_spec::cache_origin(native_window_type wd, const nana::point& origin)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+
+		//The origin of a window whose parent is a nana window is always calculated by the parent,
+		//because it is changed without an event when the parent is moved.
+		if ((i != geometry_.end()) && (geometry_.count(i->second.parent) == 0))
+		{
+			i->second.origin = origin;
+			i->second.origin_valid = true;
+		}
+	}
+
+	bool platform_spec::cached_rect(native_window_type wd, nana::rectangle& r)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if ((i == geometry_.end()) || !i->second.rect_valid)
+			return false;
+
+		r = i->second.rect;
+		return true;
+	}
+
+	void platform_spec::cache_rect(native_window_type wd, const nana::rectangle& r)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i != geometry_.end())
+		{
+			i->second.rect = r;
+			i->second.rect_valid = true;
+		}
+	}
+
+	int platform_spec::cached_mapped(native_window_type wd)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if ((i == geometry_.end()) || !i->second.mapped_valid)
+			return -1;
+
+		return (i->second.mapped ? 1 : 0);
+	}
+
+	void platform_spec::cache_mapped(native_window_type wd, bool mapped)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i != geometry_.end())
+		{
+			i->second.mapped = mapped;
+			i->second.mapped_valid = true;
+		}
+	}
+
+	void platform_spec::mapped_invalidate(native_window_type wd)
+	{
+		platform_scope_guard psg;
+		auto i = geometry_.find(reinterpret_cast<Window>(wd));
+		if (i != geometry_.end())
+			i->second.mapped_valid = false;
+	}
+
+	void platform_spec::_m_geometry_notify(const XEvent& evt)
+	{
+		switch (evt.type)
+		{
+		case ConfigureNotify:
+		case ReparentNotify:
+		case MapNotify:
+		case UnmapNotify:
+		case DestroyNotify:
+			break;
+		default:
+			return;
+		}
+
+		platform_scope_guard psg;
+		auto i = geometry_.find(evt.xany.window);
+		if (i == geometry_.end())
+			return;
+
+		auto & g = i->second;
+		switch (evt.type)
+		{
+		case ConfigureNotify:
+			{
+				auto & cf = evt.xconfigure;
+
+				//The notify of an earlier request is stale when another request is made after it, the
+				//entry is left invalid until the notify of the latest request arrives.
+				if (g.configuring)
+				{
+					if (static_cast<long>(cf.serial - g.request_serial) < 0)
+						break;
+
+					g.configuring = false;
+				}
+
+				if (cf.send_event)
+				{
+					//The synthetic event is sent by window manager, the position is in root coordinates.
+					g.origin.x = cf.x + cf.border_width;
+					g.origin.y = cf.y + cf.border_width;
+					g.origin_valid = (geometry_.count(g.parent) == 0);
+					g.rect.width = static_cast<unsigned>(cf.width);
+					g.rect.height = static_cast<unsigned>(cf.height);
+				}
+				else
+				{
+					const bool moved = (!g.rect_valid) || (g.rect.x != cf.x) || (g.rect.y != cf.y) || (g.border != static_cast<unsigned>(cf.border_width));
+
+					g.rect = nana::rectangle{ cf.x, cf.y, static_cast<unsigned>(cf.width), static_cast<unsigned>(cf.height) };
+					g.border = static_cast<unsigned>(cf.border_width);
+					g.rect_valid = true;
+
+					if (g.parent == root_window())
+					{
+						g.origin.x = cf.x + cf.border_width;
+						g.origin.y = cf.y + cf.border_width;
+						g.origin_valid = true;
+					}
+					else if (moved)
+						g.origin_valid = false;
+				}
+			}
+			break;
+		case ReparentNotify:
+			if (g.configuring && (static_cast<long>(evt.xreparent.serial - g.request_serial) < 0))
+				break;
+
+			g.parent = evt.xreparent.parent;
+			g.rect.x = evt.xreparent.x;
+			g.rect.y = evt.xreparent.y;
+			g.origin_valid = false;
+			if (g.parent == root_window())
+			{
+				g.origin.x = evt.xreparent.x + static_cast<int>(g.border);
+				g.origin.y = evt.xreparent.y + static_cast<int>(g.border);
+				g.origin_valid = true;
+			}
+			break;
+		case MapNotify:
+		case UnmapNotify:
+			g.mapped = (MapNotify == evt.type);
+			g.mapped_valid = true;
+			break;
+		case DestroyNotify:
+			geometry_.erase(i);
+			break;
+		}
+	}
+
+	bool platform_spec::_m_cached_origin(Window wd, nana::point& origin) const
+	{
+		if (wd == ::XDefaultRootWindow(display_))
+		{
+			origin.x = origin.y = 0;
+			return true;
+		}
+
+		auto i = geometry_.find(wd);
+		if (i == geometry_.end())
+			return false;
+
+		auto & g = i->second;
+		if (geometry_.count(g.parent))
+		{
+			//The window is a child of a nana window.
+			if (!g.rect_valid || !_m_cached_origin(g.parent, origin))
+				return false;
+
+			origin.x += g.rect.x + static_cast<int>(g.border);
+			origin.y += g.rect.y + static_cast<int>(g.border);
+			return true;
+		}
+
+		if (!g.origin_valid)
+			return false;
+
+		origin = g.origin;
+		return true;
+	}
+
+	int platform_spec::_m_allocation_error_filter(Display* disp, XErrorEvent* err)
+	{
+		auto & self = instance();
+		{
+			auto & alloc = self.allocation_;
+			std::lock_guard<std::mutex> lock(alloc.mutex);
+			for (auto & w : alloc.watches)
+			{
+				if (static_cast<long>(err->serial - w.first_serial) >= 0 && static_cast<long>(w.last_serial - err->serial) >= 0)
+				{
+					alloc.failed.insert(w.pixmap);
+					alloc.failed.insert(::XGContextFromGC(w.context));
+					return 0;
+				}
+			}
+
+			if (!alloc.failed.empty())
+			{
+				//The drawing and freeing requests on a failed pixmap refer to the resources which are not
+				//created. The requests of Xft refer to the pictures of the pixmap which are not created.
+				if (alloc.failed.count(err->resourceid) || (alloc.render_opcode && err->request_code == alloc.render_opcode))
+					return 0;
+			}
+		}
+
+		if (self.allocation_.next_handler)
+			return self.allocation_.next_handler(disp, err);
+
+		return 0;
+	}
+
 	void platform_spec::_m_caret_routine()
 	{
 		while(false == caret_holder_.exit_thread)
@@ -996,6 +1318,16 @@ namespace detail
 		msg_dispatcher_->dispatch(reinterpret_cast<Window>(modal));
 	}
 
+	bool platform_spec::msg_post(native_window_type wd, std::function<void()>&& fn)
+	{
+		auto fn_ptr = new std::function<void()>(std::move(fn));
+		if (msg_dispatcher_->post(reinterpret_cast<Window>(wd), fn_ptr))
+			return true;
+
+		delete fn_ptr;
+		return false;
+	}
+
 	void* platform_spec::request_selection(native_window_type requestor, Atom type, size_t& size)
 	{
 		if(requestor)
@@ -1051,12 +1383,22 @@ namespace detail
 	}
 
 	//Icon Storage
-	const nana::paint::graphics& platform_spec::keep_window_icon(native_window_type wd, const nana::paint::image& img)
+	Pixmap platform_spec::keep_window_icon(native_window_type wd, const nana::paint::image& img)
 	{
-		nana::paint::graphics & graph = iconbase_[wd];
-		graph.make(img.size());
+		nana::paint::graphics graph{ img.size() };
 		img.paste(graph, {});
-		return graph;
+
+		//The pixmap of a graphics may be larger than the graphics,
+		//the icon is copied into a pixmap in the size of image.
+		platform_scope_guard psg;
+		auto & icon = iconbase_[wd];
+		if (icon)
+			::XFreePixmap(display_, icon);
+
+		auto sz = img.size();
+		icon = ::XCreatePixmap(display_, root_window(), sz.width, sz.height, screen_depth());
+		::XCopyArea(display_, graph.handle()->pixmap, icon, graph.handle()->context, 0, 0, sz.width, sz.height, 0, 0);
+		return icon;
 	}
 
 	//_m_msg_filter
@@ -1069,6 +1411,8 @@ namespace detail
 		auto & bedrock = detail::bedrock::instance();
 
 		platform_spec & self = instance();
+		self._m_geometry_notify(evt);
+
 		if(KeyPress == evt.type || KeyRelease == evt.type)
 		{
 			auto menu_wd = bedrock.get_menu(reinterpret_cast<native_window_type>(evt.xkey.window), true);
@@ -129,7 +129,12 @@ namespace detail
 				for(auto li = thr->msg_queue.begin(); li != thr->msg_queue.end();)
 				{
 					if(wd == _m_window(*li))
+					{
+						if(msg_packet_tag::kind_post == li->kind)
+							delete li->u.post.function;
+
 						li = thr->msg_queue.erase(li);
+					}
 					else
 						++li;
 				}
@@ -149,6 +154,30 @@ namespace detail
 			}
 		}
 
+		//Posts a function to the queue of the thread which owns the window, the function is
+		//deleted after it is executed by the thread. It returns false if the window is not found,
+		//in which case the caller keeps the ownership of the function.
+		bool post(Window wd, std::function<void()>* fn)
+		{
+			std::lock_guard<decltype(table_.mutex)> lock(table_.mutex);
+
+			auto i = table_.wnd_table.find(wd);
+			if(i == table_.wnd_table.end())
+				return false;
+
+			msg_packet_tag msg;
+			msg.kind = msg.kind_post;
+			msg.u.post.window = wd;
+			msg.u.post.function = fn;
+
+			thread_binder * const thr = i->second;
+
+			std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
+			thr->msg_queue.push_back(msg);
+			thr->cond.notify_one();
+			return true;
+		}
+
 		void dispatch(Window modal)
 		{
 			auto tid = nana::system::this_thread_id();
@@ -247,6 +276,8 @@ namespace detail
 				return _m_event_window(pack.u.xevent);
 			case msg_packet_tag::kind_mouse_drop:
 				return pack.u.mouse_drop.window;
+			case msg_packet_tag::kind_post:
+				return pack.u.post.window;
 			default:
 				break;
 			}
@@ -300,6 +331,13 @@ namespace detail
 							return -1;
 					}
 
+					//Deletes the posted functions which are not executed.
+					for (auto & pack : i->second->msg_queue)
+					{
+						if (msg_packet_tag::kind_post == pack.kind)
+							delete pack.u.post.function;
+					}
+
 					delete i->second;
 					table_.thr_table.erase(i);
 					stop_driver = (table_.thr_table.size() == 0);
@@ -1,6 +1,7 @@
 #ifndef NANA_DETAIL_MSG_PACKET_HPP
 #define NANA_DETAIL_MSG_PACKET_HPP
 #include <X11/Xlib.h>
+#include <functional>
 #include <vector>
 #include <nana/deploy.hpp>
 
@@ -10,7 +11,7 @@ namespace detail
 {
 	struct msg_packet_tag
 	{
-		enum kind_t{kind_xevent, kind_mouse_drop, kind_cleanup};
+		enum kind_t{kind_xevent, kind_mouse_drop, kind_cleanup, kind_post};
 		kind_t kind;
 		union
 		{
@@ -24,6 +25,12 @@ namespace detail
 				int y;
 				std::vector<std::string> * files;
 			}mouse_drop;
+
+			struct post_tag
+			{
+				Window window;
+				std::function<void()> * function;	//The receiver deletes it after executing it.
+			}post;
 		}u;
 	};
 }//end namespace detail
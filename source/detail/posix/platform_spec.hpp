@@ -20,9 +20,11 @@
 
 #include <nana/push_ignore_diagnostic>
 
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <memory>
+#include <atomic>
 #include <condition_variable>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
@@ -35,6 +37,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 #include "msg_packet.hpp"
 #include "../platform_abstraction_types.hpp"
 
@@ -82,6 +85,9 @@ namespace detail
 		Pixmap	pixmap;
 		GC	context;
 
+		nana::size	size;		//The size of drawable.
+		nana::size	capacity;	//The size of pixmap, it may be larger than the drawable for the growth.
+
 		font_type font;
 
 		nana::point	line_begin_pos;
@@ -185,6 +191,7 @@ namespace detail
 		};
 	public:
 		int error_code;
+		std::atomic<std::size_t> round_trips_avoided;	///< The number of round trips answered by the geometry cache.
 	public:
 		typedef void (*timer_proc_type)(thread_t tid);
 		typedef void (*event_proc_type)(Display*, msg_packet_tag&);
@@ -228,6 +235,28 @@ namespace detail
 		void set_error_handler();
 		int rev_error_handler();
 
+		//Registers the requests in [first_serial, last_serial] which allocate the pixmap and its GC. Their errors
+		//are caught instead of being passed to the default handler and the pixmap is marked as failed, the errors
+		//of the later requests on a failed pixmap are caught as well. It doesn't wait for the server.
+		void watch_allocation(Pixmap, GC, unsigned long first_serial, unsigned long last_serial);
+
+		//Returns true if an error of the pixmap allocation has arrived. It doesn't wait for the server.
+		bool allocation_failed(Pixmap);
+
+		//Geometry cache of the native windows created by nana. It is kept current by the structure
+		//events, the queries return false/-1 if the state is unknown and a round trip is required.
+		void geometry_register(native_window_type wd, native_window_type parent, const nana::rectangle& r);
+		void geometry_invalidate(native_window_type wd);
+		void geometry_reparent(native_window_type wd, native_window_type parent);	//It is called after XReparentWindow(wd, parent, 0, 0)
+		bool cached_parent(native_window_type wd, native_window_type& parent);
+		bool cached_origin(native_window_type wd, nana::point& origin);	//The root coordinates of client origin
+		void cache_origin(native_window_type wd, const nana::point& origin);
+		bool cached_rect(native_window_type wd, nana::rectangle& r);
+		void cache_rect(native_window_type wd, const nana::rectangle& r);
+		int cached_mapped(native_window_type wd);
+		void cache_mapped(native_window_type wd, bool mapped);
+		void mapped_invalidate(native_window_type wd);
+
 		//grab
 		//register a grab window while capturing it if it is unviewable.
 		//when native_interface::show a window that is registered as a grab
@@ -241,17 +270,21 @@ namespace detail
 		void msg_insert(native_window_type);
 		void msg_set(timer_proc_type, event_proc_type);
 		void msg_dispatch(native_window_type modal);
+		bool msg_post(native_window_type, std::function<void()>&&);	///< Posts a function to the thread which owns the window.
 
 		//X Selections
 		void* request_selection(native_window_type requester, Atom type, size_t & bufsize);
 		void write_selection(native_window_type owner, Atom type, const void* buf, size_t bufsize);
 
 		//Icon storage
-		//@biref: The image object should be kept for a long time till the window is closed,
-		//			the image object is release in remove() method.
-		const nana::paint::graphics& keep_window_icon(native_window_type, const nana::paint::image&);
+		//@biref: The icon pixmap should be kept for a long time till the window is closed,
+		//			the pixmap is release in remove() method.
+		Pixmap keep_window_icon(native_window_type, const nana::paint::image&);
 	private:
 		static int _m_msg_filter(XEvent&, msg_packet_tag&);
+		static int _m_allocation_error_filter(Display*, XErrorEvent*);
+		void _m_geometry_notify(const XEvent&);
+		bool _m_cached_origin(Window, nana::point&) const;
 		void _m_caret_routine();
 	private:
 		Display*	display_;
@@ -270,7 +303,40 @@ namespace detail
 		}caret_holder_;
 
 		std::map<native_window_type, window_context_t> wincontext_;
-		std::map<native_window_type, nana::paint::graphics> iconbase_;
+		std::map<native_window_type, Pixmap> iconbase_;
+
+		struct window_geometry
+		{
+			Window parent;
+			nana::rectangle rect;	//The position of border relative to the parent and the size, same as XGetGeometry
+			unsigned border{ 0 };
+			nana::point origin;		//The root coordinates of client origin
+			bool rect_valid{ false };
+			bool origin_valid{ false };
+			bool mapped_valid{ false };
+			bool mapped{ false };
+			bool configuring{ false };			//A configure request is not notified yet
+			unsigned long request_serial{ 0 };	//The serial of the latest configure request
+		};
+
+		std::map<Window, window_geometry> geometry_;
+
+		struct allocation_tag
+		{
+			struct watch
+			{
+				Pixmap pixmap;
+				GC context;
+				unsigned long first_serial;
+				unsigned long last_serial;
+			};
+
+			std::mutex mutex;
+			std::vector<watch> watches;		//The allocations whose errors may not arrive yet
+			std::set<XID> failed;			//The pixmaps and GCs of the failed allocations, they are kept for the late errors
+			int render_opcode{ 0 };			//The major opcode of RENDER extension which is used by Xft
+			int (*next_handler)(Display*, XErrorEvent*){ nullptr };
+		}allocation_;
 
 		struct timer_runner_tag
 		{
@@ -13,14 +13,14 @@
 
 #include <nana/gui/animation.hpp>
 #include <nana/gui/drawing.hpp>
-#include <nana/system/timepiece.hpp>
-#include <nana/system/platform.hpp>
+#include <nana/gui/programming_interface.hpp>
 
 #include <vector>
 #include <list>
 #include <map>
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 
 #if defined(STD_THREAD_NOT_SUPPORTED)
     #include <nana/std_thread.hpp>
@@ -44,12 +44,60 @@ namespace nana
 
 	struct framebuilder
 	{
+		//The maximum number of pixels of pre-composited frames kept by a framebuilder.
+		static const std::size_t cache_pixels = 1 << 22;
+
+		struct composited
+		{
+			paint::graphics graph;
+			nana::size dimension;
+			bool built{ false };
+			bool good{ false };
+		};
+
 		std::size_t length;
 		std::function<bool(std::size_t, paint::graphics&, nana::size&)> frbuilder;
 
+		std::vector<composited> cache;
+		std::size_t cached_pixels{ 0 };
+
 		framebuilder(std::function<bool(std::size_t, paint::graphics&, nana::size&)> f, std::size_t l)
 			: length(l), frbuilder(std::move(f))
 		{}
+
+		//Returns the graphics which holds the frame at pos, or nullptr if the builder fails.
+		//A generated frame is copied into its own graphics while the cache is below cache_pixels,
+		//so that a looped animation invokes the builder only once for each frame.
+		paint::graphics* build(std::size_t pos, paint::graphics& framegraph, nana::size& dimension)
+		{
+			if ((pos < cache.size()) && cache[pos].built)
+			{
+				auto & cf = cache[pos];
+				dimension = cf.dimension;
+				return (cf.good ? &cf.graph : nullptr);
+			}
+
+			bool good = frbuilder(pos, framegraph, dimension);
+
+			const std::size_t pixels = (good ? static_cast<std::size_t>(dimension.width) * dimension.height : 0);
+			if (cached_pixels + pixels > cache_pixels)
+				return (good ? &framegraph : nullptr);
+
+			if (cache.size() <= pos)
+				cache.resize(pos + 1);
+
+			auto & cf = cache[pos];
+			cf.built = true;
+			cf.good = good && pixels;
+			cf.dimension = dimension;
+			if (!cf.good)
+				return (good ? &framegraph : nullptr);
+
+			cf.graph.make(dimension);
+			cf.graph.bitblt(nana::rectangle{ dimension }, framegraph);
+			cached_pixels += pixels;
+			return &cf.graph;
+		}
 	};
 
 	struct frame
@@ -185,6 +233,8 @@ namespace nana
 			std::list<frame>::iterator this_frame;
 			std::size_t pos_in_this_frame{ 0 };
 			mutable bool good_frame_by_frmbuilder{ false };	//It indicates the state of frame whether is valid.
+			mutable paint::graphics shown_frame;			//The frame which is last generated by the framebuilder.
+			mutable nana::size shown_dimension;
 
 			impl()
 				:	this_frame(frames.end())
@@ -206,23 +256,29 @@ namespace nana
 					});
 					break;
 				case frame::kind::framebuilder:
-					good_frame_by_frmbuilder = frmobj.u.frbuilder->frbuilder(pos_in_this_frame, framegraph, framegraph_dimension);
-					if(good_frame_by_frmbuilder)
 					{
-						nana::rectangle r(framegraph_dimension);
-						_m_render(outs, [&r, &framegraph](paint::graphics& tar, const nana::point& pos) mutable
+						auto graph = frmobj.u.frbuilder->build(pos_in_this_frame, framegraph, framegraph_dimension);
+						good_frame_by_frmbuilder = (nullptr != graph);
+						if(good_frame_by_frmbuilder)
 						{
-							r.x = pos.x;
-							r.y = pos.y;
-							tar.bitblt(r, framegraph);
-						});
+							shown_frame = *graph;
+							shown_dimension = framegraph_dimension;
+
+							nana::rectangle r(framegraph_dimension);
+							_m_render(outs, [&r, graph](paint::graphics& tar, const nana::point& pos) mutable
+							{
+								r.x = pos.x;
+								r.y = pos.y;
+								tar.bitblt(r, *graph);
+							});
+						}
 					}
 					break;
 				}
 			}
 
-			//Render a frame on a specified window graph
-			void render_this(paint::graphics& graph, const nana::point& pos, paint::graphics& framegraph, nana::size& framegraph_dimension, bool rebuild_frame) const
+			//Render the frame which is last rendered on a specified window graph
+			void render_this(paint::graphics& graph, const nana::point& pos) const
 			{
 				if(this_frame == frames.end())
 					return;
@@ -234,14 +290,8 @@ namespace nana
 					frmobj.u.oneshot->paste(graph, pos);
 					break;
 				case frame::kind::framebuilder:
-					if(rebuild_frame)
-						good_frame_by_frmbuilder = frmobj.u.frbuilder->frbuilder(pos_in_this_frame, framegraph, framegraph_dimension);
-
 					if(good_frame_by_frmbuilder)
-					{
-						nana::rectangle r(pos, framegraph_dimension);
-						graph.bitblt(r, framegraph);
-					}
+						graph.bitblt(nana::rectangle(pos, shown_dimension), shown_frame);
 					break;
 				}
 			}
@@ -322,30 +372,39 @@ namespace nana
 	//end class frameset
 
 	//class animation
+		//The performance_manager is the frame clock of all animations. A single thread sleeps
+		//until the earliest absolute deadline of the steady clock, and then posts a tick to the
+		//GUI thread of each output window. The frames are rendered by the GUI thread.
 		class animation::performance_manager
 		{
 		public:
-			struct thread_variable
-			{
-				std::mutex mutex;
-				std::condition_variable condvar;
-				std::vector<impl*> animations;
+			using clock_type = std::chrono::steady_clock;
+
+			static performance_manager& instance();
 
-				std::size_t active;				//The number of active animations
-				std::shared_ptr<std::thread> thread;
+			performance_manager();
+			~performance_manager();
 
-				std::size_t fps;
-				double interval;	//milliseconds between 2 frames.
-				double performance_parameter;
-			};
+			std::recursive_mutex& mutex();
 
 			void insert(impl* p);
 			void set_fps(impl*, std::size_t new_fps);
 			void close(impl* p);
-			bool empty() const;
+
+			//Schedules the animation at the next tick of its frame rate.
+			void activate(impl* p);
+			void deactivate(impl* p);
+		private:
+			void _m_run();
+			void _m_tick(window root);
+			clock_type::time_point _m_next_tick(const impl*, clock_type::time_point now) const;
 		private:
-			mutable std::recursive_mutex mutex_;
-			std::vector<thread_variable*> threads_;
+			std::recursive_mutex mutex_;
+			std::condition_variable_any condvar_;
+			std::vector<impl*> animations_;
+			const clock_type::time_point epoch_;
+			bool exit_{ false };
+			std::thread thread_;
 		};	//end class animation::performance_manager
 
 		struct animation::impl
@@ -366,44 +425,31 @@ namespace nana
 				std::list<frameset>::iterator this_frameset;
 			}state;
 
-			performance_manager::thread_variable * thr_variable;
-			static performance_manager * perf_manager;
+			//Scheduling states, they are guarded by the mutex of performance_manager.
+			bool active{ false };
+			std::chrono::nanoseconds interval;
+			performance_manager::clock_type::time_point deadline;
+			std::size_t due_frames{ 0 };	//The number of frames elapsed since the last rendering.
 
+			performance_manager & perf_manager;
 
 			impl(std::size_t fps)
-				: fps(fps)
+				: fps(fps), perf_manager(performance_manager::instance())
 			{
 				state.this_frameset = framesets.begin();
-
-				if (!perf_manager)
-				{
-					nana::internal_scope_guard lock;
-					if (!perf_manager)
-					{
-						auto pm = new performance_manager;
-						perf_manager = pm;
-					}
-				}
-				perf_manager->insert(this);
+				perf_manager.insert(this);
 			}
 
 			~impl()
 			{
-				perf_manager->close(this);
-				{
-					nana::internal_scope_guard lock;
-					if(perf_manager->empty())
-					{
-						delete perf_manager;
-						perf_manager = nullptr;
-					}
-				}
+				perf_manager.close(this);
 			}
 
 			void render_this_specifically(paint::graphics& graph, const nana::point& pos)
 			{
+				std::lock_guard<std::recursive_mutex> lock(perf_manager.mutex());
 				if(state.this_frameset != framesets.end())
-					state.this_frameset->impl_->render_this(graph, pos, framegraph, framegraph_dimension, false);
+					state.this_frameset->impl_->render_this(graph, pos);
 			}
 
 			void render_this_frame()
@@ -422,6 +468,23 @@ namespace nana
 				return false;
 			}
 
+			//Moves to the next frame, and rewinds if the animation is looped.
+			//Returns false if the animation reaches the end.
+			bool step()
+			{
+				if (move_to_next())
+					return true;
+
+				if (looped)
+				{
+					reset();
+					return true;
+				}
+
+				active = false;
+				return false;
+			}
+
 			//Seek to the first frameset
 			void reset()
 			{
@@ -432,132 +495,191 @@ namespace nana
 		};//end struct animation::impl
 
 		//class animation::performance_manager
+			animation::performance_manager& animation::performance_manager::instance()
+			{
+				static performance_manager object;
+				return object;
+			}
+
+			animation::performance_manager::performance_manager()
+				:	epoch_(clock_type::now()),
+					thread_([this]{ _m_run(); })
+			{
+			}
+
+			animation::performance_manager::~performance_manager()
+			{
+				{
+					std::lock_guard<decltype(mutex_)> lock(mutex_);
+					exit_ = true;
+				}
+				condvar_.notify_one();
+				thread_.join();
+			}
+
+			std::recursive_mutex& animation::performance_manager::mutex()
+			{
+				return mutex_;
+			}
+
 			void animation::performance_manager::insert(impl* p)
 			{
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				for(auto thr : threads_)
+				p->interval = std::chrono::nanoseconds(std::chrono::seconds(1)) / static_cast<long>(p->fps ? p->fps : 1);
+				animations_.push_back(p);
+			}
+
+			void animation::performance_manager::set_fps(impl* p, std::size_t new_fps)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				if (p->fps == new_fps)
+					return;
+
+				p->fps = new_fps;
+				p->interval = std::chrono::nanoseconds(std::chrono::seconds(1)) / static_cast<long>(new_fps ? new_fps : 1);
+
+				if (p->active)
 				{
-					std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
-					if (thr->fps == p->fps)
-					{
-						if (thr->animations.empty() || (thr->performance_parameter * (1.0 + 1.0 / thr->animations.size()) <= 43.3))
-						{
-							p->thr_variable = thr;
-							thr->animations.push_back(p);
-							return;
-						}
-					}
+					p->deadline = _m_next_tick(p, clock_type::now());
+					condvar_.notify_one();
 				}
+			}
+
+			void animation::performance_manager::close(impl* p)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				auto i = std::find(animations_.begin(), animations_.end(), p);
+				if (i != animations_.end())
+					animations_.erase(i);
+			}
+
+			void animation::performance_manager::activate(impl* p)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				if (p->active)
+					return;
+
+				p->active = true;
+				p->due_frames = 0;
+				p->deadline = _m_next_tick(p, clock_type::now());
+				condvar_.notify_one();
+			}
+
+			void animation::performance_manager::deactivate(impl* p)
+			{
+				std::lock_guard<decltype(mutex_)> lock(mutex_);
+				p->active = false;
+				p->due_frames = 0;
+			}
+
+			void animation::performance_manager::_m_run()
+			{
+				std::vector<window> targets;
 
-				auto thr = new thread_variable;
-				thr->animations.push_back(p);
-				thr->performance_parameter = 0.0;
-				thr->fps = p->fps;
-				thr->interval = 1000.0 / double(p->fps);
-				thr->thread = std::make_shared<std::thread>([thr]()
+				std::unique_lock<decltype(mutex_)> lock(mutex_);
+				while (!exit_)
 				{
-					nana::system::timepiece tmpiece;
-					while (true)
+					auto now = clock_type::now();
+					auto wakeup = clock_type::time_point::max();
+
+					targets.clear();
+					for (auto ani : animations_)
 					{
-						thr->active = 0;
-						tmpiece.start();
+						if (ani->paused || !ani->active)
+							continue;
 
+						if (ani->deadline <= now)
 						{
-							std::lock_guard<decltype(thr->mutex)> lock(thr->mutex);
-							for (auto ani : thr->animations)
-							{
-								if (ani->paused)
-									continue;
+							//The frames whose deadlines are missed are skipped, the deadline
+							//is kept on the tick of the frame rate to avoid drifting.
+							auto elapsed = (now - ani->deadline) / ani->interval + 1;
+							ani->deadline += elapsed * ani->interval;
+							ani->due_frames += static_cast<std::size_t>(elapsed);
 
-								ani->render_this_frame();
-								if (false == ani->move_to_next())
+							if (ani->outputs.empty())
+							{
+								//Nothing to render, only the position is moved.
+								for (; ani->due_frames; --ani->due_frames)
 								{
-									if (ani->looped)
-									{
-										ani->reset();
-										++thr->active;
-									}
+									if (!ani->step())
+										break;
 								}
-								else
-									++thr->active;
+								ani->due_frames = 0;
 							}
+							else if (targets.cend() == std::find(targets.cbegin(), targets.cend(), ani->outputs.cbegin()->first))
+								targets.push_back(ani->outputs.cbegin()->first);
 						}
 
-						if (thr->active)
+						if (ani->active && (ani->deadline < wakeup))
+							wakeup = ani->deadline;
+					}
+
+					if (!targets.empty())
+					{
+						//Don't hold the mutex while posting, because the GUI thread locks it
+						//after the internal lock.
+						lock.unlock();
+
+						std::vector<window> roots;
+						for (auto wd : targets)
 						{
-							thr->performance_parameter = tmpiece.calc();
-							if (thr->performance_parameter < thr->interval)
-								nana::system::sleep(static_cast<unsigned>(thr->interval - thr->performance_parameter));
+							auto root = API::root(API::root(wd));
+							if (root && (roots.cend() == std::find(roots.cbegin(), roots.cend(), root)))
+								roots.push_back(root);
 						}
-						else
+
+						//The ticks to a busy GUI thread are coalesced, the accumulated
+						//due_frames make it skip the frames instead of falling behind.
+						for (auto root : roots)
 						{
-							//There isn't an active frame, then let the thread
-							//wait for a signal for an active animation
-							std::unique_lock<std::mutex> lock(thr->mutex);
-							if (0 == thr->active)
-								thr->condvar.wait(lock);
+							API::post_coalesced(root, reinterpret_cast<std::size_t>(this), [this, root]{
+								_m_tick(root);
+							});
 						}
+
+						lock.lock();
+						continue;
 					}
-				});
 
-				threads_.push_back(thr);
-				p->thr_variable = thr;
+					if (wakeup == clock_type::time_point::max())
+						condvar_.wait(lock);
+					else
+						condvar_.wait_until(lock, wakeup);
+				}
 			}
 
-			void animation::performance_manager::set_fps(impl* p, std::size_t new_fps)
+			void animation::performance_manager::_m_tick(window root)
 			{
-				if (p->fps == new_fps)
-					return;
-
+				internal_scope_guard isg;
 				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				auto i = std::find(threads_.begin(), threads_.end(), p->thr_variable);
-				if (i == threads_.end())
-					return;
-
-				p->fps = new_fps;
-				auto thr = *i;
 
-				//Simply modify the fps parameter if the thread just has one animation.
-				if (thr->animations.size() == 1)
+				auto native = API::root(root);
+				for (auto ani : animations_)
 				{
-					thr->fps = new_fps;
-					thr->interval = 1000.0 / double(new_fps);
-					return;
-				}
-
-				std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
-				auto u = std::find(thr->animations.begin(), thr->animations.end(), p);
-				if (u != thr->animations.end())
-					thr->animations.erase(u);
-
-				p->thr_variable = nullptr;
-				insert(p);
-			}
+					if ((0 == ani->due_frames) || ani->outputs.empty())
+						continue;
 
-			void animation::performance_manager::close(impl* p)
-			{
-				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				auto i = std::find(threads_.begin(), threads_.end(), p->thr_variable);
-				if (i == threads_.end())
-					return;
+					if (API::root(ani->outputs.cbegin()->first) != native)
+						continue;
 
-				auto thr = *i;
-				std::lock_guard<decltype(thr->mutex)> privlock(thr->mutex);
+					bool more = true;
+					for (; more && (ani->due_frames > 1); --ani->due_frames)
+						more = ani->step();
 
-				auto u = std::find(thr->animations.begin(), thr->animations.end(), p);
-				if(u != thr->animations.end())
-					thr->animations.erase(u);
+					ani->due_frames = 0;
+					if (more)
+					{
+						ani->render_this_frame();
+						ani->step();
+					}
+				}
 			}
 
-			bool animation::performance_manager::empty() const
+			auto animation::performance_manager::_m_next_tick(const impl* p, clock_type::time_point now) const -> clock_type::time_point
 			{
-				std::lock_guard<decltype(mutex_)> lock(mutex_);
-				for(auto thr : threads_)
-				{
-					if(thr->animations.size())
-						return false;
-				}
-				return true;
+				//The animations in same fps share the ticks, so they are woken up together.
+				auto ticks = (now - epoch_) / p->interval + 1;
+				return epoch_ + ticks * p->interval;
 			}
 		//end class animation::performance_manager
 
@@ -573,6 +695,7 @@ namespace nana
 
 		void animation::push_back(frameset frms)
 		{
+			std::lock_guard<std::recursive_mutex> lock(impl_->perf_manager.mutex());
 			impl_->framesets.emplace_back(std::move(frms));
 			if(1 == impl_->framesets.size())
 				impl_->state.this_frameset = impl_->framesets.begin();
@@ -593,39 +716,31 @@ namespace nana
 
 		void animation::looped(bool enable)
 		{
+			std::lock_guard<std::recursive_mutex> lock(impl_->perf_manager.mutex());
 			if(impl_->looped != enable)
 			{
 				impl_->looped = enable;
 				if(enable)
-				{
-					std::unique_lock<std::mutex> lock(impl_->thr_variable->mutex);
-					if(0 == impl_->thr_variable->active)
-					{
-						impl_->thr_variable->active = 1;
-						impl_->thr_variable->condvar.notify_one();
-					}
-				}
+					impl_->perf_manager.activate(impl_);
 			}
 		}
 
 		void animation::play()
 		{
 			impl_->paused = false;
-			std::unique_lock<std::mutex> lock(impl_->thr_variable->mutex);
-			if(0 == impl_->thr_variable->active)
-			{
-				impl_->thr_variable->active = 1;
-				impl_->thr_variable->condvar.notify_one();
-			}
+			impl_->perf_manager.activate(impl_);
 		}
 
 		void animation::pause()
 		{
 			impl_->paused = true;
+			impl_->perf_manager.deactivate(impl_);
 		}
 
 		void animation::output(window wd, const nana::point& pos)
 		{
+			internal_scope_guard isg;
+			std::lock_guard<std::recursive_mutex> lock(impl_->perf_manager.mutex());
 			auto & output = impl_->outputs[wd];
 
 			if(nullptr == output.diehard)
@@ -636,7 +751,7 @@ namespace nana
 				});
 
 				API::events(wd).destroy.connect([this](const arg_destroy& arg){
-					std::lock_guard<decltype(impl_->thr_variable->mutex)> lock(impl_->thr_variable->mutex);
+					std::lock_guard<std::recursive_mutex> lock(impl_->perf_manager.mutex());
 					impl_->outputs.erase(arg.window_handle);
 				});
 			}
@@ -648,7 +763,7 @@ namespace nana
 			if (n == impl_->fps)
 				return;
 
-			impl::perf_manager->set_fps(impl_, n);
+			impl_->perf_manager.set_fps(impl_, n);
 		}
 
 		std::size_t animation::fps() const
@@ -656,8 +771,5 @@ namespace nana
 			return impl_->fps;
 		}
 	//end class animation
-
-
-	animation::performance_manager * animation::impl::perf_manager;
 }	//end namespace nana
 
@@ -69,9 +69,14 @@ namespace nana
 			return bedrock::instance().wd_manager().available(reinterpret_cast<window_manager::core_window_t*>(wd));
 		}
 
-		void events_operation_register(event_handle evt)
+		event_handle events_operation_register(event_interface* evt)
 		{
-			bedrock::instance().evt_operation().register_evt(evt);
+			return bedrock::instance().evt_operation().register_evt(evt);
+		}
+
+		void events_operation_cancel(event_handle evt)
+		{
+			bedrock::instance().evt_operation().cancel(evt);
 		}
 
 		class bedrock::flag_guard
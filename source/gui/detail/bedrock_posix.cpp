@@ -421,6 +421,13 @@ namespace detail
 		case nana::detail::msg_packet_tag::kind_mouse_drop:
 			window_proc_for_packet(display, msg);
 			break;
+		case nana::detail::msg_packet_tag::kind_post:
+			{
+				//The function is posted by API::post, the packet owns it.
+				std::unique_ptr<std::function<void()>> fn{ msg.u.post.function };
+				(*fn)();
+			}
+			break;
 		default: break;
 		}
 	}
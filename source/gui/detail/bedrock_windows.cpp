@@ -666,6 +666,13 @@ namespace detail
 					(*arg->function_ptr)();
 			}
 			break;
+		case nana::detail::messages::async_execute:
+			if (wParam)
+			{
+				std::unique_ptr<std::function<void()>> fn{ reinterpret_cast<std::function<void()>*>(wParam) };
+				(*fn)();
+			}
+			break;
 		default:
 			break;
 		}
@@ -1591,6 +1598,14 @@ namespace detail
 				nana::detail::platform_spec::instance().release_window_icon(msgwnd->root);
 				break;
 			case WM_NCDESTROY:
+				{
+					//Deletes the functions which are posted to the window but not executed, the system discards
+					//the messages of a destroyed window.
+					MSG pending;
+					while (::PeekMessage(&pending, root_window, nana::detail::messages::async_execute, nana::detail::messages::async_execute, PM_REMOVE))
+						delete reinterpret_cast<std::function<void()>*>(pending.wParam);
+				}
+
 				brock.manage_form_loader(msgwnd, false);
 				wd_manager.destroy_handle(msgwnd);
 
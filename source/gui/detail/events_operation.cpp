@@ -1,151 +1,68 @@
 #include <nana/gui/detail/events_operation.hpp>
 #include <nana/gui/detail/bedrock.hpp>
+#include <cstdint>
 
 namespace nana
 {
 	namespace detail
 	{
 		//class events_operation
-			using lock_guard = std::lock_guard<std::recursive_mutex>;
+			//A handle is composed of the generation in the high half and the position plus one in the low half,
+			//a valid handle is never a null pointer.
+			constexpr unsigned handle_shift = sizeof(std::uintptr_t) * 4;
+			constexpr std::uintptr_t handle_mask = (std::uintptr_t(1) << handle_shift) - 1;
+			constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-			void events_operation::register_evt(event_handle evt)
+			event_handle events_operation::register_evt(event_interface* evt)
 			{
-				lock_guard lock(mutex_);
-				handles_.insert(evt);
-			}
-
-			void events_operation::cancel(event_handle evt)
-			{
-				lock_guard lock(mutex_);
-				handles_.erase(evt);
-			}
-
-			void events_operation::erase(event_handle evt)
-			{
-				lock_guard lock(mutex_);
-
-				auto i = handles_.find(evt);
-				if (i != handles_.end())
+				std::size_t pos = free_;
+				if (npos != pos)
 				{
-					reinterpret_cast<detail::docker_interface*>(evt)->get_event()->remove(evt);
+					free_ = slots_[pos].next_free;
+					slots_[pos].event = evt;
+				}
+				else
+				{
+					pos = slots_.size();
+					slots_.push_back(slot{ evt, 0, npos });
 				}
-			}
-		//end namespace events_operation
-
-
-		//class docker_base
-			docker_base::docker_base(event_interface* evt, bool unignorable_flag)
-				: event_ptr(evt), unignorable(unignorable_flag)
-			{}
-
-			detail::event_interface * docker_base::get_event() const
-			{
-				return event_ptr;
-			}
-		//end class docker_base
-
-		//class event_base
-			event_base::~event_base()
-			{
-				clear();
-			}
 
-			std::size_t event_base::length() const
-			{
-				internal_scope_guard lock;
-				return (nullptr == dockers_ ? 0 : dockers_->size());
+				auto value = (static_cast<std::uintptr_t>(slots_[pos].generation & handle_mask) << handle_shift) | (pos + 1);
+				return reinterpret_cast<event_handle>(value);
 			}
 
-			void event_base::clear() noexcept
+			void events_operation::cancel(event_handle evt)
 			{
-				internal_scope_guard lock;
-				if (dockers_)
+				auto p = _m_find(evt);
+				if (p)
 				{
-					auto & evt_operation = bedrock::instance().evt_operation();
-
-					for (auto p : *dockers_)
-					{
-						evt_operation.cancel(reinterpret_cast<event_handle>(p));
-						delete p;
-					}
-					dockers_->clear();
-
-					delete dockers_;
-					dockers_ = nullptr;
+					p->event = nullptr;
+					++(p->generation);
+					p->next_free = free_;
+					free_ = static_cast<std::size_t>(p - slots_.data());
 				}
 			}
 
-			void event_base::remove(event_handle evt)
+			void events_operation::erase(event_handle evt)
 			{
-				internal_scope_guard lock;
-				if (dockers_)
-				{
-					for (auto i = dockers_->begin(), end = dockers_->end(); i != end; ++i)
-					{
-						if (reinterpret_cast<detail::docker_interface*>(evt) == *i)
-						{
-							//Checks whether this event is working now.
-							if (emitting_count_)
-							{
-								static_cast<docker_base*>(*i)->flag_deleted = true;
-								deleted_flags_ = true;
-							}
-							else
-							{
-								bedrock::instance().evt_operation().cancel(evt);
-								dockers_->erase(i);
-								delete reinterpret_cast<detail::docker_interface*>(evt);
-							}
-							break;
-						}
-					}
-				}
+				auto p = _m_find(evt);
+				if (p)
+					p->event->remove(evt);	//The event cancels the handle.
 			}
 
-			event_handle event_base::_m_emplace(detail::docker_interface* docker_ptr, bool in_front)
+			auto events_operation::_m_find(event_handle evt) -> slot*
 			{
-				internal_scope_guard lock;
-				if (nullptr == dockers_)
-					dockers_ = new std::vector<detail::docker_interface*>;
-
-				auto evt = reinterpret_cast<event_handle>(docker_ptr);
+				auto value = reinterpret_cast<std::uintptr_t>(evt);
+				auto pos = static_cast<std::size_t>(value & handle_mask);
+				if ((0 == pos) || (pos > slots_.size()))
+					return nullptr;
 
-				if (in_front)
-					dockers_->emplace(dockers_->begin(), docker_ptr);
-				else
-					dockers_->emplace_back(docker_ptr);
+				auto & s = slots_[pos - 1];
+				if (s.event && ((s.generation & handle_mask) == (value >> handle_shift)))
+					return &s;
 
-				detail::events_operation_register(evt);
-				return evt;
+				return nullptr;
 			}
-			
-			//class emit_counter
-				event_base::emit_counter::emit_counter(event_base* evt)
-					: evt_{ evt }
-				{
-					++evt->emitting_count_;
-				}
-
-				event_base::emit_counter::~emit_counter()
-				{
-					if ((0 == --evt_->emitting_count_) && evt_->deleted_flags_)
-					{
-						evt_->deleted_flags_ = false;
-						for (auto i = evt_->dockers_->begin(); i != evt_->dockers_->end();)
-						{
-							if (static_cast<docker_base*>(*i)->flag_deleted)
-							{
-								bedrock::instance().evt_operation().cancel(reinterpret_cast<event_handle>(*i));
-								delete (*i);
-								i = evt_->dockers_->erase(i);
-							}
-							else
-								++i;
-						}
-					}
-				}
-			//end class emit_counter
-		//end class event_base
-
+		//end class events_operation
 	}//end namespace detail
-}//end namespace nana
\ No newline at end of file
+}//end namespace nana
@@ -160,6 +160,23 @@ namespace nana{
 #endif	
 		}
 
+		bool native_interface::post(native_window_type native_handle, std::function<void()>&& fn)
+		{
+			if (!fn)
+				return false;
+
+#if defined(NANA_WINDOWS)
+			auto fn_ptr = new std::function<void()>(std::move(fn));
+			if (::PostMessage(reinterpret_cast<HWND>(native_handle), detail::messages::async_execute, reinterpret_cast<WPARAM>(fn_ptr), 0))
+				return true;
+
+			delete fn_ptr;
+			return false;
+#elif defined(NANA_X11)
+			return restrict::spec.msg_post(native_handle, std::move(fn));
+#endif
+		}
+
 		nana::size native_interface::primary_monitor_size()
 		{
 #if defined(NANA_WINDOWS)
@@ -201,6 +218,22 @@ namespace nana{
 		//unmapped, and the members x and y of XSetSizeHints is obsoluted. So the position that
 		//set to a unmapped windows should be kept and use the position when the window is mapped.
 		std::map<Window, ::nana::point> exposed_positions;	//locked by platform_scope_guard
+
+		//Returns true if the window is unmapped, the map state is queried only if it is not cached.
+		static bool is_unmapped(native_window_type wd)
+		{
+			int mapped = restrict::spec.cached_mapped(wd);
+			if (mapped >= 0)
+			{
+				++restrict::spec.round_trips_avoided;
+				return (0 == mapped);
+			}
+
+			XWindowAttributes attr;
+			::XGetWindowAttributes(restrict::spec.open_display(), reinterpret_cast<Window>(wd), &attr);
+			restrict::spec.cache_mapped(wd, attr.map_state != IsUnmapped);
+			return (attr.map_state == IsUnmapped);
+		}
 #endif
 
 		//platform-dependent
@@ -315,6 +348,9 @@ namespace nana{
 					exposed_positions[handle] = pos;
 				}
 
+				restrict::spec.geometry_register(reinterpret_cast<native_window_type>(handle), reinterpret_cast<native_window_type>(parent),
+												rectangle{ pos, size{ (r.width ? r.width : 1), (r.height ? r.height : 1) } });
+
 				XChangeWindowAttributes(disp, handle, attr_mask, &win_attr);
 
 				XTextProperty name;
@@ -450,6 +486,9 @@ namespace nana{
 
 			if(handle)
 			{
+				restrict::spec.geometry_register(reinterpret_cast<native_window_type>(handle), parent,
+												rectangle{ pos, size{ (r.width ? r.width : 1), (r.height ? r.height : 1) } });
+
 				XTextProperty name;
 				char text[] = "Nana Child Window";
 				char * str = text;
@@ -560,10 +599,9 @@ namespace nana{
 			{
 				auto & img = (sml_icon.empty() ? big_icon : sml_icon);
 
-				const nana::paint::graphics & graph = restrict::spec.keep_window_icon(wd, img);
 				XWMHints hints;
 				hints.flags = IconPixmapHint;
-				hints.icon_pixmap = graph.handle()->pixmap;
+				hints.icon_pixmap = restrict::spec.keep_window_icon(wd, img);
 
 				nana::detail::platform_scope_guard psg;
 				::XSetWMHints(restrict::spec.open_display(), reinterpret_cast<Window>(wd), &hints);
@@ -673,6 +711,7 @@ namespace nana{
 					{
 						::XMoveWindow(disp, reinterpret_cast<Window>(wd), i->second.x, i->second.y);
 						exposed_positions.erase(i);
+						restrict::spec.geometry_invalidate(wd);
 					}
 					
 					Window grab = restrict::spec.grab(0);
@@ -682,6 +721,8 @@ namespace nana{
 				else
 					::XUnmapWindow(disp, reinterpret_cast<Window>(wd));
 
+				//The map state is unknown until the MapNotify/UnmapNotify arrives.
+				restrict::spec.mapped_invalidate(wd);
 				::XFlush(disp);
 			}
 			static_cast<void>(active);	//eliminate unused parameter compiler warning.
@@ -782,12 +823,22 @@ namespace nana{
 #if defined(NANA_WINDOWS)
 			return (FALSE != ::IsWindowVisible(reinterpret_cast<HWND>(wd)));
 #elif defined(NANA_X11)
+			int mapped = restrict::spec.cached_mapped(wd);
+			if (mapped >= 0)
+			{
+				++restrict::spec.round_trips_avoided;
+				return (mapped != 0);
+			}
+
 			nana::detail::platform_scope_guard psg;
 			XWindowAttributes attr;
 			restrict::spec.set_error_handler();
 			::XGetWindowAttributes(restrict::spec.open_display(), reinterpret_cast<Window>(wd), &attr);
-			return (BadWindow != restrict::spec.rev_error_handler() &&
-					attr.map_state != IsUnmapped);
+			if (BadWindow == restrict::spec.rev_error_handler())
+				return false;
+
+			restrict::spec.cache_mapped(wd, attr.map_state != IsUnmapped);
+			return (attr.map_state != IsUnmapped);
 #endif
 		}
 
@@ -853,6 +904,14 @@ namespace nana{
 				if(!coord_wd)
 					coord_wd = restrict::spec.root_window();
 			}
+
+			nana::point origin, coord_origin;
+			if (restrict::spec.cached_origin(wd, origin) && restrict::spec.cached_origin(reinterpret_cast<native_window_type>(coord_wd), coord_origin))
+			{
+				++restrict::spec.round_trips_avoided;
+				return origin - coord_origin;
+			}
+
 			Window child;
 			if(True == ::XTranslateCoordinates(restrict::spec.open_display(), reinterpret_cast<Window>(wd), coord_wd, 0, 0, &x, &y, &child))
 				return nana::point(x, y);
@@ -896,12 +955,11 @@ namespace nana{
 										x, y, &x, &y, &child);
 			}
 
-			XWindowAttributes attr;
-			::XGetWindowAttributes(disp, reinterpret_cast<Window>(wd), &attr);
-			if(attr.map_state == IsUnmapped)
+			if(is_unmapped(wd))
 				exposed_positions[reinterpret_cast<Window>(wd)] = ::nana::point{x, y};
 
 			::XMoveWindow(disp, reinterpret_cast<Window>(wd), x, y);
+			restrict::spec.geometry_invalidate(wd);
 #endif
 		}
 
@@ -961,9 +1019,7 @@ namespace nana{
 										r.x, r.y, &x, &y, &child);
 			}
 
-			XWindowAttributes attr;
-			::XGetWindowAttributes(disp, reinterpret_cast<Window>(wd), &attr);
-			if(attr.map_state == IsUnmapped)
+			if(is_unmapped(wd))
 			{
 				hints.flags |= USSize;
 				hints.width = r.width;
@@ -976,6 +1032,7 @@ namespace nana{
 				::XSetWMNormalHints(disp, reinterpret_cast<Window>(wd), &hints);
 
 			::XMoveResizeWindow(disp, reinterpret_cast<Window>(wd), x, y, r.width, r.height);
+			restrict::spec.geometry_invalidate(wd);
 			return true;
 #endif
 		}
@@ -1093,6 +1150,7 @@ namespace nana{
 				::XSetWMNormalHints(disp, reinterpret_cast<Window>(wd), &hints);
 			}
 			::XResizeWindow(disp, reinterpret_cast<Window>(wd), sz.width, sz.height);
+			restrict::spec.geometry_invalidate(wd);
 			return true;
 #endif
 		}
@@ -1107,11 +1165,17 @@ namespace nana{
 			r.width = winr.right - winr.left;
 			r.height = winr.bottom - winr.top;
 #elif defined(NANA_X11)
+			if (restrict::spec.cached_rect(wd, r))
+			{
+				++restrict::spec.round_trips_avoided;
+				return;
+			}
+
 			Window root;
-			int x, y;
 			unsigned border, depth;
 			nana::detail::platform_scope_guard psg;
-			::XGetGeometry(restrict::spec.open_display(), reinterpret_cast<Window>(wd), &root, &x, &y, &r.width, &r.height, &border, &depth);
+			if (::XGetGeometry(restrict::spec.open_display(), reinterpret_cast<Window>(wd), &root, &r.x, &r.y, &r.width, &r.height, &border, &depth))
+				restrict::spec.cache_rect(wd, r);
 #endif
 		}
 
@@ -1242,6 +1306,13 @@ namespace nana{
 #ifdef NANA_WINDOWS
 			return reinterpret_cast<native_window_type>(::GetParent(reinterpret_cast<HWND>(wd)));
 #elif defined(NANA_X11)
+			native_window_type cached;
+			if (restrict::spec.cached_parent(wd, cached))
+			{
+				++restrict::spec.round_trips_avoided;
+				return cached;
+			}
+
 			Window root;
 			Window parent;
 			Window * children;
@@ -1281,6 +1352,7 @@ namespace nana{
 			::XReparentWindow(restrict::spec.open_display(),
 				reinterpret_cast<Window>(child), reinterpret_cast<Window>(new_parent),
 				0, 0);
+			restrict::spec.geometry_reparent(child, new_parent);
 			return prev;
 #endif
 		}
@@ -1384,11 +1456,23 @@ namespace nana{
 			}
 			return false;
 #elif defined(NANA_X11)
+			nana::point origin;
+			if (restrict::spec.cached_origin(wd, origin))
+			{
+				++restrict::spec.round_trips_avoided;
+				pos += origin;
+				return true;
+			}
+
 			nana::detail::platform_scope_guard psg;
-			int x = pos.x, y = pos.y;
 			Window child;
-			return (True == ::XTranslateCoordinates(restrict::spec.open_display(),
-													reinterpret_cast<Window>(wd), restrict::spec.root_window(), x, y, &pos.x, &pos.y, &child));
+			if (True != ::XTranslateCoordinates(restrict::spec.open_display(),
+												reinterpret_cast<Window>(wd), restrict::spec.root_window(), 0, 0, &origin.x, &origin.y, &child))
+				return false;
+
+			restrict::spec.cache_origin(wd, origin);
+			pos += origin;
+			return true;
 #endif
 		}
 
@@ -1404,11 +1488,23 @@ namespace nana{
 			}
 			return false;
 #elif defined(NANA_X11)
+			nana::point origin;
+			if (restrict::spec.cached_origin(wd, origin))
+			{
+				++restrict::spec.round_trips_avoided;
+				pos -= origin;
+				return true;
+			}
+
 			nana::detail::platform_scope_guard psg;
-			int x = pos.x, y = pos.y;
 			Window child;
-			return (True == ::XTranslateCoordinates(restrict::spec.open_display(),
-													restrict::spec.root_window(), reinterpret_cast<Window>(wd), x, y, &pos.x, &pos.y, &child));
+			if (True != ::XTranslateCoordinates(restrict::spec.open_display(),
+												reinterpret_cast<Window>(wd), restrict::spec.root_window(), 0, 0, &origin.x, &origin.y, &child))
+				return false;
+
+			restrict::spec.cache_origin(wd, origin);
+			pos -= origin;
+			return true;
 #endif
 		}
 
@@ -1464,6 +1560,15 @@ namespace nana{
 #endif
 			return sz;
 		}
+
+		std::size_t native_interface::round_trips_avoided()
+		{
+#if defined(NANA_X11)
+			return restrict::spec.round_trips_avoided.load();
+#else
+			return 0;
+#endif
+		}
 	//end struct native_interface
 	}//end namespace detail
 }//end namespace nana
@@ -38,7 +38,7 @@ namespace nana
 					maproot(wd, (paint_operation::none != operation), req_refresh_children);
 				}
 				else
-					_m_paint_glass_window(wd, (paint_operation::try_refresh == operation), req_refresh_children, false, true);
+					_m_paint_glass_window(wd, (paint_operation::try_refresh == operation), req_refresh_children, false, true, nullptr);
 			}
 
 			bool window_layout::maproot(core_window_t* wd, bool have_refreshed, bool req_refresh_children)
@@ -85,7 +85,7 @@ namespace nana
 							}
 						}
 					}
-					_m_notify_glasses(wd);
+					_m_notify_glasses(wd, nullptr);
 					return true;
 				}
 				return false;
@@ -201,13 +201,19 @@ namespace nana
 				auto i = std::find(data_sect.effects_bground_windows.begin(), data_sect.effects_bground_windows.end(), wd);
 				if (i != data_sect.effects_bground_windows.end())
 				{
-					//If it has already registered, do nothing.
+					//If it has already registered, do nothing but drop the background
+					//made by the previous effect.
 					if (enabled)
+					{
+						wd->other.glass_cache.valid = false;
 						return false;
+					}
 
 					//Disable the effect.
 					data_sect.effects_bground_windows.erase(i);
 					wd->other.glass_buffer.release();
+					wd->other.glass_cache.source.release();
+					wd->other.glass_cache.valid = false;
 					return true;
 				}
 				//No such effect has registered.
@@ -225,8 +231,34 @@ namespace nana
 			//		update the glass buffer of a glass window.
 			void window_layout::make_bground(core_window_t* const wd)
 			{
-				nana::point rpos{ wd->pos_root };
 				auto & glass_buffer = wd->other.glass_buffer;
+				auto & cache = wd->other.glass_cache;
+				const rectangle r_of_wd{ wd->dimension };
+
+				//The composed background is kept for the effect that spreads pixels, so that
+				//a damaged part can be taken effect again with its surroundings.
+				if (wd->effect.bground && (wd->effect.bground->spread() > 0))
+				{
+					cache.source.make(wd->dimension);
+					_m_compose_bground(wd, cache.source, r_of_wd);
+					glass_buffer.bitblt(r_of_wd, cache.source);
+				}
+				else
+				{
+					cache.source.release();
+					_m_compose_bground(wd, glass_buffer, r_of_wd);
+				}
+
+				if (wd->effect.bground)
+					wd->effect.bground->take_effect(reinterpret_cast<window>(wd), glass_buffer);
+
+				cache.signature = _m_bground_signature(wd);
+				cache.valid = true;
+			}
+
+			void window_layout::_m_compose_bground(core_window_t* const wd, nana::paint::graphics& graph, const nana::rectangle& area)
+			{
+				nana::point rpos{ wd->pos_root };
 
 				if (category::flags::lite_widget == wd->parent->other.category)
 				{
@@ -238,9 +270,9 @@ namespace nana
 						beg = beg->parent;
 					}
 
-					glass_buffer.bitblt(::nana::rectangle{ wd->dimension }, beg->drawer.graphics, wd->pos_root - beg->pos_root);
+					graph.bitblt(area, beg->drawer.graphics, wd->pos_root - beg->pos_root + area.position());
 					
-					nana::rectangle r(wd->pos_owner, wd->dimension);
+					nana::rectangle r{ area.dimension() };
 					for (auto i = layers.rbegin(), layers_rend = layers.rend(); i != layers_rend; ++i)
 					{
 						core_window_t * pre = *i;
@@ -248,7 +280,7 @@ namespace nana
 							continue;
 
 						core_window_t * term = ((i + 1 != layers_rend) ? *(i + 1) : wd);
-						r.position(wd->pos_root - pre->pos_root);
+						r.position(wd->pos_root - pre->pos_root + area.position());
 
 						for (auto child : pre->children)
 						{
@@ -259,18 +291,18 @@ namespace nana
 							if (child->visible && overlap(r, rectangle(child->pos_owner, child->dimension), ovlp))
 							{
 								if (category::flags::lite_widget != child->other.category)
-									glass_buffer.bitblt(nana::rectangle(ovlp.x - pre->pos_owner.x, ovlp.y - pre->pos_owner.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
+									graph.bitblt(nana::rectangle(ovlp.x - pre->pos_owner.x, ovlp.y - pre->pos_owner.y, ovlp.width, ovlp.height), child->drawer.graphics, nana::point(ovlp.x - child->pos_owner.x, ovlp.y - child->pos_owner.y));
 								ovlp.x += pre->pos_root.x;
 								ovlp.y += pre->pos_root.y;
-								_m_paste_children(child, false, false, ovlp, glass_buffer, rpos);
+								_m_paste_children(child, false, false, ovlp, graph, rpos);
 							}
 						}
 					}
 				}
 				else
-					glass_buffer.bitblt(::nana::rectangle{ wd->dimension }, wd->parent->drawer.graphics, wd->pos_owner);
+					graph.bitblt(area, wd->parent->drawer.graphics, wd->pos_owner + area.position());
 
-				const rectangle r_of_wd{ wd->pos_owner, wd->dimension };
+				const rectangle r_of_wd{ wd->pos_owner + area.position(), area.dimension() };
 				for (auto child : wd->parent->children)
 				{
 					if (child->index >= wd->index)
@@ -280,16 +312,130 @@ namespace nana
 					if (child->visible && overlap(r_of_wd, rectangle{ child->pos_owner, child->dimension }, ovlp))
 					{
 						if (category::flags::lite_widget != child->other.category)
-							glass_buffer.bitblt(nana::rectangle{ ovlp.x - wd->pos_owner.x, ovlp.y - wd->pos_owner.y, ovlp.width, ovlp.height }, child->drawer.graphics, {ovlp.position() - child->pos_owner});
+							graph.bitblt(nana::rectangle{ ovlp.x - wd->pos_owner.x, ovlp.y - wd->pos_owner.y, ovlp.width, ovlp.height }, child->drawer.graphics, {ovlp.position() - child->pos_owner});
 
 						ovlp.x += wd->parent->pos_root.x;
 						ovlp.y += wd->parent->pos_root.y;
-						_m_paste_children(child, false, false, ovlp, glass_buffer, rpos);
+						_m_paste_children(child, false, false, ovlp, graph, rpos);
 					}
 				}
+			}
+
+			nana::rectangle window_layout::_m_update_bground(core_window_t* const wd, const nana::rectangle* damage)
+			{
+				auto & cache = wd->other.glass_cache;
+
+				//The background is remade entirely if the windows under the glass window are moved,
+				//resized, shown, hidden or reordered, because the uncovered areas are not reported as damage.
+				if ((!cache.valid) || (cache.signature != _m_bground_signature(wd)))
+				{
+					make_bground(wd);
+					return rectangle{ wd->dimension };
+				}
+
+				nana::rectangle dmg;
+				if ((nullptr == damage) || !overlap(*damage, rectangle{ wd->pos_root, wd->dimension }, dmg))
+					return{};
+
+				dmg.position(dmg.position() - wd->pos_root);
+
+				const int spread = (wd->effect.bground ? wd->effect.bground->spread() : 0);
+				if ((spread < 0) || (dmg.dimension() == wd->dimension) || ((spread > 0) && cache.source.empty()))
+				{
+					make_bground(wd);
+					return rectangle{ wd->dimension };
+				}
+
+				auto inflate = [wd](nana::rectangle r, int px)
+				{
+					r.x -= px;
+					r.y -= px;
+					r.width += static_cast<unsigned>(px) * 2;
+					r.height += static_cast<unsigned>(px) * 2;
+					overlap(r, rectangle{ wd->dimension }, r);
+					return r;
+				};
+
+				//A changed pixel changes the effect result within the spread, and the result
+				//within the spread is computed from the pixels within twice the spread.
+				const auto changed_r = inflate(dmg, spread);
+				const auto source_r = inflate(dmg, spread * 2);
+
+				auto & source = (spread > 0 ? cache.source : wd->other.glass_buffer);
+				_m_compose_bground(wd, source, dmg);
+
+				paint::graphics part{ source_r.dimension() };
+				part.bitblt(rectangle{ source_r.dimension() }, source, source_r.position());
 
 				if (wd->effect.bground)
-					wd->effect.bground->take_effect(reinterpret_cast<window>(wd), glass_buffer);
+					wd->effect.bground->take_effect(reinterpret_cast<window>(wd), part);
+
+				wd->other.glass_buffer.bitblt(changed_r, part, changed_r.position() - source_r.position());
+				return changed_r;
+			}
+
+			std::size_t window_layout::_m_bground_signature(core_window_t* const wd)
+			{
+				std::size_t seed = 0;
+				auto combine = [&seed](std::size_t v)
+				{
+					seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+				};
+
+				auto sign = [&combine](core_window_t* w)
+				{
+					combine(reinterpret_cast<std::size_t>(w));
+					combine(static_cast<std::size_t>(w->pos_root.x) ^ (static_cast<std::size_t>(w->pos_root.y) << 16));
+					combine(static_cast<std::size_t>(w->dimension.width) ^ (static_cast<std::size_t>(w->dimension.height) << 16));
+					combine(w->visible ? 1 : 0);
+				};
+
+				const rectangle r_of_wd{ wd->pos_root, wd->dimension };
+
+				//Signs the windows which are pasted to the glass buffer, refer to _m_compose_bground.
+				std::vector<core_window_t*> stack;
+				auto sign_below = [&](core_window_t* container, core_window_t* term)
+				{
+					for (auto child : container->children)
+					{
+						if (child->index >= term->index)
+							break;
+
+						if (!overlapped(r_of_wd, rectangle{ child->pos_root, child->dimension }))
+							continue;
+
+						sign(child);
+						if (child->visible)
+							stack.push_back(child);
+					}
+				};
+
+				sign(wd);
+				core_window_t* term = wd;
+				for (auto pre = wd->parent; pre; pre = pre->parent)
+				{
+					sign(pre);
+					sign_below(pre, term);
+					if (category::flags::lite_widget != pre->other.category)
+						break;
+					term = pre;
+				}
+
+				while (!stack.empty())
+				{
+					auto w = stack.back();
+					stack.pop_back();
+					for (auto child : w->children)
+					{
+						if ((category::flags::root == child->other.category) || !overlapped(r_of_wd, rectangle{ child->pos_root, child->dimension }))
+							continue;
+
+						sign(child);
+						if (child->visible)
+							stack.push_back(child);
+					}
+				}
+				return seed;
 			}
 
 			void window_layout::_m_paste_children(core_window_t* wd, bool have_refreshed, bool req_refresh_children, const nana::rectangle& parent_rect, nana::paint::graphics& graph, const nana::point& graph_rpos)
@@ -330,42 +476,60 @@ namespace nana
 					}
 					else
 					{
-						//Update the glass window's background if the parent have_refreshed.
-						_m_paint_glass_window(child, have_refreshed, req_refresh_children, true, false);
+						//Update the glass window's background if the parent have_refreshed, the cached background
+						//is reused if nothing under the glass window is changed.
+						_m_paint_glass_window(child, have_refreshed, req_refresh_children, true, false, ((have_refreshed || req_refresh_children) ? &parent_rect : nullptr));
 					}
 				}
 			}
 
-			void window_layout::_m_paint_glass_window(core_window_t* wd, bool is_redraw, bool is_child_refreshed, bool called_by_notify, bool notify_other)
+			void window_layout::_m_paint_glass_window(core_window_t* wd, bool is_redraw, bool is_child_refreshed, bool called_by_notify, bool notify_other, const nana::rectangle* damage)
 			{
 				//A window which has an empty graphics(and lite-widget) does not notify
-				//glass windows for updating their background.
-				if ((wd->flags.refreshing && is_redraw) || wd->drawer.graphics.empty())
+				//glass windows for updating their background. A notification from _m_notify_glasses
+				//redraws the window, it is ignored while the window is refreshing.
+				if ((wd->flags.refreshing && (is_redraw || (called_by_notify && notify_other))) || wd->drawer.graphics.empty())
 					return;
 
 				nana::rectangle vr;
 				if (read_visual_rectangle(wd, vr))
 				{
+					//The changed area of the glass window in root coordinate.
+					nana::rectangle changed;
+					bool reused = false;
 					if (is_redraw || called_by_notify)
 					{
 						//The background is made by more than calling by notification(such as redraw of parent,
 						//redraw of siblings which are covered by wd), sometimes it should be remade when an attribute
 						//of the wd is changed(such as its background color is changed).
-						if (called_by_notify || wd->flags.make_bground_declared)
+						if (wd->flags.make_bground_declared)
 						{
 							make_bground(wd);
 							wd->flags.make_bground_declared = false;
+							changed = rectangle{ wd->dimension };
 						}
+						else
+							changed = _m_update_bground(wd, (called_by_notify ? damage : nullptr));
 
-						wd->flags.refreshing = true;
-						wd->drawer.refresh();
-						wd->flags.refreshing = false;
+						if (is_redraw)
+							changed = rectangle{ wd->dimension };
+
+						if (!changed.empty())
+						{
+							wd->flags.refreshing = true;
+							wd->drawer.refresh();
+							wd->flags.refreshing = false;
+						}
+						else
+							reused = true;
+
+						changed.position(changed.position() + wd->pos_root);
 					}
 
 					auto & root_graph = *(wd->root_graph);
 					//Map root
 					root_graph.bitblt(vr, wd->drawer.graphics, nana::point(vr.x - wd->pos_root.x, vr.y - wd->pos_root.y));
-					_m_paste_children(wd, is_child_refreshed, (is_redraw || called_by_notify), vr, root_graph, nana::point());
+					_m_paste_children(wd, is_child_refreshed, !changed.empty(), vr, root_graph, nana::point());
 
 					if (wd->parent)
 					{
@@ -377,16 +541,19 @@ namespace nana
 						}
 					}
 
-					if (notify_other)
-						_m_notify_glasses(wd);
+					if (notify_other && !reused)
+						_m_notify_glasses(wd, (changed.empty() ? nullptr : &changed));
 				}
 			}
 
 			/// Notify the glass windows that are overlapped with the specified visual rectangle.
 			/// If a child window of sigwd is a glass window, it doesn't to be notified.
-			void window_layout::_m_notify_glasses(core_window_t* const sigwd)
+			void window_layout::_m_notify_glasses(core_window_t* const sigwd, const nana::rectangle* damage)
 			{
 				nana::rectangle r_of_sigwd(sigwd->pos_root, sigwd->dimension);
+				if (damage && !overlap(*damage, r_of_sigwd, r_of_sigwd))
+					return;
+
 				for (auto wd : data_sect.effects_bground_windows)
 				{
 					//Don't notify the window if both native root windows are not same(e.g. wd and sigwd have
@@ -434,7 +601,7 @@ namespace nana
 					else
 						continue;
 
-					_m_paint_glass_window(wd, true, false, true, true);
+					_m_paint_glass_window(wd, false, false, true, true, &r_of_sigwd);
 				}
 			}
 		//end class window_layout
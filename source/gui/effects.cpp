@@ -8,6 +8,11 @@ namespace nana
 		bground_interface::~bground_interface()
 		{}
 
+		int bground_interface::spread() const
+		{
+			return -1;
+		}
+
 		bground_factory_interface::~bground_factory_interface()
 		{}
 
@@ -28,6 +33,11 @@ namespace nana
 						return;
 					graph.blend(::nana::rectangle{ graph.size() }, API::bgcolor(wd), fade_rate_);
 				}
+
+				int spread() const override
+				{
+					return 0;
+				}
 			private:
 				const double fade_rate_;
 			};
@@ -44,6 +54,12 @@ namespace nana
 				{
 					graph.blur(::nana::rectangle{ graph.size() }, radius_);
 				}
+
+				int spread() const override
+				{
+					//The box blur samples the previous row, a changed pixel affects one more row than the radius.
+					return static_cast<int>(radius_) + 1;
+				}
 			private:
 				const std::size_t radius_;
 			};
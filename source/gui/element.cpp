@@ -14,6 +14,7 @@
 #include <nana/gui/detail/bedrock.hpp>
 #include <nana/gui/detail/element_store.hpp>
 #include <nana/paint/image.hpp>
+#include <list>
 #include <map>
 
 #if defined(STD_THREAD_NOT_SUPPORTED)
@@ -1093,6 +1094,7 @@ namespace nana
 			virtual ~draw_method(){}
 
 			virtual draw_method * clone() const = 0;
+			virtual bool opaque() const = 0;
 
 			virtual void paste(const nana::rectangle& from_r, graph_reference, const nana::point& dst_pos) = 0;
 			virtual void stretch(const nana::rectangle& from_r, graph_reference dst, const nana::rectangle & to_r) = 0;
@@ -1112,6 +1114,11 @@ namespace nana
 				return new draw_image(image);
 			}
 
+			bool opaque() const override
+			{
+				return !image.alpha();
+			}
+
 			void paste(const nana::rectangle& from_r, graph_reference dst, const nana::point& dst_pos) override
 			{
 				image.paste(from_r, dst, dst_pos);
@@ -1143,6 +1150,13 @@ namespace nana
 				return p;
 			}
 
+			//The graphics shares the buffer with the one which is set by the user, and it may be drawn
+			//after it is set. Therefore it is not regarded as opaque, to prevent it from being cached.
+			bool opaque() const override
+			{
+				return false;
+			}
+
 			void paste(const nana::rectangle& from_r, graph_reference dst, const nana::point& dst_pos) override
 			{
 				graph.paste(from_r, dst, dst_pos.x, dst_pos.y);
@@ -1166,6 +1180,182 @@ namespace nana
 
 			bool		stretch_all{ true };
 			unsigned	left{ 0 }, top{ 0 }, right{ 0 }, bottom{ 0 };
+
+			//Composed bitmaps of recently drawn (state, size) pairs, the most recently used is at front.
+			struct cache_item
+			{
+				element_state	state;
+				nana::size		size;
+				paint::graphics	graph;
+			};
+
+			static const std::size_t cache_capacity = 8;
+			std::list<cache_item> cache;
+
+			void invalidate()
+			{
+				cache.clear();
+			}
+
+			//A composed bitmap can replace the drawing only if the source is opaque and the
+			//nine parts cover the whole destination area.
+			bool cacheable(const nana::size& sz) const
+			{
+				if (sz.empty() || !method->opaque())
+					return false;
+
+				return stretch_all || ((left + right < sz.width) && (top + bottom < sz.height));
+			}
+
+			paint::graphics& cached(element_state state, const nana::rectangle& from_r, const nana::size& sz)
+			{
+				for (auto i = cache.begin(); i != cache.end(); ++i)
+				{
+					if (i->state == state && i->size == sz)
+					{
+						if (i != cache.begin())
+							cache.splice(cache.begin(), cache, i);
+						return cache.front().graph;
+					}
+				}
+
+				if (cache.size() >= cache_capacity)
+					cache.pop_back();
+
+				cache.emplace_front(cache_item{ state, sz, paint::graphics{ sz } });
+
+				auto & graph = cache.front().graph;
+				compose(from_r, graph, nana::rectangle{ sz });
+				return graph;
+			}
+
+			void compose(const nana::rectangle& from_r, graph_reference dst, const nana::rectangle& to_r) const
+			{
+				if (stretch_all)
+				{
+					if (from_r.width == to_r.width && from_r.height == to_r.height)
+						method->paste(from_r, dst, to_r.position());
+					else
+						method->stretch(from_r, dst, to_r);
+					return;
+				}
+
+				auto perf_from_r = from_r;
+				auto perf_to_r = to_r;
+
+				if (left + right < to_r.width)
+				{
+					nana::rectangle src_r = from_r;
+					src_r.y += static_cast<int>(top);
+					src_r.height -= top + bottom;
+
+					nana::rectangle dst_r = to_r;
+					dst_r.y += static_cast<int>(top);
+					dst_r.height -= top + bottom;
+
+					if (left)
+					{
+						src_r.width = left;
+						dst_r.width = left;
+
+						method->stretch(src_r, dst, dst_r);
+
+						perf_from_r.x += static_cast<int>(left);
+						perf_from_r.width -= left;
+						perf_to_r.x += static_cast<int>(left);
+						perf_to_r.width -= left;
+					}
+
+					if (right)
+					{
+						src_r.x += (static_cast<int>(from_r.width) - static_cast<int>(right));
+						src_r.width = right;
+
+						dst_r.x += (static_cast<int>(to_r.width) - static_cast<int>(right));
+						dst_r.width = right;
+
+						method->stretch(src_r, dst, dst_r);
+
+						perf_from_r.width -= right;
+						perf_to_r.width -= right;
+					}
+				}
+
+				if (top + bottom < to_r.height)
+				{
+					nana::rectangle src_r = from_r;
+					src_r.x += static_cast<int>(left);
+					src_r.width -= left + right;
+
+					nana::rectangle dst_r = to_r;
+					dst_r.x += static_cast<int>(left);
+					dst_r.width -= left + right;
+
+					if (top)
+					{
+						src_r.height = top;
+						dst_r.height = top;
+
+						method->stretch(src_r, dst, dst_r);
+
+						perf_from_r.y += static_cast<int>(top);
+						perf_to_r.y += static_cast<int>(top);
+					}
+
+					if (bottom)
+					{
+						src_r.y += static_cast<int>(from_r.height - bottom);
+						src_r.height = bottom;
+
+						dst_r.y += static_cast<int>(to_r.height - bottom);
+						dst_r.height = bottom;
+
+						method->stretch(src_r, dst, dst_r);
+					}
+
+					perf_from_r.height -= (top + bottom);
+					perf_to_r.height -= (top + bottom);
+				}
+
+				if (left)
+				{
+					nana::rectangle src_r = from_r;
+					src_r.width = left;
+					if (top)
+					{
+						src_r.height = top;
+						method->paste(src_r, dst, to_r.position());
+					}
+					if (bottom)
+					{
+						src_r.y += static_cast<int>(from_r.height) - static_cast<int>(bottom);
+						src_r.height = bottom;
+						method->paste(src_r, dst, nana::point(to_r.x, to_r.y + static_cast<int>(to_r.height - bottom)));
+					}
+				}
+
+				if (right)
+				{
+					const int to_x = to_r.x + int(to_r.width - right);
+
+					nana::rectangle src_r = from_r;
+					src_r.x += static_cast<int>(src_r.width) - static_cast<int>(right);
+					src_r.width = right;
+					if (top)
+					{
+						src_r.height = top;
+						method->paste(src_r, dst, nana::point(to_x, to_r.y));
+					}
+					if (bottom)
+					{
+						src_r.y += (static_cast<int>(from_r.height) - static_cast<int>(bottom));
+						src_r.height = bottom;
+						method->paste(src_r, dst, nana::point(to_x, to_r.y + int(to_r.height - bottom)));
+					}
+				}
+
+				method->stretch(perf_from_r, dst, perf_to_r);
+			}
 		};
 
 
@@ -1206,6 +1396,7 @@ namespace nana
 			delete impl_->method;
 			impl_->method = new draw_image(img);
 			impl_->vert = vertical;
+			impl_->invalidate();
 
 			if (valid_area.width && valid_area.height)
 				impl_->valid_area = valid_area;
@@ -1219,6 +1410,7 @@ namespace nana
 			delete impl_->method;
 			impl_->method = new draw_graph(graph);
 			impl_->vert = vertical;
+			impl_->invalidate();
 
 			if (valid_area.width && valid_area.height)
 				impl_->valid_area = valid_area;
@@ -1231,11 +1423,13 @@ namespace nana
 		void bground::states(const std::vector<element_state> & s)
 		{
 			impl_->states = s;
+			impl_->invalidate();
 		}
 
 		void bground::states(std::vector<element_state> && s)
 		{
 			impl_->states = std::move(s);
+			impl_->invalidate();
 		}
 
 		void bground::reset_states()
@@ -1250,6 +1444,7 @@ namespace nana
 			st.push_back(element_state::pressed);
 			st.push_back(element_state::disabled);
 			impl_->join.clear();
+			impl_->invalidate();
 		}
 
 		void bground::join(element_state target, element_state joiner)
@@ -1265,6 +1460,7 @@ namespace nana
 			impl_->bottom = bottom;
 
 			impl_->stretch_all = !(left || right || top || bottom);
+			impl_->invalidate();
 		}
 
 		//Implement the methods of bground_interface.
@@ -1301,137 +1497,19 @@ namespace nana
 				from_r.x += static_cast<int>(from_r.width * pos);
 			}
 
-			if (impl_->stretch_all)
+			if (impl_->stretch_all && from_r.width == to_r.width && from_r.height == to_r.height)
 			{
-				if (from_r.width == to_r.width && from_r.height == to_r.height)
-					method->paste(from_r, dst, to_r.position());
-				else
-					method->stretch(from_r, dst, to_r);
-
+				method->paste(from_r, dst, to_r.position());
 				return true;
 			}
 
-
-			auto perf_from_r = from_r;
-			auto perf_to_r = to_r;
-
-			const auto left = impl_->left;
-			const auto right = impl_->right;
-			const auto top = impl_->top;
-			const auto bottom = impl_->bottom;
-
-			if (left + right < to_r.width)
+			if (!impl_->cacheable(to_r.dimension()))
 			{
-				nana::rectangle src_r = from_r;
-				src_r.y += static_cast<int>(top);
-				src_r.height -= top + bottom;
-
-				nana::rectangle dst_r = to_r;
-				dst_r.y += static_cast<int>(top);
-				dst_r.height -= top + bottom;
-
-				if (left)
-				{
-					src_r.width = left;
-					dst_r.width = left;
-
-					method->stretch(src_r, dst, dst_r);
-
-					perf_from_r.x += static_cast<int>(left);
-					perf_from_r.width -= left;
-					perf_to_r.x += static_cast<int>(left);
-					perf_to_r.width -= left;
-				}
-
-				if (right)
-				{
-					src_r.x += (static_cast<int>(from_r.width) - static_cast<int>(right));
-					src_r.width = right;
-
-					dst_r.x += (static_cast<int>(to_r.width) - static_cast<int>(right));
-					dst_r.width = right;
-
-					method->stretch(src_r, dst, dst_r);
-
-					perf_from_r.width -= right;
-					perf_to_r.width -= right;
-				}
-			}
-
-			if (top + bottom < to_r.height)
-			{
-				nana::rectangle src_r = from_r;
-				src_r.x += static_cast<int>(left);
-				src_r.width -= left + right;
-
-				nana::rectangle dst_r = to_r;
-				dst_r.x += static_cast<int>(left);
-				dst_r.width -= left + right;
-
-				if (top)
-				{
-					src_r.height = top;
-					dst_r.height = top;
-
-					method->stretch(src_r, dst, dst_r);
-
-					perf_from_r.y += static_cast<int>(top);
-					perf_to_r.y += static_cast<int>(top);
-				}
-
-				if (bottom)
-				{
-					src_r.y += static_cast<int>(from_r.height - bottom);
-					src_r.height = bottom;
-
-					dst_r.y += static_cast<int>(to_r.height - bottom);
-					dst_r.height = bottom;
-
-					method->stretch(src_r, dst, dst_r);
-				}
-
-				perf_from_r.height -= (top + bottom);
-				perf_to_r.height -= (top + bottom);
-			}
-
-			if (left)
-			{
-				nana::rectangle src_r = from_r;
-				src_r.width = left;
-				if (top)
-				{
-					src_r.height = top;
-					method->paste(src_r, dst, to_r.position());
-				}
-				if (bottom)
-				{
-					src_r.y += static_cast<int>(from_r.height) - static_cast<int>(bottom);
-					src_r.height = bottom;
-					method->paste(src_r, dst, nana::point(to_r.x, to_r.y + static_cast<int>(to_r.height - bottom)));
-				}
-			}
-
-			if (right)
-			{
-				const int to_x = to_r.x + int(to_r.width - right);
-
-				nana::rectangle src_r = from_r;
-				src_r.x += static_cast<int>(src_r.width) - static_cast<int>(right);
-				src_r.width = right;
-				if (top)
-				{
-					src_r.height = top;
-					method->paste(src_r, dst, nana::point(to_x, to_r.y));
-				}
-				if (bottom)
-				{
-					src_r.y += (static_cast<int>(from_r.height) - static_cast<int>(bottom));
-					src_r.height = bottom;
-					method->paste(src_r, dst, nana::point(to_x, to_r.y + int(to_r.height - bottom)));
-				}
+				impl_->compose(from_r, dst, to_r);
+				return true;
 			}
 
-			method->stretch(perf_from_r, dst, perf_to_r);
+			impl_->cached(state, from_r, to_r.dimension()).paste(dst, to_r.x, to_r.y);
 			return true;
 		}
 		//end class bground
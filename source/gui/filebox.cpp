@@ -25,8 +25,19 @@
 	#include <nana/gui/widgets/treebox.hpp>
 	#include <nana/gui/widgets/combox.hpp>
 	#include <nana/gui/place.hpp>
+	#include <nana/gui/timer.hpp>
 	#include <stdexcept>
 	#include <algorithm>
+	#include <atomic>
+	#include <chrono>
+	#include <ctime>
+	#include <memory>
+	#include <mutex>
+	#include <set>
+	#include <thread>
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sys/stat.h>
 #endif
 
 namespace fs = std::experimental::filesystem;
@@ -122,12 +133,289 @@ namespace nana
 			}
 		};
 
-		struct pred_sort_fs
+		//Enumerates a directory on a worker thread, the entries are handed over to the GUI thread in batches.
+		//Opening a large directory or a directory on a slow mount doesn't block the dialog.
+		class directory_loader
 		{
-			bool operator()(const item_fs& a, const item_fs& b) const
+			directory_loader(const directory_loader&) = delete;
+			directory_loader& operator=(const directory_loader&) = delete;
+		public:
+			enum class status{ loading, finished, denied };
+
+			directory_loader() = default;
+
+			~directory_loader()
+			{
+				cancel();
+			}
+
+			void start(const std::string& path)
+			{
+				cancel();
+
+				auto st = std::make_shared<state>();
+				state_ = st;
+
+				//The worker only refers to the shared state, it is detached, so that a cancellation
+				//doesn't wait for a stat which is blocked by a slow mount.
+				std::thread([st, path]{
+					_m_enumerate(*st, path);
+				}).detach();
+			}
+
+			void cancel()
+			{
+				if (state_)
+				{
+					state_->cancelled = true;
+					state_.reset();
+				}
+			}
+
+			/// Moves the entries which are read since last call to the end of container.
+			status take(std::vector<item_fs>& container)
+			{
+				if (!state_)
+					return status::finished;
+
+				std::lock_guard<std::mutex> lock(state_->mutex);
+				std::move(state_->entries.begin(), state_->entries.end(), std::back_inserter(container));
+				state_->entries.clear();
+				return state_->stat;
+			}
+		private:
+			struct state
+			{
+				std::atomic<bool> cancelled{ false };
+				std::mutex mutex;
+				std::vector<item_fs> entries;
+				status stat{ status::loading };
+			};
+
+			static void _m_enumerate(state& st, const std::string& path)
+			{
+				auto dir = ::opendir(path.c_str());
+				if (nullptr == dir)
+				{
+					std::lock_guard<std::mutex> lock(st.mutex);
+					st.stat = status::denied;
+					return;
+				}
+
+				const int dir_fd = ::dirfd(dir);
+
+				std::vector<item_fs> entries;
+				auto flushed = std::chrono::steady_clock::now();
+
+				while (!st.cancelled)
+				{
+					auto dent = ::readdir(dir);
+					if (nullptr == dent)
+						break;
+
+					if ('.' == dent->d_name[0])
+						continue;
+
+					item_fs m;
+					m.name = dent->d_name;
+					m.directory = (DT_DIR == dent->d_type);
+					m.bytes = 0;
+					m.modified_time = ::tm{};
+
+					//A single stat which follows symbolic links provides the type, size and modified time.
+					struct ::stat fst;
+					if (0 == ::fstatat(dir_fd, dent->d_name, &fst, 0))
+					{
+						m.directory = S_ISDIR(fst.st_mode);
+						if (S_ISREG(fst.st_mode))
+							m.bytes = fst.st_size;
+
+						::localtime_r(&fst.st_mtime, &m.modified_time);
+					}
+
+					entries.emplace_back(std::move(m));
+
+					auto now = std::chrono::steady_clock::now();
+					if (entries.size() >= 256 || now - flushed >= std::chrono::milliseconds(20))
+					{
+						std::lock_guard<std::mutex> lock(st.mutex);
+						std::move(entries.begin(), entries.end(), std::back_inserter(st.entries));
+						entries.clear();
+						flushed = now;
+					}
+				}
+
+				::closedir(dir);
+
+				std::lock_guard<std::mutex> lock(st.mutex);
+				std::move(entries.begin(), entries.end(), std::back_inserter(st.entries));
+				st.stat = status::finished;
+			}
+		private:
+			std::shared_ptr<state> state_;
+		};
+
+		//Reads the sub-directories of directories on worker threads, for the expansions of the tree and the
+		//lists of the category path. The results are taken by the GUI thread.
+		class directory_scanner
+		{
+			directory_scanner(const directory_scanner&) = delete;
+			directory_scanner& operator=(const directory_scanner&) = delete;
+		public:
+			struct result
+			{
+				std::string key;	//The key of the scanned directory specified by the caller
+				std::vector<std::pair<std::string, bool>> directories;	//The names and whether they have a sub-directory
+				bool complete;		//Indicates whether it is the last result of the directory
+			};
+
+			directory_scanner() = default;
+
+			~directory_scanner()
+			{
+				cancel();
+			}
+
+			/// Scans the directories specified by the pairs of key and path.
+			/**
+			 * @param probe Indicates whether to test each sub-directory for a sub-directory of its own.
+			 */
+			void scan(std::vector<std::pair<std::string, std::string>> dirs, bool probe)
 			{
-				return ((a.directory != b.directory) && a.directory);
+				if (!state_)
+					state_ = std::make_shared<state>();
+
+				auto st = state_;
+				++st->running;
+
+				//The worker is detached like the loader, a cancellation doesn't wait for a slow mount.
+				std::thread([st, dirs, probe]{
+					for (auto & dir : dirs)
+					{
+						if (st->cancelled)
+							break;
+						_m_scan(*st, dir.first, dir.second, probe);
+					}
+					--st->running;
+				}).detach();
 			}
+
+			void cancel()
+			{
+				if (state_)
+				{
+					state_->cancelled = true;
+					state_.reset();
+				}
+			}
+
+			/// Moves the results which are read since last call, returns true if a scan is running.
+			bool take(std::vector<result>& results)
+			{
+				if (!state_)
+					return false;
+
+				//The running count is read before the results, so that the results of a finished scan are taken.
+				const bool running = (state_->running != 0);
+
+				std::lock_guard<std::mutex> lock(state_->mutex);
+				std::move(state_->results.begin(), state_->results.end(), std::back_inserter(results));
+				state_->results.clear();
+				return running;
+			}
+		private:
+			struct state
+			{
+				std::atomic<bool> cancelled{ false };
+				std::atomic<int> running{ 0 };
+				std::mutex mutex;
+				std::vector<result> results;
+			};
+
+			//Calls fn with the names of the sub-directories, except the hidden ones, until fn returns false. The type
+			//of an entry is taken from d_type, only an entry whose type is a symbolic link or unknown to the file system
+			//is examined by fstatat.
+			template<typename Function>
+			static void _m_enum_sub_directories(const std::string& path, Function fn)
+			{
+				auto dir = ::opendir(path.c_str());
+				if (nullptr == dir)
+					return;
+
+				const int dir_fd = ::dirfd(dir);
+				while (auto dent = ::readdir(dir))
+				{
+					if ('.' == dent->d_name[0])
+						continue;
+
+					bool is_dir = (DT_DIR == dent->d_type);
+					if (DT_LNK == dent->d_type || DT_UNKNOWN == dent->d_type)
+					{
+						struct ::stat fst;
+						is_dir = (0 == ::fstatat(dir_fd, dent->d_name, &fst, 0)) && S_ISDIR(fst.st_mode);
+					}
+
+					if (is_dir && !fn(dent->d_name))
+						break;
+				}
+
+				::closedir(dir);
+			}
+
+			static void _m_scan(state& st, const std::string& key, const std::string& path, bool probe)
+			{
+				result res;
+				res.key = key;
+				res.complete = false;
+
+				_m_enum_sub_directories(path, [&](const char* name)
+				{
+					res.directories.emplace_back(name, false);
+					return !st.cancelled;
+				});
+
+				//The probed sub-directories are handed over in batches, a directory which has many
+				//sub-directories is displayed while the rest of it is probed.
+				auto flushed = std::chrono::steady_clock::now();
+				std::size_t first = 0;
+				for (std::size_t i = 0; i < res.directories.size(); ++i)
+				{
+					if (st.cancelled)
+						return;
+
+					auto & dir = res.directories[i];
+					if (probe)
+					{
+						_m_enum_sub_directories(path + "/" + dir.first, [&dir](const char*)
+						{
+							dir.second = true;
+							return false;
+						});
+					}
+
+					auto now = std::chrono::steady_clock::now();
+					if ((i + 1 < res.directories.size()) && (now - flushed >= std::chrono::milliseconds(20)))
+					{
+						result part;
+						part.key = key;
+						part.complete = false;
+						part.directories.assign(res.directories.begin() + first, res.directories.begin() + i + 1);
+						first = i + 1;
+						flushed = now;
+
+						std::lock_guard<std::mutex> lock(st.mutex);
+						st.results.emplace_back(std::move(part));
+					}
+				}
+
+				res.directories.erase(res.directories.begin(), res.directories.begin() + first);
+				res.complete = true;
+
+				std::lock_guard<std::mutex> lock(st.mutex);
+				st.results.emplace_back(std::move(res));
+			}
+		private:
+			std::shared_ptr<state> state_;
 		};
 	public:
 		struct kind
@@ -309,6 +597,16 @@ namespace nana
 				API::close_window(handle());
 			});
 
+			loader_timer_.interval(30);
+			loader_timer_.elapse([this]{
+				_m_take_entries();
+			});
+
+			scan_timer_.interval(30);
+			scan_timer_.elapse([this]{
+				_m_take_scans();
+			});
+
 			selection_.type = kind::none;
 			_m_layout();
 			_m_init_tree();
@@ -435,27 +733,8 @@ namespace nana
 			nodes_.filesystem = tree_.insert("FS.ROOT", "Filesystem");
 			nodes_.filesystem.value(kind::filesystem);
 
-			std::vector<std::pair<std::string, treebox::item_proxy>> paths;
-			paths.emplace_back(fs_ext::path_user().native(), nodes_.home);
-			paths.emplace_back("/", nodes_.filesystem);
-
-			fs::directory_iterator end;
-			for (auto & p : paths)
-			{
-				for (fs::directory_iterator i{p.first}; i != end; ++i)
-				{
-					auto name = i->path().filename().native();
-					if (!is_directory(i->status()) || (name.size() && name[0] == '.'))
-						continue;
-
-					item_proxy node = tree_.insert(p.second, name, name);
-					if (false == node.empty())
-					{
-						node.value(kind::filesystem);
-						break;
-					}
-				}
-			}
+			_m_append_placeholder(nodes_.home);
+			_m_append_placeholder(nodes_.filesystem);
 
 			tree_.events().expanded.connect_unignorable([this](const arg_treebox& arg)
 			{
@@ -488,6 +767,59 @@ namespace nana
 			return std::string();
 		}
 
+		//Appends a placeholder child to make a directory node expandable. The sub-directories are read on
+		//the scanner when the node is expanded, and the placeholder is removed when they arrive.
+		void _m_append_placeholder(item_proxy node)
+		{
+			node.append(".", std::string{}, kind::none);
+		}
+
+		//Applies the results of the scanner to the tree and the category path.
+		void _m_take_scans()
+		{
+			std::vector<directory_scanner::result> results;
+			const bool tree_running = tree_scanner_.take(results);
+			const auto tree_results = results.size();
+			const bool cat_running = cat_scanner_.take(results);
+
+			for (std::size_t i = 0; i < tree_results; ++i)
+			{
+				auto & res = results[i];
+				auto node = tree_.find(res.key);
+				if (node.empty())
+					continue;
+
+				auto placeholder = node.child();
+				if ((!placeholder.empty()) && (kind::none == placeholder.value<kind::t>()))
+					tree_.erase(placeholder);
+
+				for (auto & dir : res.directories)
+				{
+					auto child = node.append(dir.first, dir.first, kind::filesystem);
+					if ((!child.empty()) && dir.second)
+						_m_append_placeholder(child);
+				}
+
+				if (res.complete)
+					scanning_nodes_.erase(res.key);
+			}
+
+			//The lists of the category path are applied only if the path is not changed after the scan is requested.
+			if ((results.size() > tree_results) && (path_.caption() == scanning_cat_path_))
+			{
+				for (auto i = results.begin() + tree_results; i != results.end(); ++i)
+				{
+					path_.caption(i->key);
+					for (auto & dir : i->directories)
+						path_.childset(dir.first, 0);
+				}
+				path_.caption(scanning_cat_path_);
+			}
+
+			if (!(tree_running || cat_running))
+				scan_timer_.stop();
+		}
+
 		void _m_load_path(const std::string& path)
 		{
 			addr_.filesystem = path;
@@ -495,37 +827,76 @@ namespace nana
 				addr_.filesystem += '/';
 
 			file_container_.clear();
+			listed_file_ = false;
+			unordered_ = false;
+
+			drawing{ls_file_}.clear();
+			ls_file_.clear();
+
+			loader_.start(path);
+			loader_timer_.start();
+		}
+
+		//Lists the entries which are read by the loader since last call.
+		void _m_take_entries()
+		{
+			const auto first = file_container_.size();
+			auto stat = loader_.take(file_container_);
 
-			fs::directory_iterator end;
-			for(fs::directory_iterator i(path); i != end; ++i)
+			if (first != file_container_.size())
 			{
-				auto name = i->path().filename().native();
-				if(name.empty() || (name.front() == '.'))
-					continue;
+				auto filter = filter_.caption();
+				auto ext_types = cb_types_.anyobj<std::vector<std::string> >(cb_types_.option());
 
-				auto fpath = i->path().native();
-				auto fattr = fs::status(fpath);
-				auto ftype = static_cast<fs::file_type>(fattr.type());
+				ls_file_.auto_draw(false);
+
+				auto cat = ls_file_.at(0);
+				for (auto i = file_container_.begin() + first; i != file_container_.end(); ++i)
+				{
+					if (i->directory)
+					{
+						path_.childset(i->name, 0);
+						unordered_ |= listed_file_;
+					}
+					else
+						listed_file_ = true;
 
-				item_fs m;
-				m.name = name;
-				m.directory = fs::is_directory(fattr);
+					if (_m_filter_allowed(i->name, i->directory, filter, ext_types))
+						cat.append(*i).value(*i);
+				}
 
-				if (ftype == fs::file_type::not_found ||
-					ftype == fs::file_type::unknown ||
-					ftype == fs::file_type::directory)
-					m.bytes = 0;
-				else
-					m.bytes = fs::file_size(fpath);
+				ls_file_.auto_draw(true);
+			}
 
-				fs_ext::modified_file_time(fpath, m.modified_time);
-				
-				file_container_.push_back(m);
+			if (directory_loader::status::loading == stat)
+				return;
 
-				if(m.directory)
-					path_.childset(m.name, 0);
+			loader_timer_.stop();
+
+			if (directory_loader::status::denied == stat)
+			{
+				file_container_.clear();
+
+				drawing dw{ls_file_};
+				dw.clear();
+				dw.draw([](paint::graphics& graph){
+					std::string text = "Permission denied to access the directory";
+					auto txt_sz = graph.text_extent_size(text);
+					auto sz = graph.size();
+
+					graph.string({static_cast<int>(sz.width - txt_sz.width) / 2, static_cast<int>(sz.height - txt_sz.height) / 2}, text, colors::dark_gray);
+				});
+
+				ls_file_.clear();
+			}
+			else if (unordered_)
+			{
+				//Some directories arrived after files, list the directories first.
+				std::stable_partition(file_container_.begin(), file_container_.end(), [](const item_fs& m){
+					return m.directory;
+				});
+				_m_list_fs();
 			}
-			std::sort(file_container_.begin(), file_container_.end(), pred_sort_fs());
 		}
 
 		void _m_load_cat_path(std::string path)
@@ -555,13 +926,12 @@ namespace nana
 			if(head.size() == 0 || head[head.size() - 1] != '/')
 				head += '/';
 
+			//The sub-directories of the ancestors are read by the scanner, the sub-directories of
+			//the target directory are added by the loader.
+			std::vector<std::pair<std::string, std::string>> ancestors;
+			if (head != path)
+				ancestors.emplace_back(path_.caption(), head);
 
-			fs::directory_iterator end;
-			for(fs::directory_iterator i(head); i != end; ++i)
-			{
-				if(is_directory(*i))
-					path_.childset(i->path().filename().native(), 0);
-			}
 			auto cat_path = path_.caption();
 			if(cat_path.size() && cat_path[cat_path.size() - 1] != '/')
 				cat_path += '/';
@@ -579,50 +949,24 @@ namespace nana
 				(cat_path += folder) += '/';
 				(head += folder) += '/';
 				path_.caption(cat_path);
-				
-				try
-				{
-					for(fs::directory_iterator i(head); i != end; ++i)
-					{
-						if (is_directory(*i))
-							path_.childset(i->path().filename().native(), 0);
-					}
-				}
-				catch(fs::filesystem_error&)
-				{
-					//The directory iterator may throw filesystem_error when
-					//the user doesn't have permission to access the directory.
 
-					//It just loads the sub-directories
-					//to the category path.
-				}
+				if (head != path)
+					ancestors.emplace_back(cat_path, head);
 
 				if(pos == path.npos)
 					break;
 				beg = pos + 1;
 			}
 
-			try
+			cat_scanner_.cancel();
+			scanning_cat_path_ = path_.caption();
+			if (!ancestors.empty())
 			{
-				_m_load_path(path);
-				_m_list_fs();
+				cat_scanner_.scan(std::move(ancestors), false);
+				scan_timer_.start();
 			}
-			catch(fs::filesystem_error&)
-			{
-				file_container_.clear();
 
-				drawing dw{ls_file_};
-				dw.clear();
-				dw.draw([](paint::graphics& graph){
-					std::string text = "Permission denied to access the directory";
-					auto txt_sz = graph.text_extent_size(text);
-					auto sz = graph.size();
-
-					graph.string({static_cast<int>(sz.width - txt_sz.width) / 2, static_cast<int>(sz.height - txt_sz.height) / 2}, text, colors::dark_gray);
-				});
-
-				ls_file_.clear();
-			}
+			_m_load_path(path);
 		}
 
 		bool _m_filter_allowed(const std::string& name, bool is_dir, const std::string& filter, const std::vector<std::string>* extension) const
@@ -849,46 +1193,23 @@ namespace nana
 		{
 			if(false == exp) return;
 
+			//Read the sub-directories when the node is expanded for the first time, the placeholder
+			//is kept until they arrive.
+			auto placeholder = node.child();
+			if(placeholder.empty() || (kind::none != placeholder.value<kind::t>()))
+				return;
+
 			if(kind::filesystem == node.value<kind::t>())
 			{
-				auto path = tree_.make_key_path(node, "/") + "/";
-				_m_resolute_path(path);
-
-				fs::directory_iterator end;
-				for (fs::directory_iterator i{path}; i != end; ++i)
-				{
-					auto name = i->path().filename().native();
-					if((!is_directory(*i)) || (name.size() && name[0] == '.'))
-						continue;
-
-					auto child = node.append(name, name, kind::filesystem);
-					if(!child.empty())
-					{
-						//The try-catch can be eleminated by using
-						//directory_iterator( const std::filesystem::path& p, std::error_code& ec ) noexcept;
-						//in C++17
-						try
-						{
-							for(fs::directory_iterator u(i->path()); u != end; ++u)
-							{
-								auto uname = u->path().filename().native();
-								if ((!is_directory(*u)) || (uname.size() && uname[0] == '.'))
-									continue;
+				auto key = tree_.make_key_path(node, "/");
+				if (!scanning_nodes_.insert(key).second)
+					return;
 
-								child.append(uname, uname, kind::filesystem);
-								break;
-							}
-						}
-						catch(fs::filesystem_error&)
-						{
-							//The directory iterator may throw filesystem_error when
-							//the user doesn't have permission to access the directory.
+				auto path = key + "/";
+				_m_resolute_path(path);
 
-							//Catch the error without any process, because the loop is just
-							//to peak whether the directory(i->path) has a sub-directory.
-						}
-					}
-				}
+				tree_scanner_.scan({ { key, path } }, true);
+				scan_timer_.start();
 			}
 		}
 	private:
@@ -914,6 +1235,15 @@ namespace nana
 		}nodes_;
 
 		std::vector<item_fs> file_container_;
+		directory_loader loader_;
+		timer loader_timer_;
+		directory_scanner tree_scanner_;
+		directory_scanner cat_scanner_;
+		timer scan_timer_;
+		std::set<std::string> scanning_nodes_;	//The keys of tree nodes whose sub-directories are being read
+		std::string scanning_cat_path_;			//The category path whose lists are being read
+		bool listed_file_{ false };	//Indicates whether a file is listed by the loader
+		bool unordered_{ false };	//Indicates whether a directory is listed after a file
 		struct path_rep
 		{
 			std::string filesystem;
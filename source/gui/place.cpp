@@ -636,6 +636,28 @@ namespace nana
 		//connect the field/dock with div object
 		void connect(division* start);
 		void disconnect() noexcept;
+
+		//Defers the screen updates of the window which place is bound to during a collocation, the moved
+		//widgets are composed and copied to the screen once when the collocation is finished.
+		class deferred_updates
+		{
+		public:
+			deferred_updates(window wd)
+				: window_handle_(wd), deferred_(API::dev::defer_updates(wd))
+			{}
+
+			deferred_updates(const deferred_updates&) = delete;
+			deferred_updates& operator=(const deferred_updates&) = delete;
+
+			~deferred_updates()
+			{
+				if (deferred_)
+					API::dev::end_deferred_updates(window_handle_);
+			}
+		private:
+			window const window_handle_;
+			bool const deferred_;
+		};
 	};	//end struct implement
 
 	class place::implement::field_gather
@@ -677,7 +699,8 @@ namespace nana
 			}
 		}
 
-		static event_handle erase_element(std::vector<element_t>& elements, window handle) noexcept
+		//Removes the element of the window, and marks the attached division dirty.
+		event_handle erase_element(std::vector<element_t>& elements, window handle) noexcept
 		{
 			for (auto i = elements.begin(); i != elements.end(); ++i)
 			{
@@ -685,6 +708,7 @@ namespace nana
 				{
 					auto evt_destroy = i->evt_destroy;
 					elements.erase(i);
+					_m_mark_dirty();
 					return evt_destroy;
 				}
 			}
@@ -716,6 +740,7 @@ namespace nana
 			});
 
 			(to_fasten ? &fastened : &elements)->emplace_back(wd, evt);
+			_m_mark_dirty();
 		}
 
 		field_interface& operator<<(const char* label_text) override
@@ -745,6 +770,9 @@ namespace nana
 			widgets_.emplace_back(ag.create(place_ptr_->window_handle()));
 			this->operator<<(widgets_.back()->handle());
 		}
+	public:
+		//Marks the attached division dirty, it is defined behind the definition of class division.
+		void _m_mark_dirty() noexcept;
 	public:
 		division* attached{ nullptr };
 		std::vector<std::unique_ptr<nana::widget>> widgets_;
@@ -813,11 +841,26 @@ namespace nana
 
 		std::pair<double, double> calc_weight_floor()
 		{
-			std::pair<double, double> floor;
-			run_.fit_extents.clear();
+			//The division is marked dirty if the floor or the extents of its contents are changed.
+			auto const prev_floor = run_.weight_floor;
+			auto const prev_weight = std::make_pair(weight.kind_of(), weight.real());
+			std::map<window, ::nana::size> prev_fit_extents;
+			prev_fit_extents.swap(run_.fit_extents);
 
+			std::pair<double, double> floor;
 			run_.weight_floor = floor;
 
+			_m_calc_weight_floor(floor);
+
+			if ((prev_floor != run_.weight_floor) || (prev_weight != std::make_pair(weight.kind_of(), weight.real())) || (prev_fit_extents != run_.fit_extents))
+				mark_dirty();
+
+			return floor;
+		}
+	private:
+		void _m_calc_weight_floor(std::pair<double, double>& floor)
+		{
+
 			if (this->display)
 			{
 				double ratio = 0;
@@ -946,10 +989,8 @@ namespace nana
 				run_.weight_floor = floor;
 				
 			}
-
-			return floor;
 		}
-
+	public:
 		void set_visible(bool vsb)
 		{
 			if (field)
@@ -957,6 +998,7 @@ namespace nana
 
 			_m_visible_for_child(this, vsb);
 			visible = vsb;
+			mark_dirty();
 		}
 
 		void set_display(bool dsp)
@@ -1114,9 +1156,36 @@ namespace nana
 				_m_visible_for_child(child.get(), vsb);
 			}
 		}
-		//Collocate the division and its children divisions,
+		//Collocate the division and its children divisions if the division is marked dirty or its
+		//area is changed since the last collocation. The splitters are always collocated, because
+		//they adjust the areas of their leaf divisions.
 		//The window parameter is specified for the window which the place object binded.
-		virtual void collocate(window) = 0;
+		void collocate(window wd)
+		{
+			if ((!run_.dirty) && (run_.collocated_area == field_area) && (kind::splitter != kind_of_division))
+				return;
+
+			run_.collocated_area = field_area;
+			run_.dirty = false;
+			_m_collocate(wd);
+		}
+
+		//Marks the division to be collocated again, and its ancestors which determine its area.
+		void mark_dirty() noexcept
+		{
+			for (auto div = this; div; div = div->div_owner)
+				div->run_.dirty = true;
+		}
+	protected:
+		virtual void _m_collocate(window) = 0;
+
+		//Moves a widget only if its rectangle is changed, because a move emits events and updates the window.
+		static void _m_move_window(window wd, const ::nana::rectangle& r)
+		{
+			auto current = API::window_rectangle(wd);
+			if ((!current) || (*current != r))
+				API::move_window(wd, r);
+		}
 	public:
 		kind kind_of_division;
 		bool display{ true };
@@ -1142,9 +1211,18 @@ namespace nana
 		{
 			std::pair<double, double> weight_floor;
 			std::map<window, ::nana::size> fit_extents;
+
+			::nana::rectangle collocated_area;	//The field_area of the last collocation.
+			bool dirty{ true };
 		}run_;
 	};//end class division
 
+	void place::implement::field_gather::_m_mark_dirty() noexcept
+	{
+		if (attached)
+			attached->mark_dirty();
+	}
+
 	class place::implement::div_arrange
 		: public division
 	{
@@ -1154,7 +1232,7 @@ namespace nana
 			arrange_(std::move(arr))
 		{}
 
-		void collocate(window wd) override
+		void _m_collocate(window wd) override
 		{
 			const bool vert = (kind::arrange != kind_of_division);
 
@@ -1256,7 +1334,7 @@ namespace nana
 						move_r = element_r.result();
 					}
 
-					API::move_window(el.handle, move_r);
+					_m_move_window(el.handle, move_r);
 
 					if (index + 1 < field->elements.size())
 						position += (px + calc_number(gap.at(index), area_px, 0, precise_px));
@@ -1265,7 +1343,7 @@ namespace nana
 				}
 
 				for (auto & fsn : field->fastened)
-					API::move_window(fsn.handle, area_margined);
+					_m_move_window(fsn.handle, area_margined);
 			}
 		}
 	private:
@@ -1528,7 +1606,7 @@ namespace nana
 			}
 		}
 
-		void collocate(window) override
+		void _m_collocate(window) override
 		{
 			if (!field || !(visible && display))
 				return;
@@ -1581,7 +1659,7 @@ namespace nana
 
 							unsigned width = (value > uns_block_w ? uns_block_w : value);
 							if (width > gap_size)	width -= gap_size;
-							API::move_window(i->handle, rectangle{ static_cast<int>(x), static_cast<int>(y), width, height });
+							_m_move_window(i->handle, rectangle{ static_cast<int>(x), static_cast<int>(y), width, height });
 							x += block_w;
 						}
 						y += block_h;
@@ -1641,7 +1719,7 @@ namespace nana
 							unsigned result_w = static_cast<unsigned>(precise_w);
 							precise_w -= result_w;
 
-							API::move_window(i->handle, rectangle{ pos_x, pos_y, result_w, result_h });
+							_m_move_window(i->handle, rectangle{ pos_x, pos_y, result_w, result_h });
 							++i;
 						}
 
@@ -1655,7 +1733,7 @@ namespace nana
 				API::window_size(i->handle, size{});
 
 			for (auto & fsn : field->fastened)
-				API::move_window(fsn.handle, area);
+				_m_move_window(fsn.handle, area);
 		}
 	public:
 		std::pair<unsigned, unsigned> dimension;
@@ -1721,7 +1799,7 @@ namespace nana
 			splitter_cursor_ = (horizontal ? cursor::size_we : cursor::size_ns);
 		}
 	private:
-		void collocate(window wd) override
+		void _m_collocate(window wd) override
 		{
 			if (API::is_destroying(wd))
 				return;
@@ -1796,7 +1874,14 @@ namespace nana
 						leaf_right->weight.assign_percent(imd_rate * right_px);
 
 						pause_move_collocate_ = true;
-						div_owner->collocate(splitter_.parent());
+
+						//Only the owner division is collocated again, the divisions whose areas
+						//are not changed by the drag are skipped.
+						div_owner->mark_dirty();
+						{
+							deferred_updates deferred{ impl_->window_handle };
+							div_owner->collocate(splitter_.parent());
+						}
 
 						//After the collocating, the splitter keeps the calculated weight of left division,
 						//and clear the weight of right division.
@@ -2086,7 +2171,7 @@ namespace nana
 			}
 		}
 
-		void collocate(window) override
+		void _m_collocate(window) override
 		{
 			if (!dockable_field)
 			{
@@ -2356,6 +2441,8 @@ namespace nana
 
 						pane_dv_->weight.assign_percent(double(px) / double(dock_px) * 100);
 
+						dock_dv_->mark_dirty();
+						deferred_updates deferred{ wd };
 						dock_dv_->collocate(wd);
 					}
 					else
@@ -2398,7 +2485,7 @@ namespace nana
 			return nullptr;
 		}
 
-		void collocate(window wd) override
+		void _m_collocate(window wd) override
 		{
 			auto area = this->margin_area();
 
@@ -2588,7 +2675,7 @@ namespace nana
 			//impl_(impl) 	//deprecated
 		{}
 	private:
-		void collocate(window wd) override
+		void _m_collocate(window wd) override
 		{
 			division * div = nullptr;
 			for (auto & child : children)
@@ -2638,6 +2725,8 @@ namespace nana
 			if (root_division->field_area.empty())
 				return;
 
+			deferred_updates deferred{ window_handle };
+
 			root_division->calc_weight_floor();
 
 			root_division->collocate(window_handle);
@@ -3163,6 +3252,7 @@ namespace nana
 		{
 			if (impl_->root_division)
 			{
+				implement::deferred_updates deferred{ arg.window_handle };
 				impl_->root_division->field_area.dimension({ arg.width, arg.height });
 				impl_->root_division->calc_weight_floor();
 				impl_->root_division->collocate(arg.window_handle);
@@ -3268,6 +3358,7 @@ namespace nana
 
 			modified_ptr->div_owner = div_owner;
 			modified_ptr->div_next = div_next;
+			modified_ptr->mark_dirty();
 
 			if (div_owner)
 			{
@@ -3319,6 +3410,7 @@ namespace nana
 
 				div->field = p;
 				p->attached = div;
+				div->mark_dirty();
 			}
 		}
 		return *p;
@@ -19,8 +19,19 @@
 #include <nana/gui/detail/native_window_interface.hpp>
 #include <nana/gui/widgets/widget.hpp>
 #include <nana/gui/detail/events_operation.hpp>
+#include <nana/gui/timer.hpp>
 
 #include "../../source/detail/platform_abstraction.hpp"
+#include <map>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#if defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_mutex.hpp>
+#else
+	#include <mutex>
+#endif
 
 namespace nana
 {
@@ -373,6 +384,38 @@ namespace API
 			restrict::bedrock.thread_context_lazy_refresh();
 		}
 
+		bool defer_updates(window wd)
+		{
+			auto iwd = reinterpret_cast<basic_window*>(wd);
+			internal_scope_guard lock;
+			if (!restrict::wd_manager().available(iwd))
+				return false;
+
+			//A window whose update state is 'refreshed' makes the updates of its children lazy,
+			//refer to basic_window::belong_to_lazy.
+			switch (iwd->other.upd_state)
+			{
+			case basic_window::update_state::none:
+				iwd->other.upd_state = basic_window::update_state::refreshed;
+				return true;
+			case basic_window::update_state::lazy:
+				//The window is processing an event, bedrock refreshes it when the event is finished.
+				iwd->other.upd_state = basic_window::update_state::refreshed;
+				break;
+			default:
+				break;
+			}
+			return false;
+		}
+
+		void end_deferred_updates(window wd)
+		{
+			auto iwd = reinterpret_cast<basic_window*>(wd);
+			internal_scope_guard lock;
+			if (restrict::wd_manager().available(iwd) && (basic_window::update_state::refreshed == iwd->other.upd_state))
+				restrict::wd_manager().do_lazy_refresh(iwd, true);
+		}
+
 		void draw_shortkey_underline(paint::graphics& graph, const std::string& text, wchar_t shortkey, std::size_t shortkey_position, const point& text_pos, const color& line_color)
 		{
 			if (shortkey)
@@ -664,6 +707,7 @@ namespace API
 
 	void umake_event(event_handle eh)
 	{
+		internal_scope_guard lock;
 		restrict::bedrock.evt_operation().erase(eh);
 	}
 
@@ -823,6 +867,222 @@ namespace API
 		}
 	}
 
+	//class geometry_transaction
+	struct geometry_transaction::implementation
+	{
+		struct request
+		{
+			window handle;
+			bool moved{ false };
+			bool sized{ false };
+			point pos;
+			::nana::size dimension;
+		};
+
+		std::vector<request> requests;
+		std::map<window, std::size_t> indexes;
+
+		request& at(window wd)
+		{
+			//The later requests for a window are merged into its first request.
+			auto i = indexes.find(wd);
+			if (i != indexes.end())
+				return requests[i->second];
+
+			indexes[wd] = requests.size();
+			requests.emplace_back();
+			requests.back().handle = wd;
+			return requests.back();
+		}
+
+		static rectangle join(const rectangle& a, const rectangle& b)
+		{
+			if (a.empty())
+				return b;
+			if (b.empty())
+				return a;
+
+			const int x = (std::min)(a.x, b.x);
+			const int y = (std::min)(a.y, b.y);
+			return rectangle{ x, y, static_cast<unsigned>((std::max)(a.right(), b.right()) - x), static_cast<unsigned>((std::max)(a.bottom(), b.bottom()) - y) };
+		}
+
+		static basic_window* common_ancestor(basic_window* a, basic_window* b)
+		{
+			for (; a; a = a->parent)
+			{
+				for (auto p = b; p; p = p->parent)
+				{
+					if (p == a)
+						return a;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	geometry_transaction::geometry_transaction()
+		: impl_(new implementation)
+	{}
+
+	geometry_transaction::~geometry_transaction()
+	{
+		try
+		{
+			commit();
+		}
+		catch (...)
+		{
+			//A destructor can't throw the exception thrown by an event handler.
+		}
+	}
+
+	void geometry_transaction::move(window wd, const point& pos)
+	{
+		auto & rq = impl_->at(wd);
+		rq.moved = true;
+		rq.pos = pos;
+	}
+
+	void geometry_transaction::move(window wd, const rectangle& r)
+	{
+		auto & rq = impl_->at(wd);
+		rq.moved = rq.sized = true;
+		rq.pos = r.position();
+		rq.dimension = r.dimension();
+	}
+
+	void geometry_transaction::size(window wd, const ::nana::size& sz)
+	{
+		auto & rq = impl_->at(wd);
+		rq.sized = true;
+		rq.dimension = sz;
+	}
+
+	void geometry_transaction::commit()
+	{
+		std::vector<implementation::request> requests;
+		requests.swap(impl_->requests);
+		impl_->indexes.clear();
+
+		if (requests.empty())
+			return;
+
+		internal_scope_guard lock;
+		auto & wd_manager = restrict::wd_manager();
+
+		struct change
+		{
+			basic_window* wd;
+			rectangle r;
+			rectangle damage;	//in the coordinate of root
+		};
+
+		std::vector<change> changes;
+		for (auto & rq : requests)
+		{
+			auto iwd = reinterpret_cast<basic_window*>(rq.handle);
+			if (!wd_manager.available(iwd))
+				continue;
+
+			if (category::flags::root == iwd->other.category)
+			{
+				//A root window is moved by the platform, it doesn't need to be composed.
+				if (rq.moved && rq.sized)
+					move_window(rq.handle, rectangle{ rq.pos, rq.dimension });
+				else if (rq.moved)
+					move_window(rq.handle, rq.pos);
+				else
+					window_size(rq.handle, rq.dimension);
+				continue;
+			}
+
+			rectangle r{ (rq.moved ? rq.pos : iwd->pos_owner), (rq.sized ? rq.dimension : iwd->dimension) };
+			if (r != rectangle{ iwd->pos_owner, iwd->dimension })
+				changes.push_back(change{ iwd, r, rectangle{ iwd->pos_root, iwd->dimension } });
+		}
+
+		if (changes.empty())
+			return;
+
+		//Marks the containers of the changed widgets refreshing, it stops the widgets from being copied
+		//to the root graphics and the screen while the events are emitted.
+		std::vector<basic_window*> containers;
+		for (auto & c : changes)
+		{
+			auto container = c.wd->seek_non_lite_widget_ancestor();
+			if (container && !container->flags.refreshing)
+			{
+				container->flags.refreshing = true;
+				containers.push_back(container);
+			}
+		}
+
+		auto restore = [&containers, &wd_manager]
+		{
+			for (auto container : containers)
+			{
+				if (wd_manager.available(container))
+					container->flags.refreshing = false;
+			}
+		};
+
+		try
+		{
+			for (auto & c : changes)
+			{
+				if (!wd_manager.available(c.wd))
+					continue;
+
+				if (c.r.dimension() == c.wd->dimension)
+					wd_manager.move(c.wd, c.r.x, c.r.y, false);
+				else
+					wd_manager.move(c.wd, c.r);
+
+				//The background of a glass window is recomposed at the new position.
+				if (wd_manager.available(c.wd) && c.wd->displayed() && c.wd->effect.bground)
+					wd_manager.update(c.wd, true, false);
+			}
+		}
+		catch (...)
+		{
+			restore();
+			throw;
+		}
+		restore();
+
+		//Composes the union of damage once for each native window
+		std::map<native_window_type, std::pair<basic_window*, rectangle>> updates;
+		for (auto & c : changes)
+		{
+			if (!wd_manager.available(c.wd))
+				continue;
+
+			auto container = c.wd->seek_non_lite_widget_ancestor();
+			auto damage = implementation::join(c.damage, rectangle{ c.wd->pos_root, c.wd->dimension });
+
+			auto & upd = updates[c.wd->root];
+			if (upd.first)
+			{
+				upd.first = implementation::common_ancestor(upd.first, container);
+				upd.second = implementation::join(upd.second, damage);
+			}
+			else
+				upd = std::make_pair(container, damage);
+		}
+
+		for (auto & upd : updates)
+		{
+			auto container = upd.second.first;
+			while (container && (category::flags::lite_widget == container->other.category))
+				container = container->parent;
+
+			if (container)
+				wd_manager.update(container, false, false, &upd.second.second);
+		}
+	}
+	//end class geometry_transaction
+
 	nana::optional<rectangle> window_rectangle(window wd)
 	{
 		auto iwd = reinterpret_cast<basic_window*>(wd);
@@ -913,6 +1173,219 @@ namespace API
 		restrict::wd_manager().update(reinterpret_cast<basic_window*>(wd), false, true);
 	}
 
+	namespace
+	{
+		//Executes a posted function if the window is alive. Like an event handler, it is executed under the
+		//internal lock, and the exception thrown by it doesn't escape to the native event loop.
+		void invoke_posted(window wd, const std::function<void()>& fn)
+		{
+			internal_scope_guard lock;
+			if (!fn || !restrict::wd_manager().available(reinterpret_cast<basic_window*>(wd)))
+				return;
+
+			try
+			{
+				fn();
+			}
+			catch (...)
+			{
+				//The native event loop can't recover from an exception thrown by a posted function.
+			}
+		}
+	}
+
+	namespace
+	{
+		//The targets of the posts. The native root of a window is resolved under the internal lock only for the first
+		//post, it is cached in the table so that a worker thread posts under the table mutex and doesn't contend with
+		//the painting. The entry is removed when the window is destroyed.
+		class post_table
+		{
+			//The coalesced posts are executed at most once per frame tick.
+			static constexpr std::chrono::milliseconds frame_interval{ 16 };
+
+			struct target
+			{
+				native_window_type root{ nullptr };
+				std::map<std::size_t, std::function<void()>> coalesced;	//The pending functions of post_coalesced
+				bool ticking{ false };							//A tick is posted or waits for the timer
+				std::chrono::steady_clock::time_point last_tick;
+				std::unique_ptr<timer> tick_timer;				//It is created by the thread which owns the window
+			};
+		public:
+			static post_table& instance()
+			{
+				static post_table obj;
+				return obj;
+			}
+
+			native_window_type native_root(window wd)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					auto i = targets_.find(wd);
+					if (i != targets_.end())
+						return i->second.root;
+				}
+
+				auto native = API::root(wd);
+				if (nullptr == native)
+					return nullptr;
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				auto & t = targets_[wd];
+				if (t.root)
+					return t.root;
+
+				t.root = native;
+
+				//The destroy event is connected by the thread which owns the window.
+				if (!interface_type::post(native, [wd, native]{ instance()._m_attach(wd, native); }))
+				{
+					targets_.erase(wd);
+					return nullptr;
+				}
+				return native;
+			}
+
+			bool coalesce(window wd, std::size_t key, std::function<void()>&& fn)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				auto i = targets_.find(wd);
+				if (i == targets_.end())
+					return false;
+
+				auto & t = i->second;
+				t.coalesced[key] = std::move(fn);
+				if (t.ticking)
+					return true;
+
+				if (!interface_type::post(t.root, [wd]{ instance()._m_tick(wd); }))
+				{
+					t.coalesced.erase(key);
+					return false;
+				}
+
+				t.ticking = true;
+				return true;
+			}
+		private:
+			void _m_attach(window wd, native_window_type native)
+			{
+				internal_scope_guard lock;
+				auto iwd = reinterpret_cast<basic_window*>(wd);
+				auto events = detail::get_general_events(wd);
+
+				//The handle may be reused by another window before the attachment.
+				if (events && restrict::wd_manager().available(iwd) && (iwd->root == native))
+					events->destroy.connect_unignorable([wd](const arg_destroy&){ instance()._m_erase(wd); });
+				else
+					_m_erase(wd);
+			}
+
+			void _m_erase(window wd)
+			{
+				target t;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					auto i = targets_.find(wd);
+					if (i == targets_.end())
+						return;
+
+					t = std::move(i->second);
+					targets_.erase(i);
+				}
+
+				//The pending functions and the timer are destroyed out of the table lock.
+			}
+
+			//Executes the pending coalesced functions of the window. It is executed by the thread which owns the
+			//window, and it waits for the timer if the previous tick is less than a frame ago.
+			void _m_tick(window wd)
+			{
+				std::vector<std::function<void()>> fns;
+				timer* tm = nullptr;
+				unsigned wait = 0;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					auto i = targets_.find(wd);
+					if (i == targets_.end())
+						return;
+
+					auto & t = i->second;
+					auto now = std::chrono::steady_clock::now();
+					auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - t.last_tick);
+					if (elapsed < frame_interval)
+					{
+						if (!t.tick_timer)
+						{
+							t.tick_timer.reset(new timer);
+							t.tick_timer->elapse([wd]{ instance()._m_tick(wd); });
+						}
+						wait = static_cast<unsigned>((frame_interval - elapsed).count());
+					}
+					else
+					{
+						t.last_tick = now;
+						t.ticking = false;
+						for (auto & p : t.coalesced)
+							fns.emplace_back(std::move(p.second));
+						t.coalesced.clear();
+					}
+
+					//The timer is only destroyed by this thread, it is operated out of the table lock, because
+					//the elapse event is raised under the lock of the timer driver.
+					tm = t.tick_timer.get();
+				}
+
+				if (tm)
+				{
+					if (wait)
+					{
+						tm->interval(wait);
+						tm->start();
+						return;
+					}
+					tm->stop();
+				}
+
+				for (auto & fn : fns)
+					invoke_posted(wd, fn);
+			}
+		private:
+			std::mutex mutex_;
+			std::map<window, target> targets_;
+		};
+
+		constexpr std::chrono::milliseconds post_table::frame_interval;
+	}
+
+	bool post(window wd, std::function<void()> fn)
+	{
+		if (!fn)
+			return false;
+
+		auto native = post_table::instance().native_root(wd);
+		if (nullptr == native)
+			return false;
+
+		return interface_type::post(native, [wd, fn]
+		{
+			invoke_posted(wd, fn);
+		});
+	}
+
+	bool post_coalesced(window wd, std::size_t key, std::function<void()> fn)
+	{
+		if (!fn)
+			return false;
+
+		auto & table = post_table::instance();
+		if (nullptr == table.native_root(wd))
+			return false;
+
+		return table.coalesce(wd, key, std::move(fn));
+	}
 
 	void window_caption(window wd, const std::string& title_utf8)
 	{
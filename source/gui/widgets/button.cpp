@@ -223,9 +223,8 @@ namespace nana{	namespace drawerbase
 			wchar_t shortkey;
 			std::string::size_type shortkey_pos;
 			std::string mbstr = API::transform_shortkey_text(wdg_->caption(), shortkey, &shortkey_pos);
-			std::wstring str = to_wstring(mbstr);
 
-			nana::size ts = graph.text_extent_size(str);
+			nana::size ts = graph.text_extent_size(mbstr);
 			nana::size gsize = graph.size();
 
 			nana::size icon_sz;
@@ -243,10 +242,15 @@ namespace nana{	namespace drawerbase
 				pos.x = static_cast<int>(icon_sz.width);
 
 			unsigned omitted_pixels = gsize.width - icon_sz.width;
-			std::size_t txtlen = str.size();
-			const auto txtptr = str.c_str();
+			std::size_t txtlen = mbstr.size();
+			const auto txtptr = mbstr.c_str();
 			if(ts.width)
 			{
+				//The text renderer only accepts a wide string, the conversion is only performed when the text is omitted
+				std::wstring str;
+				if (attr_.omitted)
+					str = to_wstring(mbstr);
+
 				nana::paint::text_renderer tr(graph);
 				if(enabled)
 				{
@@ -260,7 +264,7 @@ namespace nana{	namespace drawerbase
 					graph.palette(true, text_color);
 
 					if (attr_.omitted)
-						tr.render(pos, txtptr, txtlen, omitted_pixels, true);
+						tr.render(pos, str.c_str(), str.size(), omitted_pixels, true);
 					else
 						graph.bidi_string(pos, txtptr, txtlen);
 
@@ -271,9 +275,9 @@ namespace nana{	namespace drawerbase
 					graph.palette(true, color{ colors::white });
 					if(attr_.omitted)
 					{
-						tr.render(point{ pos.x + 1, pos.y + 1 }, txtptr, txtlen, omitted_pixels, true);
+						tr.render(point{ pos.x + 1, pos.y + 1 }, str.c_str(), str.size(), omitted_pixels, true);
 						graph.palette(true, color{ colors::gray });
-						tr.render(pos, txtptr, txtlen, omitted_pixels, true);
+						tr.render(pos, str.c_str(), str.size(), omitted_pixels, true);
 					}
 					else
 					{
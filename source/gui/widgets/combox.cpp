@@ -21,6 +21,9 @@
 
 #include <iterator>
 #include <algorithm>
+#include <map>
+#include <typeindex>
+#include <cctype>
 
 namespace nana
 {
@@ -31,22 +34,22 @@ namespace nana
 	{
 		namespace combox
 		{
+			class drawer_impl;
+
 			class event_agent
 				: public widgets::skeletons::textbase_event_agent_interface
 			{
 			public:
-				event_agent(::nana::combox& wdg)
-					: widget_(wdg)
+				event_agent(::nana::combox& wdg, drawer_impl* drwimpl)
+					: widget_(wdg), drw_(drwimpl)
 				{}
 
 				void first_change() override{}	//empty, because combox does not have this event.
 
-				void text_changed() override
-				{
-					widget_.events().text_changed.emit(::nana::arg_combox{ widget_ }, widget_);
-				}
+				void text_changed() override;
 			private:
 				::nana::combox & widget_;
+				drawer_impl* const drw_;
 			};
 
 			struct item
@@ -54,11 +57,14 @@ namespace nana
 			{
 			public:
 				std::shared_ptr<nana::detail::key_interface> key;
+				std::size_t		pos{ 0 };	//The position of the item, it is used by the key index
 
 				nana::paint::image	item_image;
 				std::string		item_text;
 				mutable std::shared_ptr<nana::any>	any_ptr;
 
+				mutable nana::size	text_extent;	//The cached size of item_text, it is empty if the text is not measured.
+
 				item(std::shared_ptr<nana::detail::key_interface> && kv)
 					: key(std::move(kv))
 				{
@@ -96,14 +102,20 @@ namespace nana
 						if (limit_pixels)
 							return{};
 
+						//The cached extents are invalid if the font is changed.
+						bool font_changed = (graph.typeface() != font_);
+						if (font_changed)
+							font_ = graph.typeface();
+
 						size content_size;
 						for (std::size_t i = 0; i < drw_->the_number_of_options(); ++i)
 						{
 							auto & m = drw_->at(i);
-							auto sz = graph.text_extent_size(m.item_text);
+							if (font_changed || m.text_extent.empty())
+								m.text_extent = graph.text_extent_size(m.item_text);
 
-							content_size.width = (std::max)(content_size.width, sz.width);
-							content_size.height = (std::max)(content_size.height, sz.height);
+							content_size.width = (std::max)(content_size.width, m.text_extent.width);
+							content_size.height = (std::max)(content_size.height, m.text_extent.height);
 						}
 
 						return content_size;
@@ -115,6 +127,20 @@ namespace nana
 					}
 				private:
 					drawer_impl* const drw_;
+					mutable paint::font font_;
+				};
+
+				//Orders the keys by their types first, because the keys of different types are not comparable.
+				struct key_less
+				{
+					bool operator()(const nana::detail::key_interface* lhs, const nana::detail::key_interface* rhs) const
+					{
+						std::type_index lhs_type{ typeid(*lhs) }, rhs_type{ typeid(*rhs) };
+						if (lhs_type != rhs_type)
+							return lhs_type < rhs_type;
+
+						return lhs->compare(rhs);
+					}
 				};
 			public:
 				using graph_reference = paint::graphics&;
@@ -148,7 +174,7 @@ namespace nana
 					editable(false);
 					graph_ = &graph;
 
-					evt_agent_.reset(new event_agent{ static_cast<nana::combox&>(wd) });
+					evt_agent_.reset(new event_agent{ static_cast<nana::combox&>(wd), this });
 					editor_->textbase().set_event_agent(evt_agent_.get());
 
 					API::dev::set_measurer(wd, measurer_.get());
@@ -164,6 +190,8 @@ namespace nana
 				void insert(std::string&& text)
 				{
 					items_.emplace_back(std::make_shared<item>(std::move(text)));
+					items_.back()->pos = items_.size() - 1;
+					module_outdated_ = true;
 					API::refresh_window(widget_->handle());
 				}
 
@@ -191,8 +219,12 @@ namespace nana
 				void clear()
 				{
 					items_.clear();
+					key_index_.clear();
 					module_.items.clear();
+					module_.view.clear();
+					module_.filtered = false;
 					module_.index = nana::npos;
+					module_outdated_ = false;
 				}
 
 				void editable(bool enb)
@@ -284,8 +316,17 @@ namespace nana
 				{
 					if((nullptr == state_.lister) && !items_.empty() && (!editor_->attr().editable || (parts::push_button == state_.pointer_where)))
 					{
-						module_.items.clear();
-						std::copy(items_.cbegin(), items_.cend(), std::back_inserter(module_.items));
+						//The module is rebuilt only if the items are inserted or erased since the last time.
+						if (module_outdated_)
+						{
+							module_.items.clear();
+							std::copy(items_.cbegin(), items_.cend(), std::back_inserter(module_.items));
+							module_outdated_ = false;
+						}
+						module_.view.clear();
+						module_.filtered = false;
+						state_.filter.clear();
+
 						state_.lister = &form_loader<nana::float_listbox, false>()(widget_->handle(), nana::rectangle(0, widget_->size().height, widget_->size().width, 10), true);
 						state_.lister->renderer(item_renderer_);
 						state_.lister->set_module(module_, image_pixels_);
@@ -399,17 +440,18 @@ namespace nana
 
 				std::size_t at_key(std::shared_ptr<nana::detail::key_interface>&& p)
 				{
-					std::size_t pos = 0;
-					for (auto & m : items_)
-					{
-						if (m->key && detail::pred_equal(m->key.get(), p.get()))
-							return pos;
-						++pos;
-					}
+					auto i = key_index_.find(p.get());
+					if (i != key_index_.end())
+						return i->second->pos;
 
-					pos = items_.size();
+					auto pos = items_.size();
 					items_.emplace_back(std::make_shared<item>(std::move(p)));
 
+					auto & m = items_.back();
+					m->pos = pos;
+					key_index_.emplace(m->key.get(), m.get());
+					module_outdated_ = true;
+
 					//Redraw, because the state of push button is changed when a first new item is created.
 					if (0 == pos)
 						API::refresh_window(*widget_);
@@ -419,16 +461,9 @@ namespace nana
 
 				void erase(detail::key_interface * kv)
 				{
-					std::size_t pos = 0;
-					for (auto & m : items_)
-					{
-						if (m->key && detail::pred_equal(m->key.get(), kv))
-						{
-							erase(pos);
-							return;
-						}
-						++pos;
-					}
+					auto i = key_index_.find(kv);
+					if (i != key_index_.end())
+						erase(i->second->pos);
 				}
 
 				item& at(std::size_t pos)
@@ -454,7 +489,14 @@ namespace nana
 					else if ((::nana::npos != module_.index) && (pos < module_.index))
 						--module_.index;
 
+					if (items_[pos]->key)
+						key_index_.erase(items_[pos]->key.get());
+
 					items_.erase(items_.begin() + pos);
+					for (auto i = items_.begin() + pos; i != items_.end(); ++i)
+						--((*i)->pos);
+
+					module_outdated_ = true;
 
 					//Redraw, because the state of push button is changed when the last item is removed.
 					if (items_.empty())
@@ -482,7 +524,68 @@ namespace nana
 					image_pixels_ = px;
 					return true;
 				}
+
+				/// Narrows the items of the opened lister to the items which contain the text of editor.
+				void filter()
+				{
+					if (!(state_.lister && editable()))
+						return;
+
+					auto text = to_utf8(editor_->text());
+
+					if (text.empty())
+					{
+						if (!module_.filtered)
+							return;
+
+						module_.view.clear();
+						module_.filtered = false;
+					}
+					else
+					{
+						std::vector<std::size_t> view;
+
+						//The items matched by the extended text are a subset of the items matched by the previous text,
+						//therefore only the items in the current view are tested.
+						if (module_.filtered && (text.find(state_.filter) != text.npos))
+						{
+							for (auto pos : module_.view)
+							{
+								if (_m_contains(_m_module_item(pos).item_text, text))
+									view.push_back(pos);
+							}
+						}
+						else
+						{
+							for (std::size_t pos = 0; pos < module_.items.size(); ++pos)
+							{
+								if (_m_contains(_m_module_item(pos).item_text, text))
+									view.push_back(pos);
+							}
+						}
+
+						module_.view.swap(view);
+						module_.filtered = true;
+					}
+
+					state_.filter = std::move(text);
+					state_.lister->update_module();
+				}
 			private:
+				const item& _m_module_item(std::size_t pos) const
+				{
+					return static_cast<const item&>(*module_.items[pos]);
+				}
+
+				//Case-insensitive substring test, only the ASCII characters are folded.
+				static bool _m_contains(const std::string& text, const std::string& pattern)
+				{
+					return (text.cend() != std::search(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend(), [](char a, char b)
+					{
+						return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+					}));
+				}
+
 				void _m_text_area(const nana::size& s)
 				{
 					auto extension = measurer_->extension();
@@ -572,7 +675,9 @@ namespace nana
 				}
 			private:
 				std::vector<std::shared_ptr<item>> items_;
+				std::map<const nana::detail::key_interface*, item*, key_less> key_index_;
 				nana::float_listbox::module_type module_;
+				bool module_outdated_{ false };	//Indicates the items are inserted or erased since the module was built
 				::nana::combox * widget_{ nullptr };
 				nana::paint::graphics * graph_{ nullptr };
 				drawerbase::float_listbox::item_renderer* item_renderer_{ nullptr };
@@ -591,11 +696,20 @@ namespace nana
 
 					nana::float_listbox * lister;
 					std::size_t	item_index_before_selection;
+					std::string filter;		//The text which filters the items of the lister
 				}state_;
 
 
 			}; //end class drawer_impl
 
+			//class event_agent
+				void event_agent::text_changed()
+				{
+					drw_->filter();
+					widget_.events().text_changed.emit(::nana::arg_combox{ widget_ }, widget_);
+				}
+			//end class event_agent
+
 
 			//class trigger
 			trigger::trigger() :
@@ -789,7 +903,9 @@ namespace nana
 				item_proxy& item_proxy::text(const ::std::string& s)
 				{
 					throw_not_utf8(s);
-					impl_->at(pos_).item_text = s;
+					auto & m = impl_->at(pos_);
+					m.item_text = s;
+					m.text_extent = {};
 					return *this;
 				}
 
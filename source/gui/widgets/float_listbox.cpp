@@ -16,6 +16,8 @@
 #include <nana/gui/layout_utility.hpp>
 #include <nana/gui/screen.hpp>
 
+#include <algorithm>
+
 namespace nana
 {
 	namespace drawerbase{
@@ -127,7 +129,7 @@ namespace nana
 					}
 					else 
 					{
-						if ((before_change + module_->max_items) < module_->items.size())
+						if ((before_change + module_->max_items) < _m_count())
 							++(state_.offset_y);
 					}
 
@@ -141,14 +143,15 @@ namespace nana
 
 				void move_items(bool upwards, bool recycle)
 				{
-					if(module_ && module_->items.size())
+					const auto count = (module_ ? _m_count() : 0);
+					if(count)
 					{
 						std::size_t init_index = state_.index;
 						if(state_.index != npos)
 						{
 							unsigned last_offset_y = 0;
-							if(module_->items.size() > module_->max_items)
-								last_offset_y = static_cast<unsigned>(module_->items.size() - module_->max_items);
+							if(count > module_->max_items)
+								last_offset_y = static_cast<unsigned>(count - module_->max_items);
 
 							if(upwards)
 							{
@@ -156,7 +159,7 @@ namespace nana
 									--(state_.index);
 								else if(recycle)
 								{
-									state_.index = module_->items.size() - 1;
+									state_.index = count - 1;
 									state_.offset_y = last_offset_y;
 								}
 
@@ -165,7 +168,7 @@ namespace nana
 							}
 							else
 							{
-								if(state_.index < module_->items.size() - 1)
+								if(state_.index < count - 1)
 									++(state_.index);
 								else if(recycle)
 								{
@@ -219,7 +222,7 @@ namespace nana
 					if(module_)
 					{
 						
-						auto const items = (module_->max_items <= module_->items.size() ? module_->max_items : module_->items.size());
+						auto const items = (std::min)(module_->max_items, _m_count());
 
 						rectangle list_r{
 							0, 0,
@@ -269,13 +272,25 @@ namespace nana
 						md.index = npos;
 
 					image_pixels_ = pixels;
+					image_enabled_ = _m_image_enabled();
+				}
+
+				void update_module()
+				{
+					clear_state();
+
+					if (!scrollbar_.empty())
+					{
+						scrollbar_.amount(_m_count());
+						scrollbar_.value(0);
+					}
 				}
 
 				void set_result()
 				{
 					if(module_)
 					{
-						module_->index = state_.index;
+						module_->index = (module_->filtered && (state_.index < module_->view.size()) ? module_->view[state_.index] : state_.index);
 						module_->have_selected = true;
 					}
 				}
@@ -292,7 +307,7 @@ namespace nana
 					if(this->right_area(graph, x, y))
 					{
 						const unsigned n = (y - 2) / state_.renderer->item_pixels(graph) + static_cast<unsigned>(state_.offset_y);
-						if(n != state_.index)
+						if((n != state_.index) && (n < _m_count()))
 						{
 							state_.index = n;
 							return true;
@@ -305,24 +320,25 @@ namespace nana
 				{
 					if(module_)
 					{
-						bool pages = (module_->max_items < module_->items.size());
+						const auto count = _m_count();
+						bool pages = (module_->max_items < count);
 						const unsigned outter_w = (pages ? 20 : 4);
 
 						if(graph_->width() > outter_w && graph_->height() > 4 )
 						{
 							//Draw items
-							std::size_t items = (pages ? module_->max_items : module_->items.size());							
+							std::size_t items = (pages ? module_->max_items : count);
 							items += state_.offset_y;
 
 							const unsigned item_pixels = state_.renderer->item_pixels(*graph_);
 							nana::rectangle item_r(2, 2, graph_->width() - outter_w, item_pixels);
 
-							state_.renderer->image(_m_image_enabled(), image_pixels_);
+							state_.renderer->image(image_enabled_, image_pixels_);
 							for(std::size_t i = state_.offset_y; i < items; ++i)
 							{
 								auto state = (i != state_.index ? item_renderer::StateNone : item_renderer::StateHighlighted);
 
-								state_.renderer->render(*widget_, *graph_, item_r, module_->items[i].get(), state);
+								state_.renderer->render(*widget_, *graph_, item_r, _m_item(i), state);
 								item_r.y += item_pixels;
 							}
 						}	
@@ -336,6 +352,17 @@ namespace nana
 					graph_->rectangle(nana::rectangle(graph_->size()).pare_off(1), false, colors::white);
 				}
 			private:
+				//Returns the number of the displayed items
+				std::size_t _m_count() const
+				{
+					return (module_->filtered ? module_->view.size() : module_->items.size());
+				}
+
+				const item_interface* _m_item(std::size_t pos) const
+				{
+					return module_->items[module_->filtered ? module_->view[pos] : pos].get();
+				}
+
 				bool _m_image_enabled() const
 				{
 					for(auto & i : module_->items)
@@ -357,7 +384,7 @@ namespace nana
 					if(scrollbar_.empty() && module_)
 					{
 						scrollbar_.create(wd, rectangle(static_cast<int>(wd.size().width - 18), 2, 16, wd.size().height - 4));
-						scrollbar_.amount(module_->items.size());
+						scrollbar_.amount(_m_count());
 						scrollbar_.range(module_->max_items);
 						scrollbar_.value(state_.offset_y);
 
@@ -384,6 +411,7 @@ namespace nana
 				widget * widget_{nullptr};
 				nana::paint::graphics * graph_{nullptr};
 				unsigned image_pixels_{16};		//Define the width pixels of the image area
+				bool image_enabled_{ false };
 
 				bool ignore_first_mouseup_{true};
 				struct state_type
@@ -490,6 +518,14 @@ namespace nana
 			show();
 		}
 
+		void float_listbox::update_module()
+		{
+			auto & impl = get_drawer_trigger().get_drawer_impl();
+			impl.update_module();
+			impl.resize();
+			API::refresh_window(handle());
+		}
+
 		void float_listbox::scroll_items(bool upwards)
 		{
 			get_drawer_trigger().get_drawer_impl().scroll_items(upwards);
@@ -18,6 +18,7 @@
 #include <nana/unicode_bidi.hpp>
 #include <nana/system/platform.hpp>
 #include <stdexcept>
+#include <map>
 #include <sstream>
 
 namespace nana
@@ -35,7 +36,23 @@ namespace nana
 					int x_base;				//The x position where this line starts.
 					std::size_t pixels;
 					std::size_t baseline;	//The baseline for drawing text.
-					std::vector<iterator> values;	//line values
+					std::size_t begin;		//The range of line values in arrangement::values
+					std::size_t end;
+				};
+
+				//The line boxes of the text in a specified width. The arrangement is kept until the text,
+				//the font or the width is changed, so that a refresh only draws the text.
+				struct arrangement
+				{
+					bool valid{ false };
+					unsigned allowed_width{ 0 };
+					align text_align{ align::left };
+
+					std::vector<iterator> values;		//The values of all line boxes.
+					std::vector<pixel_tag> pixels;		//The line boxes of all lines.
+					std::vector<std::size_t> line_ends;	//The end of line boxes for each line.
+					std::size_t extent_v_pixels{ 0 };	//The pixels, in height, of all lines.
+					unsigned extent_h_pixels{ 0 };		//The pixels of the widest line.
 				};
 
 				//this is a helper variable, it just keeps the status while drawing.
@@ -46,7 +63,6 @@ namespace nana
 					align_v text_align_v;
 
 					nana::point pos;
-					std::vector<pixel_tag> pixels;
 					std::size_t index;
 				};
 
@@ -66,6 +82,7 @@ namespace nana
 				void parse(const std::wstring& s)
 				{
 					dstream_.parse(s, format_enabled_);
+					_m_invalidate();
 				}
 
 				bool format(bool fm)
@@ -83,41 +100,22 @@ namespace nana
 
 					auto pre_font = graph.typeface();	//used for restoring the font
 
-					const unsigned def_line_pixels = graph.text_extent_size(L" ", 1).height;
-
 					font_ = pre_font;
 					fblock_ = nullptr;
 
 					_m_set_default(pre_font, fgcolor);
 
-					_m_measure(graph);
+					auto & arr = _m_arrange(graph, graph.size().width, th);
 
 					render_status rs;
 
-					rs.allowed_width = graph.size().width;
+					rs.allowed_width = arr.allowed_width;
 					rs.text_align = th;
 					rs.text_align_v = tv;
 
-					std::deque<std::vector<pixel_tag> > pixel_lines;
-
-					std::size_t extent_v_pixels = 0;	//the pixels, in height, that text will be painted.
-
-					for (auto & line : dstream_)
-					{
-						_m_line_pixels(line, def_line_pixels, rs);
-
-						for (auto & m : rs.pixels)
-							extent_v_pixels += m.pixels;
-
-						pixel_lines.emplace_back(std::move(rs.pixels));
-
-						if(extent_v_pixels >= graph.height())
-							break;
-					}
-
-					if((tv != align_v::top) && extent_v_pixels < graph.height())
+					if((tv != align_v::top) && arr.extent_v_pixels < graph.height())
 					{
-						rs.pos.y = static_cast<int>(graph.height() - extent_v_pixels);
+						rs.pos.y = static_cast<int>(graph.height() - arr.extent_v_pixels);
 
 						if(align_v::center == tv)
 							rs.pos.y >>= 1;
@@ -125,25 +123,24 @@ namespace nana
 					else
 						rs.pos.y = 0;
 
-					auto pixels_iterator = pixel_lines.begin();
-
-					for (auto & line : dstream_)
+					std::size_t line_begin = 0;
+					for (auto line_end : arr.line_ends)
 					{
 						if (rs.pos.y >= static_cast<int>(graph.height()))
 							break;
 
-						rs.index = 0;
-						rs.pixels.clear();
+						if (line_begin == line_end)
+							continue;
 
-						rs.pixels.swap(*pixels_iterator++);
-
-						rs.pos.x = rs.pixels.front().x_base;
+						rs.index = line_begin;
+						rs.pos.x = arr.pixels[line_begin].x_base;
 
 						//Stop drawing when it goes out of range.
-						if(false == _m_each_line(graph, line, rs))
+						if(false == _m_each_line(graph, arr, line_end, rs))
 							break;
 
-						rs.pos.y += static_cast<int>(rs.pixels.back().pixels);
+						rs.pos.y += static_cast<int>(arr.pixels[line_end - 1].pixels);
+						line_begin = line_end;
 					}
 
 					graph.typeface(pre_font);
@@ -164,44 +161,86 @@ namespace nana
 					return false;
 				}
 
-				::nana::size measure(graph_reference graph, unsigned limited, align th, align_v tv)
+				::nana::size measure(graph_reference graph, unsigned limited, align th, align_v /*tv*/)
 				{
-					::nana::size retsize;
-
 					auto ft = graph.typeface();	//used for restoring the font
 
-					const unsigned def_line_pixels = graph.text_extent_size(L" ", 1).height;
-
 					font_ = ft;
 					fblock_ = nullptr;
 
 					_m_set_default(ft, colors::black);
+
 					_m_measure(graph);
 
-					render_status rs;
+					//The measurement doesn't replace the arrangement for rendering, because the
+					//widget is usually measured in a width which is different from its own.
+					const arrangement * arr = &arrangement_;
+					if (!(arrangement_.valid && (limited == arrangement_.allowed_width) && (th == arrangement_.text_align)))
+					{
+						if (!(measurement_.valid && (limited == measurement_.allowed_width) && (th == measurement_.text_align)))
+							_m_arrange_lines(graph, limited, th, measurement_);
+						arr = &measurement_;
+					}
 
-					rs.allowed_width = limited;
-					rs.text_align = th;
-					rs.text_align_v = tv;
+					::nana::size retsize{ arr->extent_h_pixels, static_cast<unsigned>(arr->extent_v_pixels) };
+					if (limited && (retsize.width > limited))
+						retsize.width = limited;
+
+					return retsize;
+				}
+			private:
+				void _m_invalidate() noexcept
+				{
+					measured_ = false;
+					arrangement_.valid = false;
+					measurement_.valid = false;
+					fonts_.clear();
+				}
+
+				//Returns the arrangement of text in a specified width, it is rebuilt if the text, font or width is changed.
+				const arrangement& _m_arrange(graph_reference graph, unsigned allowed_width, align th)
+				{
+					_m_measure(graph);
 
-					for(auto & line: dstream_)
+					if (!(arrangement_.valid && (allowed_width == arrangement_.allowed_width) && (th == arrangement_.text_align)))
 					{
-						rs.pixels.clear();
-						unsigned w = _m_line_pixels(line, def_line_pixels, rs);
+						if (measurement_.valid && (allowed_width == measurement_.allowed_width) && (th == measurement_.text_align))
+							std::swap(arrangement_, measurement_);
+						else
+							_m_arrange_lines(graph, allowed_width, th, arrangement_);
+					}
+
+					return arrangement_;
+				}
+
+				void _m_arrange_lines(graph_reference graph, unsigned allowed_width, align th, arrangement& arr)
+				{
+					const unsigned def_line_pixels = graph.text_extent_size(L" ", 1).height;
 
-						if(limited && (w > limited))
-							w = limited;
+					arr.allowed_width = allowed_width;
+					arr.text_align = th;
+					arr.values.clear();
+					arr.pixels.clear();
+					arr.line_ends.clear();
+					arr.extent_v_pixels = 0;
+					arr.extent_h_pixels = 0;
 
-						if(retsize.width < w)
-							retsize.width = w;
+					for (auto & line : dstream_)
+					{
+						auto const first = arr.pixels.size();
+						unsigned w = _m_line_pixels(line, def_line_pixels, arr);
+						arr.line_ends.push_back(arr.pixels.size());
 
-						for (auto & px : rs.pixels)
-							retsize.height += static_cast<unsigned>(px.pixels);
+						if (arr.extent_h_pixels < w)
+							arr.extent_h_pixels = w;
+
+						for (auto i = first; i < arr.pixels.size(); ++i)
+							arr.extent_v_pixels += arr.pixels[i].pixels;
 					}
 
-					return retsize;
+					arr.valid = true;
 				}
-			private:
+
 				//Manage the fblock for a specified rectangle if it is a traceable fblock.
 				void _m_insert_if_traceable(int x, int y, const nana::size& sz, widgets::skeletons::fblock* fbp)
 				{
@@ -279,18 +318,32 @@ namespace nana
 
 						if((fontsize != font_.size()) || bold != font_.bold() || name != font_.name())
 						{
-							paint::font::font_style fs;
-							fs.weight = (bold ? 800 : 400);
-							font_ = paint::font{ name, fontsize, fs };
+							//The fonts of blocks are kept for the next refresh, they are created only when
+							//the text or the default font is changed.
+							auto i = fonts_.find(fp);
+							if (i == fonts_.end())
+							{
+								paint::font::font_style fs;
+								fs.weight = (bold ? 800 : 400);
+								i = fonts_.emplace(fp, paint::font{ name, fontsize, fs }).first;
+							}
+							font_ = i->second;
 							graph.typeface(font_);
 						}
 						fblock_ = fp;
 					}
 				}
 
+				//Measures the values of text. The result is kept until the text or the default font is changed.
 				void _m_measure(graph_reference graph)
 				{
 					nana::paint::font ft = font_;
+					if (measured_ && (ft == measured_font_))
+						return;
+
+					if (measured_)
+						_m_invalidate();
+
 					for (auto & line : dstream_)
 					{
 						for (auto & value : line)
@@ -305,25 +358,28 @@ namespace nana
 						graph.typeface(ft);
 						fblock_ = nullptr;
 					}
+
+					measured_font_ = ft;
+					measured_ = true;
 				}
 
-				void _m_align_x_base(const render_status& rs, pixel_tag & px, unsigned w) noexcept
+				static void _m_align_x_base(const arrangement& arr, pixel_tag & px, unsigned w) noexcept
 				{
-					switch(rs.text_align)
+					switch(arr.text_align)
 					{
 					case align::left:
 						px.x_base = 0;
 						break;
 					case align::center:
-						px.x_base = (static_cast<int>(rs.allowed_width - w) >> 1);
+						px.x_base = (static_cast<int>(arr.allowed_width - w) >> 1);
 						break;
 					case align::right:
-						px.x_base = static_cast<int>(rs.allowed_width - w);
+						px.x_base = static_cast<int>(arr.allowed_width - w);
 						break;
 					}
 				}
 
-				unsigned _m_line_pixels(dstream::linecontainer& line, unsigned def_line_pixels, render_status & rs)
+				unsigned _m_line_pixels(dstream::linecontainer& line, unsigned def_line_pixels, arrangement & arr)
 				{
 					if (line.empty())
 					{
@@ -331,8 +387,9 @@ namespace nana
 						px.baseline = 0;
 						px.pixels = def_line_pixels;
 						px.x_base = 0;
+						px.begin = px.end = arr.values.size();
 
-						rs.pixels.emplace_back(px);
+						arr.pixels.emplace_back(px);
 
 						return 0;
 					}
@@ -345,7 +402,8 @@ namespace nana
 
 					//Bidi reorder is requried here
 
-					std::vector<iterator> line_values;
+					//The begin of values of current line box
+					std::size_t line_values = arr.values.size();
 
 					for(auto i = line.begin(); i != line.end(); ++i)
 					{
@@ -369,19 +427,19 @@ namespace nana
 						}
 
 						//Check if the content is displayed in a new line.
-						if((0 == rs.allowed_width) || (w + sz.width <= rs.allowed_width))
+						if((0 == arr.allowed_width) || (w + sz.width <= arr.allowed_width))
 						{
 							w += sz.width;
 
 							if(max_ascent < as)		max_ascent = as;
 							if(max_descent < ds)	max_descent = ds;
 							if(max_px < sz.height)	max_px = sz.height;
-							line_values.emplace_back(i);
+							arr.values.emplace_back(i);
 						}
 						else
 						{
 							pixel_tag px;
-							_m_align_x_base(rs, px, (w ? w : sz.width));
+							_m_align_x_base(arr, px, (w ? w : sz.width));
 
 							if(w)
 							{
@@ -392,26 +450,32 @@ namespace nana
 
 								px.pixels = max_px;
 								px.baseline = max_ascent;
-								px.values.swap(line_values);
+								px.begin = line_values;
+								px.end = arr.values.size();
 
 								w = sz.width;
 								max_px = sz.height;
 								max_ascent = as;
 								max_descent = ds;
-								line_values.emplace_back(i);
+
+								line_values = arr.values.size();
+								arr.values.emplace_back(i);
 							}
 							else
 							{
 								px.pixels = sz.height;
 								px.baseline = as;
 
-								px.values.emplace_back(i);
+								arr.values.emplace_back(i);
+								px.begin = line_values;
+								px.end = arr.values.size();
+								line_values = arr.values.size();
 
 								max_px = 0;
 								max_ascent = max_descent = 0;
 							}
 
-							rs.pixels.emplace_back(px);
+							arr.pixels.emplace_back(px);
 						}
 					}
 
@@ -419,7 +483,7 @@ namespace nana
 					{
 						pixel_tag px;
 
-						_m_align_x_base(rs, px, w);
+						_m_align_x_base(arr, px, w);
 
 						if (max_ascent + max_descent > max_px)
 							max_px = max_descent + max_ascent;
@@ -428,23 +492,26 @@ namespace nana
 
 						px.pixels = max_px;
 						px.baseline = max_ascent;
-						px.values.swap(line_values);
-						rs.pixels.emplace_back(px);
+						px.begin = line_values;
+						px.end = arr.values.size();
+						arr.pixels.emplace_back(px);
 					}
 					return total_w;
 				}
 
-				bool _m_each_line(graph_reference graph, dstream::linecontainer&, render_status& rs)
+				bool _m_each_line(graph_reference graph, const arrangement& arr, std::size_t line_end, render_status& rs)
 				{
 					std::wstring text;
 					iterator block_start;
 
 					const int lastpos = static_cast<int>(graph.height()) - 1;
 
-					for(auto & px : rs.pixels)
+					for(auto index = rs.index; index < line_end; ++index)
 					{
-						for(auto & render_iterator: px.values)
+						auto & px_values = arr.pixels[index];
+						for(auto vi = px_values.begin; vi < px_values.end; ++vi)
 						{
+							auto render_iterator = arr.values[vi];
 							auto & value = *render_iterator;
 							if (value.data_ptr->is_text())
 							{
@@ -459,23 +526,23 @@ namespace nana
 							
 							if(text.size())
 							{
-								_m_draw_block(graph, text, block_start, rs);
+								_m_draw_block(graph, arr, text, block_start, rs);
 								if(lastpos <= rs.pos.y)
 									return false;
 								text.clear();
 							}
 							nana::size sz = value.data_ptr->size();
 
-							pixel_tag px = rs.pixels[rs.index];
-							if ((rs.allowed_width < rs.pos.x + sz.width) && (rs.pos.x != px.x_base))
+							const pixel_tag * px = &arr.pixels[rs.index];
+							if ((rs.allowed_width < rs.pos.x + sz.width) && (rs.pos.x != px->x_base))
 							{
 								//Change a line.
-								rs.pos.y += static_cast<int>(px.pixels);
-								px = rs.pixels[++rs.index];
-								rs.pos.x = px.x_base;
+								rs.pos.y += static_cast<int>(px->pixels);
+								px = &arr.pixels[++rs.index];
+								rs.pos.x = px->x_base;
 							}
 
-							int y = rs.pos.y + _m_text_top(px, value.fblock_ptr, value.data_ptr);
+							int y = rs.pos.y + _m_text_top(*px, value.fblock_ptr, value.data_ptr);
 
 							value.data_ptr->nontext_render(graph, rs.pos.x, y);
 							_m_insert_if_traceable(rs.pos.x, y, sz, value.fblock_ptr);
@@ -487,19 +554,19 @@ namespace nana
 
 						if(text.size())
 						{
-							_m_draw_block(graph, text, block_start, rs);
+							_m_draw_block(graph, arr, text, block_start, rs);
 							text.clear();
 						}
 					}
 					return (rs.pos.y <= lastpos);
 				}
 
-				static bool _m_overline(const render_status& rs, int right, bool equal_required) noexcept
+				static bool _m_overline(const arrangement& arr, const render_status& rs, int right, bool equal_required) noexcept
 				{
 					if(align::left == rs.text_align)
 						return (equal_required ? right >= static_cast<int>(rs.allowed_width) : right > static_cast<int>(rs.allowed_width));
 
-					return (equal_required ? rs.pixels[rs.index].x_base <= 0 : rs.pixels[rs.index].x_base < 0);
+					return (equal_required ? arr.pixels[rs.index].x_base <= 0 : arr.pixels[rs.index].x_base < 0);
 				}
 
 				static int _m_text_top(const pixel_tag& px, fblock* fblock_ptr, const data* data_ptr)
@@ -517,11 +584,11 @@ namespace nana
 					return 0;
 				}
 
-				void _m_draw_block(graph_reference graph, const std::wstring& s, dstream::linecontainer::iterator block_start, render_status& rs)
+				void _m_draw_block(graph_reference graph, const arrangement& arr, const std::wstring& s, dstream::linecontainer::iterator block_start, render_status& rs)
 				{
 					auto const reordered = unicode_reorder(s.data(), s.length());
 
-					pixel_tag px = rs.pixels[rs.index];
+					pixel_tag px = arr.pixels[rs.index];
 
 					for(auto & bidi : reordered)
 					{
@@ -548,7 +615,7 @@ namespace nana
 							{
 								//Change a new line
 								rs.pos.y += static_cast<int>(px.pixels);
-								px = rs.pixels[++rs.index];
+								px = arr.pixels[++rs.index];
 								rs.pos.x = px.x_base;
 							}
 
@@ -562,10 +629,12 @@ namespace nana
 							}
 							else
 							{
-								auto str = data_ptr->text().substr(text_range.first, text_range.second);
-								sz = graph.text_extent_size(str);
+								//Draw the part of text in place, rather than a copy of substring
+								auto const str = data_ptr->text().c_str() + text_range.first;
+								sz = graph.text_extent_size(str, text_range.second);
 
-								graph.string({ rs.pos.x, y }, str, _m_fgcolor(fblock_ptr));
+								graph.palette(true, _m_fgcolor(fblock_ptr));
+								graph.string({ rs.pos.x, y }, str, text_range.second);
 							}
 
 
@@ -597,6 +666,12 @@ namespace nana
 			private:
 				dstream dstream_;
 				bool format_enabled_ = false;
+
+				bool measured_ = false;					//Indicates whether the values of dstream_ are measured with measured_font_.
+				::nana::paint::font measured_font_;
+				arrangement arrangement_;				//The line boxes for rendering
+				arrangement measurement_;				//The line boxes for measuring
+				::std::map<const fblock*, ::nana::paint::font> fonts_;
 				::nana::widgets::skeletons::fblock * fblock_ = nullptr;
 				::std::deque<traceable> traceable_;
 
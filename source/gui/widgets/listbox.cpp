@@ -26,6 +26,7 @@
 #include <nana/paint/text_renderer.hpp>
 #include <nana/system/dataexch.hpp>
 #include <nana/system/platform.hpp>
+#include "../../threads/parallel.hpp"
 #include "skeletons/content_view.hpp"
 
 #include <algorithm>
@@ -34,6 +35,12 @@
 #include <stdexcept>
 #include <map>
 
+#if defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_thread.hpp>
+#else
+	#include <thread>
+#endif
+
 namespace nana
 {
 	static void check_range(std::size_t pos, std::size_t size)
@@ -730,6 +737,44 @@ namespace nana
 				std::size_t	column_pos;
 			};
 
+			//The categories which have fewer items are sorted by std::stable_sort on the calling thread.
+			constexpr std::size_t parallel_sort_threshold = 32768;
+
+			/// A stable merge sort which sorts the chunks of the sequence in parallel and merges the adjacent chunks in pairs.
+			template<typename T, typename Compare>
+			void parallel_stable_sort(std::vector<T>& seq, Compare comp)
+			{
+				const std::size_t chunks = (std::min)(static_cast<std::size_t>(2 * std::thread::hardware_concurrency()), seq.size() / (parallel_sort_threshold / 4));
+				if (chunks < 2)
+				{
+					std::stable_sort(seq.begin(), seq.end(), comp);
+					return;
+				}
+
+				std::vector<std::size_t> bounds;
+				for (std::size_t i = 0; i <= chunks; ++i)
+					bounds.push_back(seq.size() * i / chunks);
+
+				auto const first = seq.begin();
+				::nana::threads::detail::parallel_run(chunks, [&](std::size_t i)
+				{
+					std::stable_sort(first + bounds[i], first + bounds[i + 1], comp);
+				});
+
+				for (std::size_t width = 1; width < chunks; width *= 2)
+				{
+					::nana::threads::detail::parallel_run((chunks + 2 * width - 1) / (2 * width), [&](std::size_t pair)
+					{
+						auto const lower = pair * 2 * width;
+						auto const middle = (std::min)(lower + width, chunks);
+						auto const upper = (std::min)(lower + 2 * width, chunks);
+
+						if (middle < upper)
+							std::inplace_merge(first + bounds[lower], first + bounds[middle], first + bounds[upper], comp);
+					});
+				}
+			}
+
 			enum class view_action
 			{
 				auto_view,
@@ -834,114 +879,61 @@ namespace nana
 					if((npos == sort_attrs_.column) || (!sort_attrs_.resort))
 						return;
 
+					//The pending asynchronous sorts are discarded.
+					latest_sort_ticket_ = ++sort_ticket_;
+
 					auto weak_ordering_comp = fetch_ordering_comparer(sort_attrs_.column);
-					if(weak_ordering_comp)
+					for (auto & cat : categories_)
 					{
-						for (auto & cat : categories_)
+						//A large category is sorted in parallel by the texts of the column if it is compared by the default comparer.
+						//The user-defined comparer and the model are not assumed to be thread-safe.
+						if ((cat.sorted.size() >= parallel_sort_threshold) && !weak_ordering_comp && !cat.model_ptr)
 						{
-							const bool use_model = (cat.model_ptr != nullptr);
-
-							std::stable_sort(cat.sorted.begin(), cat.sorted.end(), [&cat, &weak_ordering_comp, use_model, this](std::size_t x, std::size_t y){
-								//The predicate must be a strict weak ordering.
-								//!comp(x, y) != comp(x, y)
-								if (use_model)
-								{
-									auto & mx = cat.items[x];
-									auto & my = cat.items[y];
-
-									auto mx_cells = cat.model_ptr->container()->to_cells(x);
-									auto my_cells = cat.model_ptr->container()->to_cells(y);
-
-									if (mx_cells.size() <= sort_attrs_.column || my_cells.size() <= sort_attrs_.column)
-									{
-										std::string a;
-										if (mx_cells.size() > sort_attrs_.column)
-											a = mx_cells[sort_attrs_.column].text;
-
-										std::string b;
-										if (my_cells.size() > sort_attrs_.column)
-											b = my_cells[sort_attrs_.column].text;
-
-										return weak_ordering_comp(a, mx.anyobj.get(), b, my.anyobj.get(), sort_attrs_.reverse);
-									}
-
-									return weak_ordering_comp(mx_cells[sort_attrs_.column].text, mx.anyobj.get(), my_cells[sort_attrs_.column].text, my.anyobj.get(), sort_attrs_.reverse);
-								}
-								
-								auto & mx = cat.items[x];
-								auto & my = cat.items[y];
-
-								if (mx.cells->size() <= sort_attrs_.column || my.cells->size() <= sort_attrs_.column)
-								{
-									std::string a;
-									if (mx.cells->size() > sort_attrs_.column)
-										a = (*mx.cells)[sort_attrs_.column].text;
-
-									std::string b;
-									if (my.cells->size() > sort_attrs_.column)
-										b = (*my.cells)[sort_attrs_.column].text;
-
-									return weak_ordering_comp(a, mx.anyobj.get(), b, my.anyobj.get(), sort_attrs_.reverse);
-								}
-
-								return weak_ordering_comp((*mx.cells)[sort_attrs_.column].text, mx.anyobj.get(), (*my.cells)[sort_attrs_.column].text, my.anyobj.get(), sort_attrs_.reverse);
-							});
+							if (async_sort_)
+								_m_sort_async(cat);
+							else
+								_m_sort_parallel(cat);
 						}
+						else
+							std::stable_sort(cat.sorted.begin(), cat.sorted.end(), item_comparer{ *this, cat, weak_ordering_comp });
 					}
-					else
-					{	//No user-defined comparer is provided, and default comparer is applying.
-						for (auto & cat : categories_)
-						{
-							const bool use_model = (cat.model_ptr != nullptr);
-
-							std::stable_sort(cat.sorted.begin(), cat.sorted.end(), [this, &cat, use_model](std::size_t x, std::size_t y){
-								//The predicate must be a strict weak ordering.
-								//!comp(x, y) != comp(x, y)
-								if (use_model)
-								{
-									auto mx_cells = cat.model_ptr->container()->to_cells(x);
-									auto my_cells = cat.model_ptr->container()->to_cells(y);
-
-									if (mx_cells.size() <= sort_attrs_.column || my_cells.size() <= sort_attrs_.column)
-									{
-										std::string a;
-										if (mx_cells.size() > sort_attrs_.column)
-											a = mx_cells[sort_attrs_.column].text;
-
-										std::string b;
-										if (my_cells.size() > sort_attrs_.column)
-											b = my_cells[sort_attrs_.column].text;
-
-										return (sort_attrs_.reverse ? a > b : a < b);
-									}
+				}
 
-									auto & a = mx_cells[sort_attrs_.column].text;
-									auto & b = my_cells[sort_attrs_.column].text;
-									return (sort_attrs_.reverse ? a > b : a < b);
-								}
+				bool async_sort() const noexcept
+				{
+					return async_sort_;
+				}
 
-								auto & mx = cat.items[x];
-								auto & my = cat.items[y];
+				void async_sort(bool enable) noexcept
+				{
+					async_sort_ = enable;
+				}
 
-								if (mx.cells->size() <= sort_attrs_.column || my.cells->size() <= sort_attrs_.column)
-								{
-									std::string a;
-									if (mx.cells->size() > sort_attrs_.column)
-										a = (*mx.cells)[sort_attrs_.column].text;
+				/// Discards the pending asynchronous sorts, it is called when the items or the categories are changed.
+				/**
+				 * The sort is performed again when a discarded order arrives, so that the new items are sorted.
+				 */
+				void discard_async_sort() noexcept
+				{
+					++sort_ticket_;
+				}
 
-									std::string b;
-									if (my.cells->size() > sort_attrs_.column)
-										b = (*my.cells)[sort_attrs_.column].text;
+				/// Merges the items appended at the end of the category into the sort order
+				/**
+				 * @param cat The category whose items are appended.
+				 * @param first The position in cat.sorted of the first appended item.
+				 */
+				void merge_sort_order(category_t& cat, std::size_t first)
+				{
+					if ((npos == sort_attrs_.column) || (!sort_attrs_.resort) || (first >= cat.sorted.size()))
+						return;
 
-									return (sort_attrs_.reverse ? a > b : a < b);
-								}
+					auto weak_ordering_comp = fetch_ordering_comparer(sort_attrs_.column);
+					item_comparer comp{ *this, cat, weak_ordering_comp };
 
-								auto & a = (*mx.cells)[sort_attrs_.column].text;
-								auto & b = (*my.cells)[sort_attrs_.column].text;
-								return (sort_attrs_.reverse ? a > b : a < b);
-							});
-						}
-					}
+					auto const middle = cat.sorted.begin() + first;
+					std::stable_sort(middle, cat.sorted.end(), comp);
+					std::inplace_merge(cat.sorted.begin(), middle, cat.sorted.end(), comp);
 				}
 
 				/// Sorts the specified column
@@ -1016,6 +1008,7 @@ namespace nana
 							}
 							else if (ptr->compare(i->key_ptr.get()))
 							{
+								discard_async_sort();
 								auto & catobj = *categories_.emplace(i);
 								catobj.key_ptr = ptr;
 								return &catobj;
@@ -1023,6 +1016,7 @@ namespace nana
 						}
 					}
 
+					discard_async_sort();
 					categories_.emplace_back();
 					categories_.back().key_ptr = ptr;
 					return &(categories_.back());
@@ -1031,6 +1025,8 @@ namespace nana
 				/// Inserts a new category at position specified by pos
 				category_t* create_category(native_string_type&& text, std::size_t pos = nana::npos)
 				{
+					discard_async_sort();
+
 					if (::nana::npos == pos)
 					{
 						categories_.emplace_back(std::move(text));
@@ -1049,6 +1045,7 @@ namespace nana
 
 					check_range(pos.item, item_count);
 
+					discard_async_sort();
 					catobj.sorted.push_back(item_count);
 
 					if (catobj.model_ptr)
@@ -1231,6 +1228,7 @@ namespace nana
 						catobj.model_ptr->container()->clear();
 					}
 
+					discard_async_sort();
 					catobj.items.clear();
 					catobj.sorted.clear();
 				}
@@ -1421,6 +1419,8 @@ namespace nana
 				{
 					auto i = get(cat);
 
+					discard_async_sort();
+
 					//If the category is the first one, it just clears the items instead of removing whole category.
 					if(0 == cat)
 					{
@@ -1934,6 +1934,133 @@ namespace nana
 					std::advance(i, pos);
 					return i;
 				}
+			private:
+				using ordering_comparer = std::function<bool(const ::std::string&, ::nana::any*, const ::std::string&, ::nana::any*, bool reverse)>;
+
+				/// A strict weak ordering of the absolute positions of the category's items for the sorted column.
+				class item_comparer
+				{
+				public:
+					item_comparer(const es_lister& lister, category_t& cat, const ordering_comparer& weak_ordering_comp) noexcept
+						: attrs_(lister.sort_attrs_), cat_(cat), weak_ordering_comp_(weak_ordering_comp)
+					{}
+
+					bool operator()(std::size_t x, std::size_t y) const
+					{
+						//The predicate must be a strict weak ordering.
+						//!comp(x, y) != comp(x, y)
+						const auto column = attrs_.column;
+						if (cat_.model_ptr)
+						{
+							auto mx_cells = cat_.model_ptr->container()->to_cells(x);
+							auto my_cells = cat_.model_ptr->container()->to_cells(y);
+
+							return _m_less(x, (column < mx_cells.size() ? &mx_cells[column].text : nullptr),
+											y, (column < my_cells.size() ? &my_cells[column].text : nullptr));
+						}
+
+						auto & mx_cells = *cat_.items[x].cells;
+						auto & my_cells = *cat_.items[y].cells;
+
+						return _m_less(x, (column < mx_cells.size() ? &mx_cells[column].text : nullptr),
+										y, (column < my_cells.size() ? &my_cells[column].text : nullptr));
+					}
+				private:
+					//The text is nullptr if the item doesn't have the sorted column, it is compared as an empty string.
+					bool _m_less(std::size_t x, const std::string* x_text, std::size_t y, const std::string* y_text) const
+					{
+						static const std::string empty;
+
+						auto & a = (x_text ? *x_text : empty);
+						auto & b = (y_text ? *y_text : empty);
+
+						if (weak_ordering_comp_)
+							return weak_ordering_comp_(a, cat_.items[x].anyobj.get(), b, cat_.items[y].anyobj.get(), attrs_.reverse);
+
+						//No user-defined comparer is provided, and default comparer is applying.
+						return (attrs_.reverse ? a > b : a < b);
+					}
+				private:
+					const sort_attributes& attrs_;
+					category_t& cat_;
+					const ordering_comparer& weak_ordering_comp_;
+				};
+
+				//The text of the sorted column of an item, it is empty if the item doesn't have the column.
+				const std::string& _m_sort_text(const category_t& cat, std::size_t pos) const
+				{
+					static const std::string empty;
+
+					auto & cells = *cat.items[pos].cells;
+					return (sort_attrs_.column < cells.size() ? cells[sort_attrs_.column].text : empty);
+				}
+
+				void _m_sort_parallel(category_t& cat)
+				{
+					//The items are referred by pointers to their texts during the sort, it avoids
+					//accessing the items through the deque.
+					std::vector<std::pair<const std::string*, std::size_t>> keys;
+					keys.reserve(cat.sorted.size());
+					for (auto pos : cat.sorted)
+						keys.emplace_back(&_m_sort_text(cat, pos), pos);
+
+					const bool reverse = sort_attrs_.reverse;
+					parallel_stable_sort(keys, [reverse](const std::pair<const std::string*, std::size_t>& x, const std::pair<const std::string*, std::size_t>& y)
+					{
+						return (reverse ? *x.first > *y.first : *x.first < *y.first);
+					});
+
+					for (std::size_t i = 0; i < keys.size(); ++i)
+						cat.sorted[i] = keys[i].second;
+				}
+
+				/// Sorts the category on the sort pool, the current order is displayed until the new order is ready.
+				void _m_sort_async(category_t& cat)
+				{
+					struct job_type
+					{
+						std::vector<std::pair<std::string, std::size_t>> keys;
+						std::vector<std::size_t> sorted;
+					};
+
+					//The texts are copied, because the items may be modified while sorting.
+					auto job = std::make_shared<job_type>();
+					job->keys.reserve(cat.sorted.size());
+					for (auto pos : cat.sorted)
+						job->keys.emplace_back(_m_sort_text(cat, pos), pos);
+
+					const auto ticket = sort_ticket_;
+					const bool reverse = sort_attrs_.reverse;
+					const auto cat_ptr = &cat;
+					const auto wd = widget_->handle();
+
+					//The lister may be destroyed before the order arrives, it is accessed only if the token is alive.
+					std::weak_ptr<int> alive = alive_;
+					auto self = this;
+
+					::nana::threads::detail::shared_pool().push([self, alive, job, ticket, reverse, cat_ptr, wd]
+					{
+						parallel_stable_sort(job->keys, [reverse](const std::pair<std::string, std::size_t>& x, const std::pair<std::string, std::size_t>& y)
+						{
+							return (reverse ? x.first > y.first : x.first < y.first);
+						});
+
+						job->sorted.reserve(job->keys.size());
+						for (auto & key : job->keys)
+							job->sorted.push_back(key.second);
+						job->keys.clear();
+
+						API::post(wd, [self, alive, job, ticket, cat_ptr]
+						{
+							internal_scope_guard lock;
+							if (!alive.expired())
+								self->_m_apply_sort_order(ticket, cat_ptr, job->sorted);
+						});
+					});
+				}
+
+				// Definition is provided after struct essence
+				void _m_apply_sort_order(std::size_t ticket, const category_t* cat_ptr, std::vector<std::size_t>& sorted);
 			public:
 				index_pair latest_selected_abs;	//Stands for the latest selected item that selected by last operation. Invalid if it is empty.
 			private:
@@ -1941,6 +2068,10 @@ namespace nana
 				nana::listbox * widget_{nullptr};
 
 				sort_attributes sort_attrs_;	//Attributes of sort
+				bool async_sort_{ false };
+				std::size_t sort_ticket_{ 0 };	//Identifies the latest sort or change, the result of an earlier asynchronous sort is discarded.
+				std::size_t latest_sort_ticket_{ 0 };	//The ticket of the latest sort
+				std::shared_ptr<int> alive_{ std::make_shared<int>(0) };	//The liveness token for the asynchronous sorts
 				container categories_;
 
 				bool	ordered_categories_{false};	///< A switch indicates whether the categories are ordered.
@@ -2940,6 +3071,34 @@ namespace nana
 				std::vector<std::pair<index_type, inline_pane*>> panes_;
 			};
 
+			void es_lister::_m_apply_sort_order(std::size_t ticket, const category_t* cat_ptr, std::vector<std::size_t>& sorted)
+			{
+				//Discards the order if another sort is requested or the items are changed. The items are sorted
+				//again if they are changed after the sort is requested.
+				if (ticket != sort_ticket_)
+				{
+					if (ticket == latest_sort_ticket_)
+					{
+						sort();
+						ess_->update();
+					}
+					return;
+				}
+
+				for (auto & cat : categories_)
+				{
+					if (&cat == cat_ptr)
+					{
+						if ((cat.items.size() == sorted.size()) && (cat.sorted.size() == sorted.size()))
+						{
+							cat.sorted.swap(sorted);
+							ess_->update();
+						}
+						return;
+					}
+				}
+			}
+
 			void es_lister::scroll_into_view(const index_pair& abs_pos, view_action vw_act)
 			{
 				auto& cat = *get(abs_pos.cat);
@@ -3007,6 +3166,7 @@ namespace nana
 						cat.model_ptr->container()->erase(pos.item);
 					}
 
+					discard_async_sort();
 					cat.items.erase(cat.items.begin() + pos.item);
 					cat.sorted.erase(std::find(cat.sorted.begin(), cat.sorted.end(), cat.items.size()));
 
@@ -5074,6 +5234,7 @@ namespace nana
 
 					ess_->lister.throw_if_immutable_model(index_pair{ pos_ });
 
+					ess_->lister.discard_async_sort();
 					cat_->sorted.push_back(cat_->items.size());
 
 					if (cat_->model_ptr)
@@ -5240,9 +5401,9 @@ namespace nana
 					cat_->indicators[column].reset(new inline_indicator(ess_, column));
 				}
 
-				void cat_proxy::_m_append(std::vector<cell> && cells)
+				//check invalid cells
+				static void clear_invalid_cells(std::vector<cell>& cells)
 				{
-					//check invalid cells
 					for (auto & cl : cells)
 					{
 						if (cl.text.size() == 1 && cl.text[0] == wchar_t(0))
@@ -5251,9 +5412,16 @@ namespace nana
 							cl.custom_format.reset();
 						}
 					}
+				}
+
+				void cat_proxy::_m_append(std::vector<cell> && cells)
+				{
+					clear_invalid_cells(cells);
 
 					internal_scope_guard lock;
 
+					ess_->lister.discard_async_sort();
+
 					if (cat_->model_ptr)
 					{
 						es_lister::throw_if_immutable_model(cat_->model_ptr.get());
@@ -5275,6 +5443,53 @@ namespace nana
 					cat_->sorted.push_back(cat_->items.size() - 1);
 				}
 
+				void cat_proxy::_m_append(std::vector<std::vector<cell>> && rows)
+				{
+					if (rows.empty())
+						return;
+
+					for (auto & cells : rows)
+						clear_invalid_cells(cells);
+
+					internal_scope_guard lock;
+
+					const auto first_item = cat_->items.size();
+					const auto first_sorted = cat_->sorted.size();
+
+					ess_->lister.discard_async_sort();
+
+					if (cat_->model_ptr)
+					{
+						es_lister::throw_if_immutable_model(cat_->model_ptr.get());
+
+						auto container = cat_->model_ptr->container();
+						for (auto & cells : rows)
+						{
+							auto item_index = container->size();
+							cat_->items.emplace_back();
+							container->emplace_back();
+
+							container->assign(item_index, cells);
+						}
+					}
+					else
+					{
+						const auto cols = columns();
+						for (auto & cells : rows)
+						{
+							cells.resize(cols);
+							cat_->items.emplace_back(std::move(cells));
+						}
+					}
+
+					cat_->sorted.reserve(first_sorted + rows.size());
+					for (auto pos = first_item; pos < cat_->items.size(); ++pos)
+						cat_->sorted.push_back(pos);
+
+					ess_->lister.merge_sort_order(*cat_, first_sorted);
+					ess_->update();
+				}
+
 				void cat_proxy::_m_try_append_model(const const_virtual_pointer& dptr)
 				{
 					//Throws when appends an object to a listbox which should have a model.
@@ -5286,6 +5501,7 @@ namespace nana
 					if (!cat_->model_ptr->container()->push_back(dptr))
 						throw std::invalid_argument("nana::listbox, the type of operand object is mismatched with model container value_type");
 
+					ess_->lister.discard_async_sort();
 					cat_->sorted.push_back(cat_->items.size());
 					cat_->items.emplace_back();
 				}
@@ -5314,6 +5530,7 @@ namespace nana
 				{
 					if (ess_->listbox_ptr)
 					{
+						ess_->lister.discard_async_sort();
 						cat_->model_ptr.reset(p);
 						cat_->items.clear();
 
@@ -5669,6 +5886,7 @@ namespace nana
 
 			auto const origin = ess.content_view->origin();
 
+			ess.lister.discard_async_sort();
 			for (auto & pos : indexes)
 			{
 				auto & cat = *ess.lister.get(pos.cat);
@@ -5766,6 +5984,18 @@ namespace nana
 			return !_m_ess().lister.active_sort(!freeze);
 		}
 
+		void listbox::async_sort(bool enable)
+		{
+			internal_scope_guard lock;
+			_m_ess().lister.async_sort(enable);
+		}
+
+		bool listbox::async_sort() const
+		{
+			internal_scope_guard lock;
+			return _m_ess().lister.async_sort();
+		}
+
 		auto listbox::selected() const -> index_pairs
 		{
 			return _m_ess().lister.pick_items(true);   // absolute positions, no relative to display
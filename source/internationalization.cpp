@@ -16,6 +16,9 @@
 #include <nana/gui/programming_interface.hpp>
 #include <unordered_map>
 #include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 #if defined(STD_THREAD_NOT_SUPPORTED)
 #include <nana/std_mutex.hpp>
@@ -23,6 +26,14 @@
 #include <mutex>
 #endif
 
+#if defined(NANA_WINDOWS)
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
 
 #include <map>
 
@@ -155,10 +166,256 @@ namespace nana
 			std::string str_;
 		};//end class tokenizer
 
+		/// A read-only view of a file which is mapped into memory.
+		class mapped_file
+		{
+			mapped_file(const mapped_file&) = delete;
+			mapped_file& operator=(const mapped_file&) = delete;
+		public:
+			mapped_file(const std::string& file)
+			{
+#if defined(NANA_WINDOWS)
+				file_ = ::CreateFileW(to_wstring(file).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (INVALID_HANDLE_VALUE == file_)
+					return;
+
+				LARGE_INTEGER bytes;
+				if (!::GetFileSizeEx(file_, &bytes) || (0 == bytes.QuadPart))
+					return;
+
+				mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (nullptr == mapping_)
+					return;
+
+				data_ = static_cast<const char*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+				if (data_)
+					size_ = static_cast<std::size_t>(bytes.QuadPart);
+#else
+				int fd = ::open(file.c_str(), O_RDONLY);
+				if (fd < 0)
+					return;
+
+				struct stat st;
+				if ((0 == ::fstat(fd, &st)) && (st.st_size > 0))
+				{
+					auto p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+					if (MAP_FAILED != p)
+					{
+						data_ = static_cast<const char*>(p);
+						size_ = static_cast<std::size_t>(st.st_size);
+					}
+				}
+
+				//The mapping remains valid after the file descriptor is closed.
+				::close(fd);
+#endif
+			}
+
+			~mapped_file()
+			{
+#if defined(NANA_WINDOWS)
+				if (data_)
+					::UnmapViewOfFile(data_);
+				if (mapping_)
+					::CloseHandle(mapping_);
+				if (INVALID_HANDLE_VALUE != file_)
+					::CloseHandle(file_);
+#else
+				if (data_)
+					::munmap(const_cast<char*>(data_), size_);
+#endif
+			}
+
+			const char* data() const
+			{
+				return data_;
+			}
+
+			std::size_t size() const
+			{
+				return size_;
+			}
+		private:
+#if defined(NANA_WINDOWS)
+			HANDLE file_{ INVALID_HANDLE_VALUE };
+			HANDLE mapping_{ nullptr };
+#endif
+			const char* data_{ nullptr };
+			std::size_t size_{ 0 };
+		};
+
+		/// The binary catalog which is generated by internationalization::compile.
+		/**
+		 * The layout of a catalog, all the integers are 32-bit in native byte order, and the offsets are relative to the beginning of file.
+		 *	header		magic "NANAI18N", version, the number of entries, the number of buckets, the number of slots
+		 *	seeds		a displacement seed for each bucket of the perfect hash
+		 *	entries		msgid offset, msgid length, msgstr offset, msgstr length, first argument, the number of arguments
+		 *	arguments	the position, length and index of each %argN in msgstr
+		 *	strings		the texts of msgids and msgstrs, in UTF-8
+		 * A msgid is hashed into a bucket, and the seed of the bucket hashes the msgid into the position of its entry.
+		 */
+		class catalog
+		{
+		public:
+			struct header
+			{
+				char magic[8];
+				std::uint32_t version;
+				std::uint32_t entries;
+				std::uint32_t buckets;
+				std::uint32_t arguments;
+			};
+
+			struct entry
+			{
+				std::uint32_t msgid;
+				std::uint32_t msgid_length;
+				std::uint32_t msgstr;
+				std::uint32_t msgstr_length;
+				std::uint32_t argument;
+				std::uint32_t argument_count;
+			};
+
+			struct argument
+			{
+				std::uint32_t pos;		//The position of %argN in the msgstr
+				std::uint32_t length;	//The length of %argN
+				std::uint32_t index;	//The N of %argN
+			};
+
+			static constexpr char magic[] = "NANAI18N";
+			static constexpr std::uint32_t version = 1;
+
+			static std::uint32_t hash(std::uint32_t seed, const char* s, std::size_t len)
+			{
+				//FNV-1a with a murmur3 finalizer
+				std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+				for (std::size_t i = 0; i < len; ++i)
+				{
+					h ^= static_cast<unsigned char>(s[i]);
+					h *= 16777619u;
+				}
+
+				h ^= h >> 16;
+				h *= 0x85EBCA6Bu;
+				h ^= h >> 13;
+				h *= 0xC2B2AE35u;
+				h ^= h >> 16;
+				return h;
+			}
+
+			/// Opens a catalog, returns nullptr if the file is not a catalog.
+			static std::shared_ptr<catalog> open(const std::string& file)
+			{
+				std::shared_ptr<catalog> ptr{ new catalog(file) };
+				if (ptr->header_)
+					return ptr;
+
+				return nullptr;
+			}
+
+			const entry* find(const std::string& msgid) const
+			{
+				if (0 == header_->entries)
+					return nullptr;
+
+				auto bucket = hash(0, msgid.data(), msgid.size()) % header_->buckets;
+				auto & ent = entries_[hash(seeds_[bucket], msgid.data(), msgid.size()) % header_->entries];
+
+				if ((ent.msgid_length == msgid.size()) && _m_valid(ent.msgid, ent.msgid_length) && (0 == std::memcmp(file_.data() + ent.msgid, msgid.data(), msgid.size())))
+					return &ent;
+
+				return nullptr;
+			}
+
+			/// Returns the msgstr of the entry whose arguments are replaced.
+			std::string format(const entry& ent, const std::vector<std::string>* arg_strs) const
+			{
+				if (!_m_valid(ent.msgstr, ent.msgstr_length) || !_m_valid_arguments(ent))
+					return{};
+
+				auto text = file_.data() + ent.msgstr;
+
+				std::string str;
+				str.reserve(ent.msgstr_length);
+
+				std::uint32_t pos = 0;
+				for (auto arg = arguments_ + ent.argument, end = arg + ent.argument_count; arg != end; ++arg)
+				{
+					str.append(text + pos, arg->pos - pos);
+
+					//If there is not a parameter for %argNNN, the %argNNN will be erased.
+					if (arg_strs && (arg->index < arg_strs->size()))
+						str += (*arg_strs)[arg->index];
+
+					pos = arg->pos + arg->length;
+				}
+				str.append(text + pos, ent.msgstr_length - pos);
+				return str;
+			}
+
+			/// Returns false if the msgid is not found.
+			bool contains(const std::string& msgid) const
+			{
+				return (nullptr != find(msgid));
+			}
+		private:
+			catalog(const std::string& file)
+				: file_(file)
+			{
+				if (file_.size() < sizeof(header))
+					return;
+
+				auto hdr = reinterpret_cast<const header*>(file_.data());
+				if ((0 != std::memcmp(hdr->magic, magic, sizeof hdr->magic)) || (hdr->version != version) || (0 == hdr->buckets))
+					return;
+
+				std::size_t const tables = sizeof(header) + sizeof(std::uint32_t) * std::size_t(hdr->buckets) + sizeof(entry) * std::size_t(hdr->entries) + sizeof(argument) * std::size_t(hdr->arguments);
+				if (tables > file_.size())
+					return;
+
+				seeds_ = reinterpret_cast<const std::uint32_t*>(hdr + 1);
+				entries_ = reinterpret_cast<const entry*>(seeds_ + hdr->buckets);
+				arguments_ = reinterpret_cast<const argument*>(entries_ + hdr->entries);
+				header_ = hdr;
+			}
+
+			//The offsets are checked when they are used, a damaged catalog doesn't cause out-of-range access.
+			bool _m_valid(std::uint32_t offset, std::uint32_t length) const
+			{
+				return (std::size_t(offset) + length <= file_.size());
+			}
+
+			bool _m_valid_arguments(const entry& ent) const
+			{
+				if (std::size_t(ent.argument) + ent.argument_count > header_->arguments)
+					return false;
+
+				std::uint32_t pos = 0;
+				for (auto arg = arguments_ + ent.argument, end = arg + ent.argument_count; arg != end; ++arg)
+				{
+					if ((arg->pos < pos) || (std::size_t(arg->pos) + arg->length > ent.msgstr_length))
+						return false;
+					pos = arg->pos + arg->length;
+				}
+				return true;
+			}
+		private:
+			mapped_file file_;
+			const header* header_{ nullptr };
+			const std::uint32_t* seeds_{ nullptr };
+			const entry* entries_{ nullptr };
+			const argument* arguments_{ nullptr };
+		};
+
+		constexpr char catalog::magic[];
+		constexpr std::uint32_t catalog::version;
+
 		struct data
 		{
 			std::function<void(const std::string&)> on_missing;
 			std::unordered_map<std::string, std::string> table;
+			std::shared_ptr<catalog> catalog_ptr;	//The table takes precedence over the catalog
 
 			data()
 			{
@@ -206,17 +463,16 @@ namespace nana
 			return data_ptr;
 		}
 
-		void load(const std::string& file, bool utf8)
+		//Parses a text catalog, returns false if the catalog is ill-formed.
+		static bool parse(const std::string& file, bool utf8, std::unordered_map<std::string, std::string>& table)
 		{
-			auto impl = std::make_shared<data>();
-
 			tokenizer tknizer(file, utf8);
 			while (true)
 			{
 				if (token::msgid != tknizer.read())
 					break;
 				if (token::string != tknizer.read())
-					return;
+					return false;
 
 				std::string msgid = std::move(tknizer.get_str());
 
@@ -224,9 +480,9 @@ namespace nana
 					msgid = nana::charset(std::move(msgid)).to_bytes(nana::unicode::utf8);
 
 				if (token::msgstr != tknizer.read())
-					return;
+					return false;
 				if (token::string != tknizer.read())
-					return;
+					return false;
 
 				std::string str;
 
@@ -264,23 +520,228 @@ namespace nana
 					else
 						break;
 				}
-				impl->table[std::move(msgid)].swap(str);
+				table[std::move(msgid)].swap(str);
 			}
+			return true;
+		}
 
-			//Assign all language texts to the new table.
+		void load(const std::string& file, bool utf8)
+		{
+			auto impl = std::make_shared<data>();
 			auto & cur_table = get_data_ptr()->table;
-			auto & new_table = impl->table;
-			for (auto & m : cur_table)
+
+			//A compiled catalog is mapped into memory instead of being parsed.
+			auto catalog_ptr = catalog::open(file);
+			if (catalog_ptr)
+			{
+				//The table keeps the texts which are not translated by the catalog.
+				auto & new_table = impl->table;
+				for (auto i = new_table.begin(); i != new_table.end();)
+				{
+					if (catalog_ptr->contains(i->first))
+						i = new_table.erase(i);
+					else
+						++i;
+				}
+
+				for (auto & m : cur_table)
+				{
+					if ((0 == new_table.count(m.first)) && !catalog_ptr->contains(m.first))
+						new_table[m.first] = m.second;
+				}
+
+				impl->catalog_ptr = std::move(catalog_ptr);
+			}
+			else
 			{
-				auto & value = new_table[m.first];
-				if (value.empty())
-					value = m.second;
+				if (!parse(file, utf8, impl->table))
+					return;
+
+				//Assign all language texts to the new table.
+				auto & new_table = impl->table;
+				for (auto & m : cur_table)
+				{
+					auto & value = new_table[m.first];
+					if (value.empty())
+						value = m.second;
+				}
 			}
 
 			get_data_ptr().swap(impl);
 			use_eval();
 		}
 
+		//Finds the positions of %argN in a msgstr
+		static void parse_arguments(const std::string& str, std::vector<catalog::argument>& args)
+		{
+			std::string::size_type offset = 0;
+			while (true)
+			{
+				auto pos = str.find("%arg", offset);
+				if (pos == str.npos)
+					return;
+
+				auto end = str.find_first_not_of("0123456789", pos + 4);
+				if (end == str.npos)
+					end = str.size();
+
+				if (end == pos + 4)
+				{
+					offset = end;
+					continue;
+				}
+
+				catalog::argument arg;
+				arg.pos = static_cast<std::uint32_t>(pos);
+				arg.length = static_cast<std::uint32_t>(end - pos);
+				arg.index = static_cast<std::uint32_t>(std::stoul(str.substr(pos + 4, end - pos - 4)));
+				args.push_back(arg);
+
+				offset = end;
+			}
+		}
+
+		//Computes the seeds of a perfect hash which maps the msgids into the slots, returns false if the seeds are not found.
+		static bool make_perfect_hash(const std::vector<const std::string*>& keys, std::uint32_t buckets, std::uint32_t slots, std::vector<std::uint32_t>& seeds, std::vector<std::size_t>& slot_keys)
+		{
+			std::vector<std::vector<std::size_t>> bucket_keys(buckets);
+			for (std::size_t i = 0; i < keys.size(); ++i)
+				bucket_keys[catalog::hash(0, keys[i]->data(), keys[i]->size()) % buckets].push_back(i);
+
+			//The buckets which have more keys are placed first, when there are more free slots.
+			std::vector<std::uint32_t> order(buckets);
+			for (std::uint32_t i = 0; i < buckets; ++i)
+				order[i] = i;
+
+			std::stable_sort(order.begin(), order.end(), [&bucket_keys](std::uint32_t a, std::uint32_t b){
+				return bucket_keys[a].size() > bucket_keys[b].size();
+			});
+
+			seeds.assign(buckets, 0);
+			slot_keys.assign(slots, npos);
+
+			std::vector<std::uint32_t> positions;
+			for (auto bucket : order)
+			{
+				auto & bkeys = bucket_keys[bucket];
+				if (bkeys.empty())
+					break;
+
+				bool placed = false;
+				for (std::uint32_t seed = 1; seed < (1u << 24); ++seed)
+				{
+					positions.clear();
+					for (auto k : bkeys)
+					{
+						auto pos = catalog::hash(seed, keys[k]->data(), keys[k]->size()) % slots;
+						if ((npos != slot_keys[pos]) || (positions.cend() != std::find(positions.cbegin(), positions.cend(), pos)))
+							break;
+
+						positions.push_back(pos);
+					}
+
+					if (positions.size() == bkeys.size())
+					{
+						for (std::size_t i = 0; i < positions.size(); ++i)
+							slot_keys[positions[i]] = bkeys[i];
+
+						seeds[bucket] = seed;
+						placed = true;
+						break;
+					}
+				}
+
+				if (!placed)
+					return false;
+			}
+			return true;
+		}
+
+		bool compile(const std::string& file, const std::string& catalog_file, bool utf8)
+		{
+			std::unordered_map<std::string, std::string> table;
+			if (!parse(file, utf8, table))
+				return false;
+
+			std::vector<const std::string*> keys;
+			for (auto & m : table)
+				keys.push_back(&m.first);
+
+			//Sorts the msgids for a deterministic output.
+			std::sort(keys.begin(), keys.end(), [](const std::string* a, const std::string* b){
+				return *a < *b;
+			});
+
+			const auto buckets = static_cast<std::uint32_t>(keys.size() / 4 + 1);
+			auto slots = static_cast<std::uint32_t>(keys.size() + keys.size() / 16);
+
+			std::vector<std::uint32_t> seeds;
+			std::vector<std::size_t> slot_keys;
+			while (!make_perfect_hash(keys, buckets, slots, seeds, slot_keys))
+				slots += static_cast<std::uint32_t>(keys.size() / 16 + 1);
+
+			std::vector<catalog::entry> entries(slots);
+			std::vector<catalog::argument> args;
+			std::string strings;
+
+			const std::size_t strings_offset = sizeof(catalog::header) + sizeof(std::uint32_t) * seeds.size() + sizeof(catalog::entry) * entries.size();
+			for (std::uint32_t i = 0; i < slots; ++i)
+			{
+				auto & ent = entries[i];
+				if (npos == slot_keys[i])
+				{
+					//An empty slot, its offset is out of range so that it never matches a msgid.
+					ent.msgid = ent.msgstr = 0xFFFFFFFF;
+					ent.msgid_length = ent.msgstr_length = ent.argument = ent.argument_count = 0;
+					continue;
+				}
+
+				auto & msgid = *keys[slot_keys[i]];
+				auto & msgstr = table[msgid];
+
+				ent.argument = static_cast<std::uint32_t>(args.size());
+				parse_arguments(msgstr, args);
+				ent.argument_count = static_cast<std::uint32_t>(args.size() - ent.argument);
+
+				ent.msgid_length = static_cast<std::uint32_t>(msgid.size());
+				ent.msgstr_length = static_cast<std::uint32_t>(msgstr.size());
+
+				//The offsets are fixed up after the size of the argument table is known.
+				ent.msgid = static_cast<std::uint32_t>(strings.size());
+				strings += msgid;
+				ent.msgstr = static_cast<std::uint32_t>(strings.size());
+				strings += msgstr;
+			}
+
+			const std::size_t base = strings_offset + sizeof(catalog::argument) * args.size();
+			if (base + strings.size() >= 0xFFFFFFFF)
+				return false;
+
+			for (auto & ent : entries)
+			{
+				if (ent.msgid != 0xFFFFFFFF)
+				{
+					ent.msgid += static_cast<std::uint32_t>(base);
+					ent.msgstr += static_cast<std::uint32_t>(base);
+				}
+			}
+
+			catalog::header hdr;
+			std::memcpy(hdr.magic, catalog::magic, sizeof hdr.magic);
+			hdr.version = catalog::version;
+			hdr.entries = slots;
+			hdr.buckets = buckets;
+			hdr.arguments = static_cast<std::uint32_t>(args.size());
+
+			std::ofstream ofs(catalog_file.c_str(), std::ios::binary);
+			ofs.write(reinterpret_cast<const char*>(&hdr), sizeof hdr);
+			ofs.write(reinterpret_cast<const char*>(seeds.data()), sizeof(std::uint32_t) * seeds.size());
+			ofs.write(reinterpret_cast<const char*>(entries.data()), sizeof(catalog::entry) * entries.size());
+			ofs.write(reinterpret_cast<const char*>(args.data()), sizeof(catalog::argument) * args.size());
+			ofs.write(strings.data(), strings.size());
+			return static_cast<bool>(ofs);
+		}
+
 
 		struct eval_window
 		{
@@ -351,11 +812,14 @@ namespace nana
 		internationalization_parts::load(file, true);
 	}
 
+	bool internationalization::compile(const std::string& file, const std::string& catalog, bool utf8)
+	{
+		return internationalization_parts::compile(file, catalog, utf8);
+	}
+
 	std::string internationalization::get(std::string msgid) const
 	{
-		std::string str = _m_get(std::move(msgid));
-		_m_replace_args(str, nullptr);
-		return str;
+		return _m_translate(msgid, nullptr);
 	}
 
 	void internationalization::set(std::string msgid, std::string msgstr)
@@ -364,17 +828,31 @@ namespace nana
 		ptr->table[msgid].swap(msgstr);
 	}
 
-	std::string internationalization::_m_get(std::string&& msgid) const
+	std::string internationalization::_m_translate(const std::string& msgid, std::vector<std::string>* arg_strs) const
 	{
 		auto & impl = internationalization_parts::get_data_ptr();
 		auto i = impl->table.find(msgid);
 		if (i != impl->table.end())
-			return i->second;
+		{
+			auto str = i->second;
+			_m_replace_args(str, arg_strs);
+			return str;
+		}
+
+		if (impl->catalog_ptr)
+		{
+			//The arguments of a catalog entry are parsed by the compiler.
+			auto ent = impl->catalog_ptr->find(msgid);
+			if (ent)
+				return impl->catalog_ptr->format(*ent, arg_strs);
+		}
 
 		if (impl->on_missing)
 			impl->on_missing(msgid);
 
-		return std::move(msgid);
+		auto str = msgid;
+		_m_replace_args(str, arg_strs);
+		return str;
 	}
 
 	void internationalization::_m_replace_args(std::string& str, std::vector<std::string> * arg_strs) const
@@ -389,7 +867,8 @@ namespace nana
 			offset = pos;
 			pos = str.find_first_not_of("0123456789", offset + 4);
 
-			if ((pos == str.npos) || (pos != offset + 4))
+			//A %arg which is not followed by a number is not replaced.
+			if (((pos == str.npos) && (offset + 4 < str.size())) || ((pos != str.npos) && (pos != offset + 4)))
 			{
 				std::string::size_type erase_n = 0;
 				std::string::size_type arg_n = str.npos;
@@ -551,10 +1030,7 @@ namespace nana
 			arg_strs.emplace_back(arg->eval());
 
 		internationalization i18n;
-
-		std::string msgstr = i18n._m_get(std::string{msgid_});		
-		i18n._m_replace_args(msgstr, &arg_strs);
-		return msgstr;
+		return i18n._m_translate(msgid_, &arg_strs);
 	}
 
 	void i18n_eval::_m_add_args(i18n_eval& eval)
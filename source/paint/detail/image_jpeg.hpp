@@ -30,6 +30,19 @@ namespace nana
 			{
 				::jpeg_read_header(&jdstru, true);	//Reject a tables-only JPEG file as an error
 
+				//Let the IDCT produce a reduced image directly if a smaller size is requested. The smallest scale N/8
+				//that is not less than the requested size is chosen. A libjpeg which only supports 1/1, 1/2, 1/4
+				//and 1/8 rounds it up to the nearest supported scale.
+				if (request_size_.width && request_size_.height)
+				{
+					unsigned num = 1;
+					while (num < 8 && ((jdstru.image_width * num + 7) / 8 < request_size_.width || (jdstru.image_height * num + 7) / 8 < request_size_.height))
+						++num;
+
+					jdstru.scale_num = num;
+					jdstru.scale_denom = 8;
+				}
+
 				::jpeg_start_decompress(&jdstru);
 
 				//JSAMPLEs per row in output buffer
@@ -24,6 +24,11 @@ namespace nana
 			: public image::image_impl_interface
 		{
 		public:
+			void request_size(const nana::size& sz) override
+			{
+				request_size_ = sz;
+			}
+
 			bool alpha_channel() const override
 			{
 				return pixbuf_.alpha_channel();
@@ -55,6 +60,7 @@ namespace nana
 			}
 		protected:
 			pixel_buffer pixbuf_;
+			nana::size request_size_;	//The decoded image is reduced toward it if it is not empty.
 		};
 	}//end namespace detail
 	}//end namespace paint
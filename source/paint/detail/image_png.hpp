@@ -2,6 +2,7 @@
 #define NANA_PAINT_DETAIL_IMAGE_PNG_HPP
 
 #include "image_pixbuf.hpp"
+#include <algorithm>
 #include <cstring>
 
 //Separate the libpng from the package that system provides.
@@ -25,102 +26,109 @@ namespace nana
 			{
 				::png_read_info(png_ptr, info_ptr);
 
-				const int png_width = ::png_get_image_width(png_ptr, info_ptr);
-				const int png_height = ::png_get_image_height(png_ptr, info_ptr);
+				const png_uint_32 png_width = ::png_get_image_width(png_ptr, info_ptr);
+				const png_uint_32 png_height = ::png_get_image_height(png_ptr, info_ptr);
 				png_byte color_type = ::png_get_color_type(png_ptr, info_ptr);
 				const auto bit_depth = ::png_get_bit_depth(png_ptr, info_ptr);
 
-				//do some extra work for palette/gray color type
+				//Let libpng transform every color type to 8-bit BGRA, the memory layout of pixel_argb_t,
+				//so that the rows are decoded into the pixel buffer directly.
 				if (PNG_COLOR_TYPE_PALETTE == color_type)
 					::png_set_palette_to_rgb(png_ptr);
-				else if ((PNG_COLOR_TYPE_GRAY == color_type) && (bit_depth < 8))
+				else if (0 == (PNG_COLOR_MASK_COLOR & color_type))
+				{
+					if (bit_depth < 8)
+						::png_set_expand_gray_1_2_4_to_8(png_ptr);
+
 					::png_set_gray_to_rgb(png_ptr);
+				}
 
 				auto is_alpha_enabled = (::png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0);
 				if (is_alpha_enabled)
 					::png_set_tRNS_to_alpha(png_ptr);
 
+				is_alpha_enabled |= ((PNG_COLOR_MASK_ALPHA & color_type) != 0);
+
 				//make sure 8-bit per channel
 				if (16 == bit_depth)
 					::png_set_strip_16(png_ptr);
 
-				::png_set_interlace_handling(png_ptr);
-				::png_read_update_info(png_ptr, info_ptr);
+				if (!is_alpha_enabled)
+					::png_set_filler(png_ptr, 0xFF, PNG_FILLER_AFTER);
 
-				//The following codes may longjmp while image_read error.
-				png_bytep * row_ptrs = new png_bytep[png_height];
-				const std::size_t png_rowbytes = ::png_get_rowbytes(png_ptr, info_ptr);
+				::png_set_bgr(png_ptr);
 
-				pixbuf_.open(png_width, png_height);
+				const int passes = ::png_set_interlace_handling(png_ptr);
+				::png_read_update_info(png_ptr, info_ptr);
 
-				is_alpha_enabled |= ((PNG_COLOR_MASK_ALPHA & color_type) != 0);
-				pixbuf_.alpha_channel(is_alpha_enabled);
+				//Reduces the image by an integral factor while reading if a smaller size is requested.
+				//An interlaced image is always decoded at full size because its rows are read in several passes.
+				png_uint_32 factor = 1;
+				if (1 == passes && request_size_.width && request_size_.height)
+					factor = (std::max)(png_uint_32(1), (std::min)(png_width / request_size_.width, png_height / request_size_.height));
 
-				if (is_alpha_enabled && (png_rowbytes == png_width * sizeof(pixel_argb_t)))
+				if (1 == factor)
 				{
-					for (int i = 0; i < png_height; ++i)
-						row_ptrs[i] = reinterpret_cast<png_bytep>(pixbuf_.raw_ptr(i));
+					pixbuf_.open(png_width, png_height);
+					pixbuf_.alpha_channel(is_alpha_enabled);
 
-					::png_read_image(png_ptr, row_ptrs);
-
-					for (int i = 0; i < png_height; ++i)
+					//The following codes may longjmp while image_read error.
+					for (int pass = 0; pass < passes; ++pass)
 					{
-						auto p = pixbuf_.raw_ptr(i);
-						for (int u = 0; u < png_width; ++u)
-						{
-							auto t = p[u].element.red;
-							p[u].element.red = p[u].element.blue;
-							p[u].element.blue = t;
-						}
+						for (png_uint_32 i = 0; i < png_height; ++i)
+							::png_read_row(png_ptr, reinterpret_cast<png_bytep>(pixbuf_.raw_ptr(i)), nullptr);
 					}
+					return;
 				}
-				else
-				{
-					png_byte * png_pixbuf = new png_byte[png_height * png_rowbytes];
 
-					for (int i = 0; i < png_height; ++i)
-						row_ptrs[i] = reinterpret_cast<png_bytep>(png_pixbuf + png_rowbytes * i);
+				const png_uint_32 width = (png_width + factor - 1) / factor;
+				const png_uint_32 height = (png_height + factor - 1) / factor;
 
-					::png_read_image(png_ptr, row_ptrs);
-					//::png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+				pixbuf_.open(width, height);
+				pixbuf_.alpha_channel(is_alpha_enabled);
 
-					std::size_t png_pixel_bytes = png_rowbytes / png_width;
+				//The following codes may longjmp while image_read error.
+				png_bytep row = new png_byte[png_width * sizeof(pixel_argb_t)];
+				unsigned * sums = new unsigned[width * sizeof(pixel_argb_t)];
+				std::memset(sums, 0, width * sizeof(pixel_argb_t) * sizeof(unsigned));
 
-					pixel_argb_t * rgb_row_ptr = pixbuf_.raw_ptr(0);
-					for (int y = 0; y < png_height; ++y)
+				png_uint_32 band_rows = 0;
+				for (png_uint_32 y = 0; y < png_height; ++y)
+				{
+					::png_read_row(png_ptr, row, nullptr);
+
+					for (png_uint_32 x = 0; x < png_width; ++x)
 					{
-						png_bytep png_ptr = row_ptrs[y];
+						auto sum = sums + (x / factor) * sizeof(pixel_argb_t);
+						auto px = row + x * sizeof(pixel_argb_t);
+						sum[0] += px[0];
+						sum[1] += px[1];
+						sum[2] += px[2];
+						sum[3] += px[3];
+					}
 
-						pixel_argb_t * rgb_end = rgb_row_ptr + png_width;
+					if ((++band_rows < factor) && (y + 1 < png_height))
+						continue;
 
-						if (is_alpha_enabled)
-						{
-							for (pixel_argb_t * i = rgb_row_ptr; i < rgb_end; ++i)
-							{
-								i->element.red = png_ptr[0];
-								i->element.green = png_ptr[1];
-								i->element.blue = png_ptr[2];
-								i->element.alpha_channel = png_ptr[3];
-								png_ptr += png_pixel_bytes;
-							}
-						}
-						else
-						{
-							for (pixel_argb_t * i = rgb_row_ptr; i < rgb_end; ++i)
-							{
-								i->element.red = png_ptr[0];
-								i->element.green = png_ptr[1];
-								i->element.blue = png_ptr[2];
-								i->element.alpha_channel = 255;
-								png_ptr += png_pixel_bytes;
-							}
-						}
-						rgb_row_ptr = rgb_end;
+					//Average every block of factor * factor pixels, the blocks at right edge may be narrower.
+					auto dst = reinterpret_cast<unsigned char*>(pixbuf_.raw_ptr(y / factor));
+					for (png_uint_32 x = 0; x < width; ++x)
+					{
+						const unsigned pixels = (std::min)(factor, png_width - x * factor) * band_rows;
+
+						auto sum = sums + x * sizeof(pixel_argb_t);
+						for (int i = 0; i < 4; ++i)
+							dst[i] = static_cast<unsigned char>((sum[i] + pixels / 2) / pixels);
+
+						dst += sizeof(pixel_argb_t);
 					}
 
-					delete[] png_pixbuf;
+					std::memset(sums, 0, width * sizeof(pixel_argb_t) * sizeof(unsigned));
+					band_rows = 0;
 				}
-				delete[] row_ptrs;
+
+				delete[] sums;
+				delete[] row;
 			}
 		public:
 			bool open(const std::experimental::filesystem::path& png_file) override
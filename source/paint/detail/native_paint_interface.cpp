@@ -15,6 +15,20 @@
 #include <nana/paint/detail/native_paint_interface.hpp>
 #include <nana/paint/pixel_buffer.hpp>
 #include <nana/gui/layout_utility.hpp>
+#include "../../threads/parallel.hpp"
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#if defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_thread.hpp>
+	#include <nana/std_mutex.hpp>
+#else
+	#include <mutex>
+	#include <thread>
+#endif
 
 #if defined(NANA_WINDOWS)
 	#include <windows.h>
@@ -28,6 +42,207 @@ namespace paint
 {
 namespace detail
 {
+	//class text_cache
+	//	A least recently used cache of text extents and glyph advances. The font is identified by its
+	//	address, a weak reference to it is kept to detect a font which is destroyed and whose address
+	//	is reused by a new font.
+	class text_cache
+	{
+		using font_type = ::nana::detail::drawable_impl_type::font_type;
+
+		//The texts longer than the limit are measured without caching, they are rarely measured repeatedly.
+		static constexpr std::size_t max_text_bytes = 1024;
+		static constexpr std::size_t capacity = 4096;
+
+		struct entry
+		{
+			std::size_t key;
+			std::weak_ptr<font_type::element_type> font;
+			unsigned tab_length;
+			bool utf8;
+			std::string text;
+
+			bool has_extents{ false };
+			nana::size extents;
+			std::vector<unsigned> glyphs;	//empty if the glyph advances are not measured.
+		};
+
+		using list_type = std::list<entry>;
+	public:
+		static text_cache& instance()
+		{
+			static text_cache obj;
+			return obj;
+		}
+
+		template<typename CharT>
+		bool fetch_extents(drawable_type dw, const CharT* text, std::size_t len, nana::size& extents)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto i = _m_find(dw, text, len);
+			if ((i == entries_.end()) || !i->has_extents)
+			{
+				++misses_;
+				return false;
+			}
+
+			++hits_;
+			extents = i->extents;
+			return true;
+		}
+
+		template<typename CharT>
+		void store_extents(drawable_type dw, const CharT* text, std::size_t len, const nana::size& extents)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto i = _m_insert(dw, text, len);
+			if (i != entries_.end())
+			{
+				i->has_extents = true;
+				i->extents = extents;
+			}
+		}
+
+		template<typename CharT>
+		bool fetch_glyphs(drawable_type dw, const CharT* text, std::size_t len, unsigned* pxbuf)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto i = _m_find(dw, text, len);
+			if ((i == entries_.end()) || i->glyphs.empty())
+			{
+				++misses_;
+				return false;
+			}
+
+			++hits_;
+			std::copy(i->glyphs.begin(), i->glyphs.end(), pxbuf);
+			return true;
+		}
+
+		template<typename CharT>
+		void store_glyphs(drawable_type dw, const CharT* text, std::size_t len, const unsigned* pxbuf, std::size_t count)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto i = _m_insert(dw, text, len);
+			if (i != entries_.end())
+				i->glyphs.assign(pxbuf, pxbuf + count);
+		}
+
+		void statistics(std::size_t& hits, std::size_t& misses, std::size_t& entries)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			hits = hits_;
+			misses = misses_;
+			entries = entries_.size();
+		}
+	private:
+		template<typename CharT>
+		static std::size_t _m_key(drawable_type dw, const CharT* text, std::size_t len)
+		{
+			//FNV-1a
+			std::size_t key = static_cast<std::size_t>(14695981039346656037ULL);
+			auto p = reinterpret_cast<const unsigned char*>(text);
+			auto const end = p + len * sizeof(CharT);
+			for (; p != end; ++p)
+				key = (key ^ *p) * static_cast<std::size_t>(1099511628211ULL);
+
+			key ^= reinterpret_cast<std::size_t>(dw->font.get()) + 0x9e3779b9 + (key << 6) + (key >> 2);
+			key ^= dw->string.tab_length + (sizeof(CharT) << 8) + (key << 6) + (key >> 2);
+			return key;
+		}
+
+		template<typename CharT>
+		static bool _m_equal(const entry& e, drawable_type dw, const CharT* text, std::size_t len)
+		{
+			return (e.utf8 == (sizeof(CharT) == 1)) && (e.tab_length == dw->string.tab_length) &&
+				(e.text.size() == len * sizeof(CharT)) &&
+				(e.font.lock() == dw->font) &&
+				(0 == std::memcmp(e.text.data(), text, e.text.size()));
+		}
+
+		template<typename CharT>
+		list_type::iterator _m_find(drawable_type dw, const CharT* text, std::size_t len)
+		{
+			if ((len * sizeof(CharT) > max_text_bytes) || !dw->font)
+				return entries_.end();
+
+			auto i = index_.find(_m_key(dw, text, len));
+			if ((i == index_.end()) || !_m_equal(*i->second, dw, text, len))
+				return entries_.end();
+
+			//Move the entry to the front as the most recently used.
+			entries_.splice(entries_.begin(), entries_, i->second);
+			return i->second;
+		}
+
+		template<typename CharT>
+		list_type::iterator _m_insert(drawable_type dw, const CharT* text, std::size_t len)
+		{
+			if ((len * sizeof(CharT) > max_text_bytes) || !dw->font)
+				return entries_.end();
+
+			auto key = _m_key(dw, text, len);
+			auto i = index_.find(key);
+			if (i != index_.end())
+			{
+				entries_.splice(entries_.begin(), entries_, i->second);
+				if (_m_equal(*i->second, dw, text, len))
+					return i->second;
+
+				//The key collides with another text, the entry is replaced.
+				entries_.pop_front();
+				index_.erase(i);
+			}
+			else if (entries_.size() >= capacity)
+			{
+				index_.erase(entries_.back().key);
+				entries_.pop_back();
+			}
+
+			entries_.emplace_front();
+			auto & e = entries_.front();
+			e.key = key;
+			e.font = dw->font;
+			e.tab_length = dw->string.tab_length;
+			e.utf8 = (sizeof(CharT) == 1);
+			e.text.assign(reinterpret_cast<const char*>(text), len * sizeof(CharT));
+
+			index_[key] = entries_.begin();
+			return entries_.begin();
+		}
+	private:
+		std::mutex mutex_;
+		list_type entries_;
+		std::unordered_map<std::size_t, list_type::iterator> index_;
+		std::size_t hits_{ 0 };
+		std::size_t misses_{ 0 };
+	};
+	//end class text_cache
+
+	bool fetch_glyph_pixels(drawable_type dw, const wchar_t* text, std::size_t len, unsigned* pxbuf)
+	{
+		return text_cache::instance().fetch_glyphs(dw, text, len, pxbuf);
+	}
+
+	bool fetch_glyph_pixels(drawable_type dw, const char* text_utf8, std::size_t len, unsigned* pxbuf)
+	{
+		return text_cache::instance().fetch_glyphs(dw, text_utf8, len, pxbuf);
+	}
+
+	void store_glyph_pixels(drawable_type dw, const wchar_t* text, std::size_t len, const unsigned* pxbuf, std::size_t count)
+	{
+		text_cache::instance().store_glyphs(dw, text, len, pxbuf, count);
+	}
+
+	void store_glyph_pixels(drawable_type dw, const char* text_utf8, std::size_t len, const unsigned* pxbuf, std::size_t count)
+	{
+		text_cache::instance().store_glyphs(dw, text_utf8, len, pxbuf, count);
+	}
+
+	void text_cache_statistics(std::size_t& hits, std::size_t& misses, std::size_t& entries)
+	{
+		text_cache::instance().statistics(hits, misses, entries);
+	}
 
 	nana::size drawable_size(drawable_type dw)
 	{
@@ -37,14 +252,8 @@ namespace detail
 		::GetObject(dw->pixmap, sizeof bmp, &bmp);
 		return nana::size(bmp.bmWidth, bmp.bmHeight);
 #elif defined(NANA_X11)
-        nana::detail::platform_spec & spec = nana::detail::platform_spec::instance();
-        Window root;
-        int x, y;
-        unsigned width, height;
-        unsigned border, depth;
-        nana::detail::platform_scope_guard psg;
-        ::XGetGeometry(spec.open_display(), dw->pixmap, &root, &x, &y, &width, &height, &border, &depth);
-		return nana::size(width, height);
+		//The pixmap may be larger than the drawable.
+		return dw->size;
 #endif
 	}
 
@@ -98,6 +307,30 @@ namespace detail
 		return bgcolor;
 	}
 
+	namespace
+	{
+		//The images which have fewer pixels are processed on the calling thread.
+		constexpr std::size_t parallel_pixels_threshold = 512 * 1024;
+	}
+
+	void parallel_rows(std::size_t rows, std::size_t pixels_per_row, const std::function<void(std::size_t, std::size_t)>& fn)
+	{
+		if (0 == rows)
+			return;
+
+		std::size_t stripes = (std::min)(static_cast<std::size_t>((std::max)(1u, std::thread::hardware_concurrency())), rows);
+		if ((rows * pixels_per_row < parallel_pixels_threshold) || (stripes < 2))
+		{
+			fn(0, rows);
+			return;
+		}
+
+		threads::detail::parallel_run(stripes, [stripes, rows, &fn](std::size_t i)
+		{
+			fn(rows * i / stripes, rows * (i + 1) / stripes);
+		});
+	}
+
 	void blend(drawable_type dw, const rectangle& area, pixel_color_t color, double fade_rate)
 	{
 		if (fade_rate <= 0)
@@ -143,11 +376,12 @@ namespace detail
 			return nana::size(size.cx, size.cy);
 #elif defined(NANA_X11)
 	#if defined(NANA_USE_XFT)
-		std::string utf8str = to_utf8(std::wstring(text, len));
+		//wchar_t is UCS-4 under X11, it is passed to Xft directly without a conversion to UTF-8
+		static_assert(sizeof(wchar_t) == sizeof(FcChar32), "wchar_t is not UCS-4");
 		XGlyphInfo ext;
 		XftFont * fs = reinterpret_cast<XftFont*>(dw->font->native_handle());
-		::XftTextExtentsUtf8(nana::detail::platform_spec::instance().open_display(), fs,
-								reinterpret_cast<XftChar8*>(const_cast<char*>(utf8str.c_str())), utf8str.size(), &ext);
+		::XftTextExtents32(nana::detail::platform_spec::instance().open_display(), fs,
+								reinterpret_cast<const FcChar32*>(text), static_cast<int>(len), &ext);
 		return nana::size(ext.xOff, fs->ascent + fs->descent);
 	#else
 		XRectangle ink;
@@ -164,17 +398,18 @@ namespace detail
 		if (nullptr == dw || nullptr == text || 0 == len)
 			return{};
 
-		nana::size extents = raw_text_extent_size(dw, text, len);
+		nana::size extents;
+		auto & cache = text_cache::instance();
+		if (cache.fetch_extents(dw, text, len, extents))
+			return extents;
 
-		const wchar_t* const end = text + len;
-		int tabs = 0;
-		for(; text != end; ++text)
-		{
-			if(*text == '\t')
-				++tabs;
-		}
+		extents = raw_text_extent_size(dw, text, len);
+
+		auto const tabs = std::count(text, text + len, L'\t');
 		if(tabs)
-			extents.width = static_cast<int>(extents.width) - tabs * static_cast<int>(dw->string.tab_pixels - dw->string.whitespace_pixels * dw->string.tab_length);
+			extents.width = static_cast<int>(extents.width) - static_cast<int>(tabs) * static_cast<int>(dw->string.tab_pixels - dw->string.whitespace_pixels * dw->string.tab_length);
+
+		cache.store_extents(dw, text, len, extents);
 		return extents;
 	}
 
@@ -183,19 +418,11 @@ namespace detail
 #if defined(NANA_WINDOWS)
 		::TextOut(dw->context, pos.x, pos.y, str, static_cast<int>(len));
 #elif defined(NANA_X11)
-		auto disp = ::nana::detail::platform_spec::instance().open_display();
 	#if defined(NANA_USE_XFT)
 		auto fs = reinterpret_cast<XftFont*>(dw->font->native_handle());
 
-		//Fixed missing array declaration by dareg
-		std::unique_ptr<FT_UInt[]> glyphs_ptr(new FT_UInt[len]);
-		auto glyphs = glyphs_ptr.get();
-		const auto endstr = str + len;
-		for(auto chr = str; chr != endstr; ++chr)
-		{
-			(*glyphs++) = XftCharIndex(disp, fs, *chr);
-		}
-		XftDrawGlyphs(dw->xftdraw, &(dw->xft_fgcolor), fs, pos.x, pos.y + fs->ascent, glyphs_ptr.get(), len);
+		//wchar_t is UCS-4, Xft maps the characters to glyphs without a temporary glyph buffer.
+		::XftDrawString32(dw->xftdraw, &(dw->xft_fgcolor), fs, pos.x, pos.y + fs->ascent, reinterpret_cast<const FcChar32*>(str), static_cast<int>(len));
 	#else
 		XFontSet fs = reinterpret_cast<XFontSet>(dw->font->native_handle());
 		XFontSetExtents * ext = ::XExtentsOfFontSet(fs);
@@ -214,6 +441,54 @@ namespace detail
 		}
 		XmbDrawString(display, dw->pixmap, reinterpret_cast<XFontSet>(dw->font->handle), dw->context, pos.x, pos.y + ascent + descent, buf, len);
 	#endif
+#endif
+	}
+
+	nana::size raw_text_extent_size(drawable_type dw, const char* text_utf8, std::size_t len)
+	{
+		if (nullptr == dw || nullptr == text_utf8 || 0 == len) return{};
+#if defined(NANA_X11) && defined(NANA_USE_XFT)
+		XGlyphInfo ext;
+		XftFont * fs = reinterpret_cast<XftFont*>(dw->font->native_handle());
+		::XftTextExtentsUtf8(nana::detail::platform_spec::instance().open_display(), fs,
+								reinterpret_cast<const XftChar8*>(text_utf8), static_cast<int>(len), &ext);
+		return nana::size(ext.xOff, fs->ascent + fs->descent);
+#else
+		//The native API requires a wide string
+		auto wstr = to_wstring(std::string(text_utf8, len));
+		return raw_text_extent_size(dw, wstr.c_str(), wstr.size());
+#endif
+	}
+
+	nana::size text_extent_size(drawable_type dw, const char* text_utf8, std::size_t len)
+	{
+		if (nullptr == dw || nullptr == text_utf8 || 0 == len)
+			return{};
+
+		nana::size extents;
+		auto & cache = text_cache::instance();
+		if (cache.fetch_extents(dw, text_utf8, len, extents))
+			return extents;
+
+		extents = raw_text_extent_size(dw, text_utf8, len);
+
+		//A tab is an ASCII character, it never appears inside a multi-byte sequence of UTF-8.
+		auto const tabs = std::count(text_utf8, text_utf8 + len, '\t');
+		if (tabs)
+			extents.width = static_cast<int>(extents.width) - static_cast<int>(tabs) * static_cast<int>(dw->string.tab_pixels - dw->string.whitespace_pixels * dw->string.tab_length);
+
+		cache.store_extents(dw, text_utf8, len, extents);
+		return extents;
+	}
+
+	void draw_string(drawable_type dw, const nana::point& pos, const char* text_utf8, std::size_t len)
+	{
+#if defined(NANA_X11) && defined(NANA_USE_XFT)
+		auto fs = reinterpret_cast<XftFont*>(dw->font->native_handle());
+		::XftDrawStringUtf8(dw->xftdraw, &(dw->xft_fgcolor), fs, pos.x, pos.y + fs->ascent, reinterpret_cast<const XftChar8*>(text_utf8), static_cast<int>(len));
+#else
+		auto wstr = to_wstring(std::string(text_utf8, len));
+		draw_string(dw, pos, wstr.c_str(), wstr.size());
 #endif
 	}
 }//end namespace detail
@@ -0,0 +1,435 @@
+/*
+ *	Scanline Rasterizer
+ *	Nana C++ Library(http://www.nanapro.org)
+ *	Copyright(C) 2003-2018 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/paint/detail/rasterizer.cpp
+ */
+
+#include <nana/paint/detail/rasterizer.hpp>
+#include <nana/paint/pixel_buffer.hpp>
+#include <nana/gui/layout_utility.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define NANA_RASTERIZER_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace nana
+{
+namespace paint
+{
+namespace detail
+{
+	namespace
+	{
+		//The coverage which is regarded as full.
+		constexpr float full_coverage = 0.998f;
+
+		//Blends a color to a pixel by a weight in range of [0, 256], the alpha channel of the pixel is kept.
+		inline void blend_pixel(pixel_color_t& px, pixel_color_t clr, unsigned weight)
+		{
+			auto const inv = 256 - weight;
+			px.element.blue = static_cast<unsigned char>((px.element.blue * inv + clr.element.blue * weight) >> 8);
+			px.element.green = static_cast<unsigned char>((px.element.green * inv + clr.element.green * weight) >> 8);
+			px.element.red = static_cast<unsigned char>((px.element.red * inv + clr.element.red * weight) >> 8);
+		}
+
+		//Fills a span of fully covered pixels.
+		void fill_span(pixel_color_t* d, std::size_t count, pixel_color_t clr, unsigned weight)
+		{
+			std::size_t i = 0;
+			if (256 == weight)
+			{
+#if defined(NANA_RASTERIZER_SSE2)
+				const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+				const __m128i rgb = _mm_set1_epi32(static_cast<int>(clr.value & 0xFFFFFF));
+				for (; i + 4 <= count; i += 4)
+				{
+					auto dp = reinterpret_cast<__m128i*>(d + i);
+					_mm_storeu_si128(dp, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(dp), alpha_mask), rgb));
+				}
+#endif
+				for (; i < count; ++i)
+					d[i].value = (d[i].value & 0xFF000000) | (clr.value & 0xFFFFFF);
+				return;
+			}
+
+#if defined(NANA_RASTERIZER_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+			const __m128i inv = _mm_set1_epi16(static_cast<short>(256 - weight));
+			const __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(clr.value)), zero), _mm_set1_epi16(static_cast<short>(weight)));
+
+			//The sums are less than 65536, because each of them is 255 * 256 at most.
+			for (; i + 4 <= count; i += 4)
+			{
+				auto dp = reinterpret_cast<__m128i*>(d + i);
+				auto v = _mm_loadu_si128(dp);
+
+				auto lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), inv), src), 8);
+				auto hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), inv), src), 8);
+
+				auto blended = _mm_packus_epi16(lo, hi);
+				_mm_storeu_si128(dp, _mm_or_si128(_mm_andnot_si128(alpha_mask, blended), _mm_and_si128(v, alpha_mask)));
+			}
+#endif
+			for (; i < count; ++i)
+				blend_pixel(d[i], clr, weight);
+		}
+	}
+
+	//class rasterizer
+	void rasterizer::clear()
+	{
+		edges_.clear();
+	}
+
+	void rasterizer::polygon(const point_type* points, std::size_t count)
+	{
+		if (count < 3)
+			return;
+
+		for (std::size_t i = 0; i < count; ++i)
+			edges_.push_back(edge{ points[i], points[(i + 1) % count] });
+	}
+
+	void rasterizer::polyline(const point_type* points, std::size_t count, double width, bool closed)
+	{
+		if ((count < 2) || (width <= 0))
+			return;
+
+		const double half = width / 2;
+		const std::size_t segments = (closed && count > 2 ? count : count - 1);
+
+		point_type prev_normal;
+		bool has_prev = false;
+		point_type first_normal;
+
+		for (std::size_t i = 0; i < segments; ++i)
+		{
+			auto const & from = points[i];
+			auto const & to = points[(i + 1) % count];
+
+			const double dx = to.x - from.x;
+			const double dy = to.y - from.y;
+			const double len = std::sqrt(dx * dx + dy * dy);
+			if (len <= 0)
+				continue;
+
+			const point_type normal{ -dy / len * half, dx / len * half };
+
+			const point_type quad[4] = {
+				{ from.x + normal.x, from.y + normal.y },
+				{ to.x + normal.x, to.y + normal.y },
+				{ to.x - normal.x, to.y - normal.y },
+				{ from.x - normal.x, from.y - normal.y }
+			};
+			_m_positive_polygon(quad, 4);
+
+			//Bevel join, the gap at the outer side of the joint is filled by a triangle. The triangle at
+			//the inner side is covered by the segments.
+			if (has_prev)
+			{
+				const point_type outer[3] = { from, { from.x + prev_normal.x, from.y + prev_normal.y }, { from.x + normal.x, from.y + normal.y } };
+				const point_type inner[3] = { from, { from.x - prev_normal.x, from.y - prev_normal.y }, { from.x - normal.x, from.y - normal.y } };
+				_m_positive_polygon(outer, 3);
+				_m_positive_polygon(inner, 3);
+			}
+			else
+				first_normal = normal;
+
+			prev_normal = normal;
+			has_prev = true;
+		}
+
+		if (closed && has_prev && count > 2)
+		{
+			auto const & v = points[0];
+			const point_type outer[3] = { v, { v.x + prev_normal.x, v.y + prev_normal.y }, { v.x + first_normal.x, v.y + first_normal.y } };
+			const point_type inner[3] = { v, { v.x - prev_normal.x, v.y - prev_normal.y }, { v.x - first_normal.x, v.y - first_normal.y } };
+			_m_positive_polygon(outer, 3);
+			_m_positive_polygon(inner, 3);
+		}
+	}
+
+	void rasterizer::round_rectangle(const point_type& left_top, const point_type& right_bottom, double radius, double width)
+	{
+		const double w = right_bottom.x - left_top.x;
+		const double h = right_bottom.y - left_top.y;
+		if (w <= 0 || h <= 0)
+			return;
+
+		radius = (std::max)(0.0, (std::min)(radius, (std::min)(w, h) / 2));
+
+		std::vector<point_type> points;
+		if (radius > 0)
+		{
+			//The arcs are approximated by segments, the error of approximation is less than a quarter of pixel.
+			const std::size_t arc_segments = (std::min)(std::size_t(64), static_cast<std::size_t>(std::ceil(std::sqrt(radius) * 2)) + 1);
+			const double half_pi = std::acos(-1) / 2;
+
+			const point_type centers[4] = {
+				{ right_bottom.x - radius, left_top.y + radius },
+				{ right_bottom.x - radius, right_bottom.y - radius },
+				{ left_top.x + radius, right_bottom.y - radius },
+				{ left_top.x + radius, left_top.y + radius }
+			};
+
+			for (std::size_t corner = 0; corner < 4; ++corner)
+			{
+				//The corners are arranged clockwise on the screen, starting at the right top corner.
+				const double start = half_pi * (static_cast<double>(corner) - 1);
+				for (std::size_t i = 0; i <= arc_segments; ++i)
+				{
+					const double angle = start + half_pi * i / arc_segments;
+					points.emplace_back(centers[corner].x + radius * std::cos(angle), centers[corner].y + radius * std::sin(angle));
+				}
+			}
+		}
+		else
+		{
+			points.emplace_back(left_top.x, left_top.y);
+			points.emplace_back(right_bottom.x, left_top.y);
+			points.emplace_back(right_bottom.x, right_bottom.y);
+			points.emplace_back(left_top.x, right_bottom.y);
+		}
+
+		if (width > 0)
+			polyline(points.data(), points.size(), width, true);
+		else
+			polygon(points.data(), points.size());
+	}
+
+	::nana::rectangle rasterizer::bounds() const
+	{
+		if (edges_.empty())
+			return{};
+
+		double left = edges_.front().from.x, right = left;
+		double top = edges_.front().from.y, bottom = top;
+
+		for (auto & e : edges_)
+		{
+			left = (std::min)(left, (std::min)(e.from.x, e.to.x));
+			right = (std::max)(right, (std::max)(e.from.x, e.to.x));
+			top = (std::min)(top, (std::min)(e.from.y, e.to.y));
+			bottom = (std::max)(bottom, (std::max)(e.from.y, e.to.y));
+		}
+
+		auto const x = static_cast<int>(std::floor(left));
+		auto const y = static_cast<int>(std::floor(top));
+		return{ x, y, static_cast<unsigned>(static_cast<int>(std::ceil(right)) - x + 1), static_cast<unsigned>(static_cast<int>(std::ceil(bottom)) - y + 1) };
+	}
+
+	void rasterizer::render(pixel_buffer& pixbuf, const point& origin, const ::nana::color& clr)
+	{
+		auto const alpha = clr.px_color().element.alpha_channel;
+		if (edges_.empty() || !pixbuf || (0 == alpha))
+			return;
+
+		auto shapes_r = bounds();
+		shapes_r.x -= origin.x;
+		shapes_r.y -= origin.y;
+
+		::nana::rectangle r;
+		if (!::nana::overlap(::nana::rectangle{ pixbuf.size() }, shapes_r, r))
+			return;
+
+		//The accumulation buffer has 2 extra columns, which are written by the edges on the right border.
+		const std::size_t width = r.width + 2;
+		cover_.assign(width * r.height, 0.0f);
+
+		const point_type offset{ static_cast<double>(origin.x + r.x), static_cast<double>(origin.y + r.y) };
+		for (auto & e : edges_)
+			_m_accumulate(e.from - offset, e.to - offset, r.width, r.height);
+
+		auto px = clr.px_color();
+		const unsigned opacity = alpha + (alpha >> 7);	//maps [0, 255] to [0, 256]
+
+		for (std::size_t y = 0; y < r.height; ++y)
+		{
+			const float* cover = cover_.data() + width * y;
+			auto d = pixbuf.raw_ptr(r.y + y) + r.x;
+
+			float acc = 0;
+			for (std::size_t x = 0; x < r.width;)
+			{
+				acc += cover[x];
+				const float coverage = (std::min)(std::fabs(acc), 1.0f);
+
+				if (coverage >= full_coverage)
+				{
+					//Collects the span of fully covered pixels.
+					auto const begin = x;
+					while (x + 1 < r.width)
+					{
+						const float next = acc + cover[x + 1];
+						if (std::fabs(next) < full_coverage)
+							break;
+
+						acc = next;
+						++x;
+					}
+
+					fill_span(d + begin, x + 1 - begin, px, opacity);
+					++x;
+					continue;
+				}
+
+				auto const weight = static_cast<unsigned>(coverage * opacity + 0.5f);
+				if (weight)
+					blend_pixel(d[x], px, weight);
+				++x;
+			}
+		}
+	}
+
+	void rasterizer::_m_positive_polygon(const point_type* points, std::size_t count)
+	{
+		double area = 0;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto const & p = points[i];
+			auto const & q = points[(i + 1) % count];
+			area += p.x * q.y - q.x * p.y;
+		}
+
+		//The overlapped parts of the polygons are filled once only if the polygons are in the same orientation.
+		if (area >= 0)
+		{
+			polygon(points, count);
+			return;
+		}
+
+		for (std::size_t i = count; i > 0; --i)
+			edges_.push_back(edge{ points[i % count], points[i - 1] });
+	}
+
+	//Accumulates the signed area covered by an edge. The sum of a row from the left to a pixel is the
+	//coverage of the pixel.
+	void rasterizer::_m_accumulate(point_type from, point_type to, std::size_t width, std::size_t height)
+	{
+		if (from.y == to.y)
+			return;
+
+		float dir = 1.0f;
+		if (from.y > to.y)
+		{
+			std::swap(from, to);
+			dir = -1.0f;
+		}
+
+		const double max_y = static_cast<double>(height);
+		if (to.y <= 0 || from.y >= max_y)
+			return;
+
+		const double dxdy = (to.x - from.x) / (to.y - from.y);
+		if (from.y < 0)
+		{
+			from.x -= from.y * dxdy;
+			from.y = 0;
+		}
+
+		if (to.y > max_y)
+		{
+			to.x -= (to.y - max_y) * dxdy;
+			to.y = max_y;
+		}
+
+		//The edge is split where it crosses the left and right borders of the buffer. The parts on the left
+		//are moved to the left border, they cover the whole row. The parts on the right are moved to the right
+		//border, they cover nothing.
+		const double max_x = static_cast<double>(width);
+
+		point_type pieces[4] = { from };
+		std::size_t count = 1;
+		for (double bound : { 0.0, max_x })
+		{
+			if ((from.x - bound) * (to.x - bound) < 0)
+				pieces[count++] = point_type{ bound, from.y + (bound - from.x) / dxdy };
+		}
+		pieces[count++] = to;
+
+		//The crossing points are sorted by y, the edge goes down.
+		if ((4 == count) && (pieces[1].y > pieces[2].y))
+			std::swap(pieces[1], pieces[2]);
+
+		for (std::size_t i = 0; i + 1 < count; ++i)
+		{
+			point_type a{ (std::max)(0.0, (std::min)(pieces[i].x, max_x)), pieces[i].y };
+			point_type b{ (std::max)(0.0, (std::min)(pieces[i + 1].x, max_x)), pieces[i + 1].y };
+			if (a.y < b.y)
+				_m_accumulate_line(a, b, dir, width, height);
+		}
+	}
+
+	void rasterizer::_m_accumulate_line(const point_type& from, const point_type& to, float dir, std::size_t width, std::size_t height)
+	{
+		const float line_dxdy = static_cast<float>((to.x - from.x) / (to.y - from.y));
+		float x = static_cast<float>(from.x);
+		const float y_from = static_cast<float>(from.y);
+		const float y_to = static_cast<float>(to.y);
+
+		const std::size_t row_width = width + 2;
+		const std::size_t y_end = (std::min)(height, static_cast<std::size_t>(std::ceil(y_to)));
+		for (auto y = static_cast<std::size_t>(y_from); y < y_end; ++y)
+		{
+			float* const row = cover_.data() + row_width * y;
+
+			const float dy = (std::min)(static_cast<float>(y + 1), y_to) - (std::max)(static_cast<float>(y), y_from);
+			const float x_next = x + line_dxdy * dy;
+			const float d = dy * dir;
+
+			const float x0 = (std::min)(x, x_next);
+			const float x1 = (std::max)(x, x_next);
+
+			const float x0_floor = std::floor(x0);
+			const auto x0i = static_cast<std::size_t>(x0_floor);
+			const float x1_ceil = std::ceil(x1);
+			const auto x1i = static_cast<std::size_t>(x1_ceil);
+
+			if (x1i <= x0i + 1)
+			{
+				//The edge is in a pixel of this row.
+				const float xmf = 0.5f * (x + x_next) - x0_floor;
+				row[x0i] += d - d * xmf;
+				row[x0i + 1] += d * xmf;
+			}
+			else
+			{
+				const float s = 1.0f / (x1 - x0);
+				const float x0f = x0 - x0_floor;
+				const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+				const float x1f = x1 - x1_ceil + 1.0f;
+				const float am = 0.5f * s * x1f * x1f;
+
+				row[x0i] += d * a0;
+				if (x1i == x0i + 2)
+					row[x0i + 1] += d * (1.0f - a0 - am);
+				else
+				{
+					const float a1 = s * (1.5f - x0f);
+					row[x0i + 1] += d * (a1 - a0);
+					for (auto xi = x0i + 2; xi < x1i - 1; ++xi)
+						row[xi] += d * s;
+
+					const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+					row[x1i - 1] += d * (1.0f - a2 - am);
+				}
+				row[x1i] += d * am;
+			}
+
+			x = x_next;
+		}
+	}
+	//end class rasterizer
+}//end namespace detail
+}//end namespace paint
+}//end namespace nana
@@ -15,6 +15,7 @@
 #include <nana/paint/graphics.hpp>
 #include <nana/paint/detail/native_paint_interface.hpp>
 #include <nana/paint/pixel_buffer.hpp>
+#include <nana/paint/detail/rasterizer.hpp>
 #include <nana/gui/layout_utility.hpp>
 #include <nana/unicode_bidi.hpp>
 #include <algorithm>
@@ -41,6 +42,177 @@ namespace paint
 {
 	namespace detail
 	{
+#if defined(NANA_X11)
+		//Returns the size of pixmap for a drawable, the headroom avoids reallocating the pixmap
+		//for each step when a window is being resized interactively.
+		static nana::size growth_capacity(const nana::size& sz)
+		{
+			auto grow = [](unsigned n)
+			{
+				n += n / 4;
+				return (n + 63) & ~63u;
+			};
+			return{ grow(sz.width), grow(sz.height) };
+		}
+
+		//Returns true if the pixmap in the specified capacity is acceptable for the size.
+		static bool fits_capacity(const nana::size& sz, const nana::size& capacity)
+		{
+			auto limit = growth_capacity(sz);
+			return (sz.width <= capacity.width && capacity.width <= limit.width &&
+					sz.height <= capacity.height && capacity.height <= limit.height);
+		}
+
+		//The pixmaps released recently by a thread. They are reused by the drawables of
+		//same size class, instead of creating the pixmap, GC and XftDraw again.
+		class drawable_pool
+		{
+		public:
+			struct entry
+			{
+				Pixmap pixmap;
+				GC context;
+	#if defined(NANA_USE_XFT)
+				XftDraw * xftdraw;
+	#endif
+				nana::size capacity;
+			};
+
+			static const std::size_t max_entries = 16;
+			static const std::size_t max_pixels = 1 << 23;
+
+			static drawable_pool& instance()
+			{
+				thread_local drawable_pool object;
+				return object;
+			}
+
+			~drawable_pool()
+			{
+				while (!entries_.empty())
+				{
+					_m_free(entries_.back());
+					entries_.pop_back();
+				}
+			}
+
+			bool take(const nana::size& sz, entry& e)
+			{
+				auto & spec = nana::detail::platform_spec::instance();
+				for (auto i = entries_.begin(); i != entries_.end();)
+				{
+					//The error of an allocation may arrive after the pixmap is given to the pool.
+					if (spec.allocation_failed(i->pixmap))
+					{
+						pixels_ -= _m_pixels(*i);
+						_m_free(*i);
+						i = entries_.erase(i);
+						continue;
+					}
+
+					if (fits_capacity(sz, i->capacity))
+					{
+						e = *i;
+						pixels_ -= _m_pixels(e);
+						entries_.erase(i);
+						return true;
+					}
+					++i;
+				}
+				return false;
+			}
+
+			void give(const entry& e)
+			{
+				if (_m_pixels(e) > max_pixels)
+				{
+					_m_free(e);
+					return;
+				}
+
+				//The most recently released is the first.
+				entries_.insert(entries_.begin(), e);
+				pixels_ += _m_pixels(e);
+
+				while (entries_.size() > max_entries || pixels_ > max_pixels)
+				{
+					pixels_ -= _m_pixels(entries_.back());
+					_m_free(entries_.back());
+					entries_.pop_back();
+				}
+			}
+
+			static void free(const entry& e)
+			{
+				_m_free(e);
+			}
+		private:
+			static std::size_t _m_pixels(const entry& e)
+			{
+				return static_cast<std::size_t>(e.capacity.width) * e.capacity.height;
+			}
+
+			static void _m_free(const entry& e)
+			{
+				auto & spec = nana::detail::platform_spec::instance();
+				Display* disp = spec.open_display();
+				if (nullptr == disp)
+					return;
+
+				nana::detail::platform_scope_guard psg;
+	#if defined(NANA_USE_XFT)
+				::XftDrawDestroy(e.xftdraw);
+	#endif
+				::XFreeGC(disp, e.context);
+				::XFreePixmap(disp, e.pixmap);
+			}
+		private:
+			std::vector<entry> entries_;
+			std::size_t pixels_{ 0 };
+		};
+
+		//Assigns a pixmap to the drawable, a pixmap in the pool is preferred. A new pixmap is not checked
+		//by a round trip, its error is filtered when it arrives and the pixmap is marked as failed. A failed
+		//pixmap is not kept in the pool, and it is reported by the next allocation or paste of the graphics.
+		static void allocate_drawable(drawable_type dw, const nana::size& sz)
+		{
+			drawable_pool::entry e;
+			if (!drawable_pool::instance().take(sz, e))
+			{
+				auto & spec = nana::detail::platform_spec::instance();
+				nana::detail::platform_scope_guard psg;
+
+				Display* disp = spec.open_display();
+				int screen = DefaultScreen(disp);
+				Window root = ::XRootWindow(disp, screen);
+
+				e.capacity = growth_capacity(sz);
+
+				auto first_serial = NextRequest(disp);
+				e.pixmap = ::XCreatePixmap(disp, root, e.capacity.width, e.capacity.height, DefaultDepth(disp, screen));
+				e.context = ::XCreateGC(disp, e.pixmap, 0, 0);
+	#if defined(NANA_USE_XFT)
+				e.xftdraw = ::XftDrawCreate(disp, e.pixmap, spec.screen_visual(), spec.colormap());
+	#endif
+				spec.watch_allocation(e.pixmap, e.context, first_serial, NextRequest(disp) - 1);
+			}
+
+			dw->pixmap = e.pixmap;
+			dw->context = e.context;
+	#if defined(NANA_USE_XFT)
+			dw->xftdraw = e.xftdraw;
+	#endif
+			dw->capacity = e.capacity;
+			dw->size = sz;
+		}
+
+		//Returns true if the allocation of the drawable's pixmap is reported failed.
+		static bool allocation_failed(drawable_type dw)
+		{
+			return (dw && nana::detail::platform_spec::instance().allocation_failed(dw->pixmap));
+		}
+#endif
+
 		struct drawable_deleter
 		{
 			void operator()(const drawable_type p) const
@@ -50,18 +222,76 @@ namespace paint
 #elif defined(NANA_X11)
 				if(p)
 				{
-					Display* disp = reinterpret_cast<Display*>(nana::detail::platform_spec::instance().open_display());
+					//The pixmap is kept for reusing
+					drawable_pool::entry e;
+					e.pixmap = p->pixmap;
+					e.context = p->context;
 	#if defined(NANA_USE_XFT)
-					::XftDrawDestroy(p->xftdraw);
+					e.xftdraw = p->xftdraw;
 	#endif
-					::XFreeGC(disp, p->context);
-					::XFreePixmap(disp, p->pixmap);
+					e.capacity = p->capacity;
+
+					//A failed pixmap is freed, the errors of freeing it are filtered.
+					if (allocation_failed(p))
+						drawable_pool::free(e);
+					else
+						drawable_pool::instance().give(e);
 					delete p;
 				}
 #endif
 			}
 		};
 		//end struct graphics_handle_deleter
+
+		//Returns true if the UTF-8 text doesn't contain a character which is equal to or greater than U+0580.
+		//The characters with RTL or AN bidi category are all beyond U+0580, such a text is
+		//rendered in logical order and the bidi reordering is unnecessary.
+		static bool is_ltr_utf8(const char* text_utf8, std::size_t len)
+		{
+			auto p = reinterpret_cast<const unsigned char*>(text_utf8);
+			return std::none_of(p, p + len, [](unsigned char ch){
+				return (ch >= 0xD6);
+			});
+		}
+
+		template<typename CharT>
+		static void draw_string_tabbed(drawable_type dw, nana::point pos, const CharT* str, std::size_t len)
+		{
+			auto const end = str + len;
+			auto i = std::find(str, end, '\t');
+#if defined(NANA_POSIX)
+			dw->update_text_color();
+#endif
+			if (i != end)
+			{
+				std::size_t tab_pixels = dw->string.tab_length * dw->string.tab_pixels;
+				while (true)
+				{
+					len = i - str;
+					if (len)
+					{
+						//Render a part that does not contains a tab
+						detail::draw_string(dw, pos, str, len);
+						pos.x += detail::raw_text_extent_size(dw, str, len).width;
+					}
+
+					str = i;
+					while (str != end && (*str == '\t'))
+						++str;
+
+					if (str != end)
+					{
+						//Now i_tab is not a tab, but a non-tab character following the previous tabs
+						pos.x += static_cast<int>(tab_pixels * (str - i));
+						i = std::find(str, end, '\t');
+					}
+					else
+						break;
+				}
+			}
+			else
+				detail::draw_string(dw, pos, str, len);
+		}
 	}//end namespace detail
 
 	//class font
@@ -302,6 +532,13 @@ namespace paint
 
 		void graphics::make(const ::nana::size& sz)
 		{
+#if defined(NANA_X11)
+			if (detail::allocation_failed(impl_->handle))
+			{
+				release();
+				throw std::bad_alloc{};
+			}
+#endif
 			if (impl_->handle == nullptr || impl_->size != sz)
 			{
 				if (sz.empty())
@@ -359,44 +596,7 @@ namespace paint
 
 				::ReleaseDC(0, hdc);
 #elif defined(NANA_X11)
-				auto & spec = nana::detail::platform_spec::instance();
-				{
-					nana::detail::platform_scope_guard psg;
-
-					spec.set_error_handler();
-
-					Display* disp = spec.open_display();
-					int screen = DefaultScreen(disp);
-					Window root = ::XRootWindow(disp, screen);
-					auto pixmap = ::XCreatePixmap(disp, root, sz.width, sz.height, DefaultDepth(disp, screen));
-					if(spec.error_code)
-					{
-						spec.rev_error_handler();
-						throw std::bad_alloc();
-					}
-					auto context = ::XCreateGC(disp, pixmap, 0, 0);
-					if (spec.error_code)
-					{
-						::XFreePixmap(disp, pixmap);
-						spec.rev_error_handler();
-						throw std::bad_alloc();
-					}
-#	if defined(NANA_USE_XFT)
-					auto xftdraw = ::XftDrawCreate(disp, pixmap, spec.screen_visual(), spec.colormap());
-					if (spec.error_code)
-					{
-						::XFreeGC(disp, context);
-						::XFreePixmap(disp, pixmap);
-
-						spec.rev_error_handler();
-						throw std::bad_alloc();
-					}
-
-					dw->xftdraw = xftdraw;
-#	endif
-					dw->pixmap = pixmap;
-					dw->context = context;
-				}
+				detail::allocate_drawable(dw.get(), sz);
 #endif
 				if(dw)
 				{
@@ -422,6 +622,24 @@ namespace paint
 
 		void graphics::resize(const ::nana::size& sz)
 		{
+#if defined(NANA_X11)
+			//The pixmap is resized in place if it is not shared with other graphics objects
+			//and the new size is within its capacity.
+			auto dw = impl_->platform_drawable.get();
+			if (detail::allocation_failed(dw))
+			{
+				release();
+				throw std::bad_alloc{};
+			}
+
+			if (dw && (!sz.empty()) && (impl_->platform_drawable.use_count() == 1) && detail::fits_capacity(sz, dw->capacity))
+			{
+				dw->size = sz;
+				impl_->size = sz;
+				impl_->changed = true;
+				return;
+			}
+#endif
 			graphics duplicate(std::move(*this));
 			make(sz);
 			bitblt(0, 0, duplicate);
@@ -455,13 +673,13 @@ namespace paint
 
 		::nana::size graphics::text_extent_size(const ::std::string& text) const
 		{
-			throw_not_utf8(text);
-			return text_extent_size(to_wstring(text));
+			return text_extent_size(text.data(), text.size());
 		}
 
 		::nana::size graphics::text_extent_size(const char* text, std::size_t len) const
 		{
-			return text_extent_size(std::string(text, text + len));
+			throw_not_utf8(text, len);
+			return detail::text_extent_size(impl_->handle, text, len);
 		}
 
 		nana::size	graphics::text_extent_size(const wchar_t* text)	const
@@ -520,6 +738,9 @@ namespace paint
 			if(nullptr == impl_->handle || nullptr == impl_->handle->context || nullptr == str || nullptr == pxbuf) return false;
 			if(len == 0) return true;
 
+			if (detail::fetch_glyph_pixels(impl_->handle, str, len, pxbuf))
+				return true;
+
 			unsigned tab_pixels = impl_->handle->string.tab_length * impl_->handle->string.whitespace_pixels;
 #if defined(NANA_WINDOWS)
 			int * dx = new int[len];
@@ -533,6 +754,7 @@ namespace paint
 				pxbuf[i] = (str[i] == '\t' ? tab_pixels : dx[i] - dx[i - 1]);
 			}
 			delete [] dx;
+			detail::store_glyph_pixels(impl_->handle, str, len, pxbuf, len);
 #elif defined(NANA_X11) && defined(NANA_USE_XFT)
 
 			auto disp = nana::detail::platform_spec::instance().open_display();
@@ -550,10 +772,78 @@ namespace paint
 				else
 					pxbuf[i] = tab_pixels;
 			}
+			detail::store_glyph_pixels(impl_->handle, str, len, pxbuf, len);
 #endif
 			return true;
 		}
 
+		bool graphics::glyph_pixels(const char* text_utf8, std::size_t len, unsigned* pxbuf) const
+		{
+			if(nullptr == impl_->handle || nullptr == impl_->handle->context || nullptr == text_utf8 || nullptr == pxbuf) return false;
+			if(len == 0) return true;
+
+#if defined(NANA_X11) && defined(NANA_USE_XFT)
+			if (detail::fetch_glyph_pixels(impl_->handle, text_utf8, len, pxbuf))
+				return true;
+
+			unsigned tab_pixels = impl_->handle->string.tab_length * impl_->handle->string.whitespace_pixels;
+			auto const pxbuf_begin = pxbuf;
+
+			auto disp = nana::detail::platform_spec::instance().open_display();
+			auto xft = reinterpret_cast<XftFont*>(impl_->handle->font->native_handle());
+
+			auto p = reinterpret_cast<const unsigned char*>(text_utf8);
+			auto const end = p + len;
+
+			XGlyphInfo extents;
+			while(p < end)
+			{
+				FcChar32 code;
+				auto bytes = ::FcUtf8ToUcs4(p, &code, static_cast<int>(end - p));
+				if(bytes <= 0)
+				{
+					//Invalid UTF-8 sequence, treat the byte as a character.
+					code = *p;
+					bytes = 1;
+				}
+				p += bytes;
+
+				if(code != '\t')
+				{
+					FT_UInt glyphs = ::XftCharIndex(disp, xft, code);
+					::XftGlyphExtents(disp, xft, &glyphs, 1, &extents);
+					*pxbuf++ = extents.xOff;
+				}
+				else
+					*pxbuf++ = tab_pixels;
+			}
+			detail::store_glyph_pixels(impl_->handle, text_utf8, len, pxbuf_begin, static_cast<std::size_t>(pxbuf - pxbuf_begin));
+			return true;
+#else
+			auto wstr = to_wstring(std::string(text_utf8, len));
+			std::unique_ptr<unsigned[]> wpx(new unsigned[wstr.size() + 1]);
+			if(!glyph_pixels(wstr.c_str(), wstr.size(), wpx.get()))
+				return false;
+
+			//Fold the surrogate pairs into one character if wchar_t is UTF-16
+			for(std::size_t i = 0; i < wstr.size(); ++i)
+			{
+				auto px = wpx[i];
+				if((sizeof(wchar_t) == 2) && (0xD800 == (wstr[i] & 0xFC00)) && (i + 1 < wstr.size()))
+					px += wpx[++i];
+				*pxbuf++ = px;
+			}
+			return true;
+#endif
+		}
+
+		graphics::text_cache_stats graphics::text_cache()
+		{
+			text_cache_stats stats;
+			detail::text_cache_statistics(stats.hits, stats.misses, stats.entries);
+			return stats;
+		}
+
 		nana::size	graphics::bidi_extent_size(const std::wstring& str) const
 		{
 			nana::size sz;
@@ -573,7 +863,10 @@ namespace paint
 
 		::nana::size graphics::bidi_extent_size(const std::string& str) const
 		{
-			return bidi_extent_size(static_cast<std::wstring>(::nana::charset(str, ::nana::unicode::utf8)));
+			if (detail::is_ltr_utf8(str.data(), str.size()))
+				return text_extent_size(str);
+
+			return bidi_extent_size(to_wstring(str));
 		}
 
 		bool graphics::text_metrics(unsigned & ascent, unsigned& descent, unsigned& internal_leading) const
@@ -832,6 +1125,9 @@ namespace paint
 					::ReleaseDC(reinterpret_cast<HWND>(dst), dc);
 				}
 #elif defined(NANA_X11)
+				if (detail::allocation_failed(impl_->handle))
+					throw std::bad_alloc{};
+
 				auto & spec = nana::detail::platform_spec::instance();
 
 				Display * display = spec.open_display();
@@ -1018,7 +1314,13 @@ namespace paint
 
 		unsigned graphics::bidi_string(const point& pos, const char* str, std::size_t len)
 		{
-			std::wstring wstr = ::nana::charset(std::string(str, str + len), ::nana::unicode::utf8);
+			if (detail::is_ltr_utf8(str, len))
+			{
+				string(pos, str, len);
+				return text_extent_size(str, len).width;
+			}
+
+			auto wstr = to_wstring(std::string(str, str + len));
 			return bidi_string(pos, wstr.data(), wstr.size());
 		}
 
@@ -1048,7 +1350,7 @@ namespace paint
 
 		void graphics::string(const point& pos, const std::string& text_utf8)
 		{
-			string(pos, to_wstring(text_utf8));
+			string(pos, text_utf8.data(), text_utf8.size());
 		}
 
 		void graphics::string(const point& pos, const std::string& text_utf8, const color& clr)
@@ -1057,44 +1359,21 @@ namespace paint
 			string(pos, text_utf8);
 		}
 
+		void graphics::string(const point& pos, const char* text_utf8, std::size_t len)
+		{
+			if (impl_->handle && text_utf8 && len)
+			{
+				throw_not_utf8(text_utf8, len);
+				detail::draw_string_tabbed(impl_->handle, pos, text_utf8, len);
+				if (impl_->changed == false) impl_->changed = true;
+			}
+		}
+
 		void graphics::string(nana::point pos, const wchar_t* str, std::size_t len)
 		{
 			if (impl_->handle && str && len)
 			{
-				auto const end = str + len;
-				auto i = std::find(str, end, '\t');
-#if defined(NANA_POSIX)
-				impl_->handle->update_text_color();
-#endif
-				if (i != end)
-				{
-					std::size_t tab_pixels = impl_->handle->string.tab_length * impl_->handle->string.tab_pixels;
-					while (true)
-					{
-						len = i - str;
-						if (len)
-						{
-							//Render a part that does not contains a tab
-							detail::draw_string(impl_->handle, pos, str, len);
-							pos.x += detail::raw_text_extent_size(impl_->handle, str, len).width;
-						}
-
-						str = i;
-						while (str != end && (*str == '\t'))
-							++str;
-
-						if (str != end)
-						{
-							//Now i_tab is not a tab, but a non-tab character following the previous tabs
-							pos.x += static_cast<int>(tab_pixels * (str - i));
-							i = std::find(str, end, '\t');
-						}
-						else
-							break;
-					}
-				}
-				else
-					detail::draw_string(impl_->handle, pos, str, len);
+				detail::draw_string_tabbed(impl_->handle, pos, str, len);
 				if (impl_->changed == false) impl_->changed = true;
 			}
 		}
@@ -1360,6 +1639,56 @@ namespace paint
 #endif
 			}
 		}
+
+		//Renders the shapes to the part of drawable which they cover, only the pixels of that part are copied.
+		static bool render_shapes(drawable_type dw, detail::rasterizer& rast, const color& clr)
+		{
+			::nana::rectangle r;
+			if (!::nana::overlap(::nana::rectangle{ detail::drawable_size(dw) }, rast.bounds(), r))
+				return false;
+
+			pixel_buffer pixbuf(dw, r);
+			rast.render(pixbuf, r.position(), clr);
+			pixbuf.paste(dw, r.position());
+			return true;
+		}
+
+		void graphics::polyline(const std::vector<basic_point<double>>& points, double width, const color& clr, bool closed)
+		{
+			if (impl_->handle)
+			{
+				detail::rasterizer rast;
+				rast.polyline(points.data(), points.size(), width, closed);
+				if (render_shapes(impl_->handle, rast, clr) && (impl_->changed == false))
+					impl_->changed = true;
+			}
+		}
+
+		void graphics::polygon(const std::vector<basic_point<double>>& points, const color& clr)
+		{
+			if (impl_->handle)
+			{
+				detail::rasterizer rast;
+				rast.polygon(points.data(), points.size());
+				if (render_shapes(impl_->handle, rast, clr) && (impl_->changed == false))
+					impl_->changed = true;
+			}
+		}
+
+		void graphics::round_rectangle(const ::nana::rectangle& r, double radius, const color& clr, bool solid)
+		{
+			if (impl_->handle && !r.empty())
+			{
+				detail::rasterizer rast;
+				if (solid)
+					rast.round_rectangle({ double(r.x), double(r.y) }, { double(r.right()), double(r.bottom()) }, radius, 0);
+				else	//The outline runs through the centers of the border pixels.
+					rast.round_rectangle({ r.x + 0.5, r.y + 0.5 }, { r.right() - 0.5, r.bottom() - 0.5 }, radius - 0.5, 1);
+
+				if (render_shapes(impl_->handle, rast, clr) && (impl_->changed == false))
+					impl_->changed = true;
+			}
+		}
 	//end class graphics
 
 	//class draw
@@ -18,11 +18,21 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <list>
+#include <map>
 #include <stdexcept>
+#include <tuple>
 
 #include <nana/paint/detail/image_impl_interface.hpp>
 #include <nana/paint/pixel_buffer.hpp>
 #include <nana/filesystem/filesystem_ext.hpp>
+#include "../threads/parallel.hpp"
+
+#if defined(STD_THREAD_NOT_SUPPORTED)
+	#include <nana/std_mutex.hpp>
+#else
+	#include <mutex>
+#endif
 
 #if defined(NANA_ENABLE_JPEG)
 #include "detail/image_jpeg.hpp"
@@ -186,18 +196,255 @@ namespace paint
 			return ptr;
 		}
 
+	namespace detail
+	{
+		//Process-wide cache of decoded images. An image object is immutable once it is opened, so the
+		//decoded pixels are shared by all the images opened from the same unchanged file with the same
+		//requested size. The least
+		//recently opened images are dropped when the decoded pixels exceed the memory budget.
+		class image_cache
+		{
+			using image_ptr = std::shared_ptr<image::image_impl_interface>;
+
+			struct key_type
+			{
+				fs::path::string_type	path;
+				nana::size				request;
+
+				bool operator<(const key_type& rhs) const
+				{
+					return std::tie(path, request.width, request.height) < std::tie(rhs.path, rhs.request.width, rhs.request.height);
+				}
+			};
+
+			struct item
+			{
+				key_type				key;
+				fs::file_time_type		mtime;
+				std::uintmax_t			bytes;
+				std::size_t				memory;
+				image_ptr				ptr;
+			};
+
+			static const std::size_t memory_budget = 64 * 1024 * 1024;
+
+			image_cache() = default;
+		public:
+			static image_cache& instance()
+			{
+				static image_cache obj;
+				return obj;
+			}
+
+			bool open(const fs::path& p, const nana::size& request, image_ptr& ptr)
+			{
+				fs::file_time_type mtime;
+				std::uintmax_t bytes;
+
+				try
+				{
+					mtime = fs::last_write_time(p);
+					bytes = fs::file_size(p);
+				}
+				catch (...)
+				{
+					return _m_decode(p, request, ptr);
+				}
+
+				key_type key{ p.native(), request };
+
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+
+					auto i = index_.find(key);
+					if (i != index_.end())
+					{
+						auto pos = i->second;
+						if (pos->mtime == mtime && pos->bytes == bytes)
+						{
+							items_.splice(items_.begin(), items_, pos);
+							ptr = pos->ptr;
+							return true;
+						}
+
+						_m_erase(i);
+					}
+				}
+
+				if (!_m_decode(p, request, ptr))
+					return false;
+
+				const auto sz = ptr->size();
+				const std::size_t memory = static_cast<std::size_t>(sz.width) * sz.height * 4;
+				if (memory > memory_budget / 4)
+					return true;
+
+				std::lock_guard<std::mutex> lock(mutex_);
+
+				//The file may be decoded by other thread at the same time.
+				auto i = index_.find(key);
+				if (i != index_.end())
+					_m_erase(i);
+
+				items_.emplace_front(item{ key, mtime, bytes, memory, ptr });
+				index_[key] = items_.begin();
+				memory_ += memory;
+
+				while (memory_ > memory_budget)
+					_m_erase(index_.find(items_.back().key));
+
+				return true;
+			}
+		private:
+			static bool _m_decode(const fs::path& p, const nana::size& request, image_ptr& ptr)
+			{
+				ptr = create_image(p);
+				if (!ptr)
+					return false;
+
+				ptr->request_size(request);
+				return ptr->open(p);
+			}
+
+			void _m_erase(std::map<key_type, std::list<item>::iterator>::iterator i)
+			{
+				memory_ -= i->second->memory;
+				items_.erase(i->second);
+				index_.erase(i);
+			}
+		private:
+			std::mutex mutex_;
+			std::list<item> items_;	//The most recently opened is at front
+			std::map<key_type, std::list<item>::iterator> index_;
+			std::size_t memory_{ 0 };
+		};
+
+		//The implementation of an image which is decoded asynchronously. It refers to the decoded
+		//image once the decoding is finished, and it is empty till then.
+		class image_async
+			: public image::image_impl_interface
+		{
+			using image_ptr = std::shared_ptr<image::image_impl_interface>;
+		public:
+			void assign(image_ptr ptr)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				ptr_ = std::move(ptr);
+			}
+
+			bool open(const fs::path&) override
+			{
+				return false;
+			}
+
+			bool open(const void*, std::size_t) override
+			{
+				return false;
+			}
+
+			bool alpha_channel() const override
+			{
+				auto ptr = _m_get();
+				return (ptr ? ptr->alpha_channel() : false);
+			}
+
+			bool empty() const override
+			{
+				auto ptr = _m_get();
+				return (ptr ? ptr->empty() : true);
+			}
+
+			void close() override
+			{
+				assign(nullptr);
+			}
+
+			nana::size size() const override
+			{
+				auto ptr = _m_get();
+				return (ptr ? ptr->size() : nana::size{});
+			}
+
+			void paste(const nana::rectangle& src_r, graph_reference dst, const point& p_dst) const override
+			{
+				auto ptr = _m_get();
+				if (ptr)
+					ptr->paste(src_r, dst, p_dst);
+			}
+
+			void stretch(const nana::rectangle& src_r, graph_reference dst, const nana::rectangle& r) const override
+			{
+				auto ptr = _m_get();
+				if (ptr)
+					ptr->stretch(src_r, dst, r);
+			}
+		private:
+			image_ptr _m_get() const
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				return ptr_;
+			}
+		private:
+			mutable std::mutex mutex_;
+			image_ptr ptr_;
+		};
+
+		static void open_async(const fs::path& path, const nana::size& request, std::shared_ptr<image::image_impl_interface>& image_ptr, std::function<void(bool)>&& ready)
+		{
+			auto async = std::make_shared<image_async>();
+			image_ptr = async;
+
+			threads::detail::shared_pool().push([path, request, async, ready]
+			{
+				std::shared_ptr<image::image_impl_interface> ptr;
+				bool opened = image_cache::instance().open(path, request, ptr);
+				if (opened)
+					async->assign(std::move(ptr));
+
+				if (ready)
+					ready(opened);
+			});
+		}
+	}//end namespace detail
+
 		bool image::open(const ::std::string& file)
 		{
-			fs::path path(file);
-			image_ptr_ = create_image(path);
-			return (image_ptr_ ? image_ptr_->open(path) : false);
+			return detail::image_cache::instance().open(fs::path{ file }, {}, image_ptr_);
 		}
 
 		bool image::open(const std::wstring& file)
 		{
-			fs::path path(file);
-			image_ptr_ = create_image(path);
-			return (image_ptr_ ? image_ptr_->open(path) : false);
+			return detail::image_cache::instance().open(fs::path{ file }, {}, image_ptr_);
+		}
+
+		bool image::open(const ::std::string& file, const nana::size& request)
+		{
+			return detail::image_cache::instance().open(fs::path{ file }, request, image_ptr_);
+		}
+
+		bool image::open(const ::std::wstring& file, const nana::size& request)
+		{
+			return detail::image_cache::instance().open(fs::path{ file }, request, image_ptr_);
+		}
+
+		void image::open_async(const ::std::string& file, std::function<void(bool)> ready)
+		{
+			detail::open_async(fs::path{ file }, {}, image_ptr_, std::move(ready));
+		}
+
+		void image::open_async(const ::std::wstring& file, std::function<void(bool)> ready)
+		{
+			detail::open_async(fs::path{ file }, {}, image_ptr_, std::move(ready));
+		}
+
+		void image::open_async(const ::std::string& file, const nana::size& request, std::function<void(bool)> ready)
+		{
+			detail::open_async(fs::path{ file }, request, image_ptr_, std::move(ready));
+		}
+
+		void image::open_async(const ::std::wstring& file, const nana::size& request, std::function<void(bool)> ready)
+		{
+			detail::open_async(fs::path{ file }, request, image_ptr_, std::move(ready));
 		}
 
 		bool image::open(const void* data, std::size_t bytes)
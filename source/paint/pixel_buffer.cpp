@@ -16,10 +16,17 @@
 #include <nana/gui/layout_utility.hpp>
 #include <nana/paint/detail/native_paint_interface.hpp>
 #include <nana/paint/detail/image_process_provider.hpp>
+#include <nana/paint/detail/rasterizer.hpp>
 
 #include <stdexcept>
 #include <cstring>
 #include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define NANA_PIXEL_BUFFER_SSE2
+	#include <emmintrin.h>
+#endif
 
 namespace nana{	namespace paint
 {
@@ -45,6 +52,154 @@ namespace nana{	namespace paint
 	}
 #endif
 
+	//Conversions of pixel formats. The alpha channels of destination pixels are kept, because
+	//the source formats don't have alpha channels.
+	namespace
+	{
+#if defined(NANA_X11)
+		//16-bits RGB format under X is 565
+		constexpr unsigned green_shift_16bits = 5;
+		constexpr unsigned green_bits_16bits = 6;
+		constexpr unsigned blue_shift_16bits = 0;
+#else
+		constexpr unsigned green_shift_16bits = 6;
+		constexpr unsigned green_bits_16bits = 5;
+		constexpr unsigned blue_shift_16bits = 1;
+#endif
+
+		//Expands the 5-bit and 6-bit channels to 8-bit, it is equal to (x * 255 / 31) and (x * 255 / 63).
+		inline unsigned expand_5bits(unsigned x)
+		{
+			return (x * 1053) >> 7;
+		}
+
+		inline unsigned expand_6bits(unsigned x)
+		{
+			return (x * 259 + 3) >> 6;
+		}
+
+		//Reduces the 8-bit channels to 5-bit and 6-bit, it is equal to (x * 31 / 255) and (x * 63 / 255).
+		inline unsigned reduce_5bits(unsigned x)
+		{
+			return (x * 7968) >> 16;
+		}
+
+		inline unsigned reduce_6bits(unsigned x)
+		{
+			return (x * 16192) >> 16;
+		}
+
+		template<unsigned Bits>
+		unsigned expand_bits(unsigned x)
+		{
+			return (5 == Bits ? expand_5bits(x) : expand_6bits(x));
+		}
+
+		//Converts a row of 24-bit pixels, the bytes of a source pixel are in order of blue, green and red if
+		//RGB is false, otherwise they are in order of red, green and blue.
+		template<bool RGB>
+		void convert_24bits(pixel_color_t* d, const unsigned char* s, std::size_t count)
+		{
+			std::size_t i = 0;
+#if defined(NANA_PIXEL_BUFFER_SSE2)
+			const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+			const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+			//4 pixels are converted per loop, and 16 bytes are read, which are 6 source pixels at most.
+			for (; i + 6 <= count; i += 4)
+			{
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 3));
+				auto lo = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+				auto hi = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+				auto px = _mm_and_si128(_mm_unpacklo_epi64(lo, hi), rgb_mask);
+
+				if (RGB)
+				{
+					px = _mm_or_si128(_mm_and_si128(px, _mm_set1_epi32(0xFF00)),
+							_mm_or_si128(_mm_slli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xFF)), 16), _mm_srli_epi32(px, 16)));
+				}
+
+				auto dp = reinterpret_cast<__m128i*>(d + i);
+				_mm_storeu_si128(dp, _mm_or_si128(px, _mm_and_si128(_mm_loadu_si128(dp), alpha_mask)));
+			}
+#endif
+			for (s += i * 3; i < count; ++i)
+			{
+				d[i].element.blue = s[RGB ? 2 : 0];
+				d[i].element.green = s[1];
+				d[i].element.red = s[RGB ? 0 : 2];
+				s += 3;
+			}
+		}
+
+		//Converts a row of 16-bit pixels.
+		void convert_16bits(pixel_color_t* d, const unsigned short* s, std::size_t count)
+		{
+			std::size_t i = 0;
+#if defined(NANA_PIXEL_BUFFER_SSE2)
+			const __m128i mask_5bits = _mm_set1_epi16(0x1F);
+			const __m128i mask_green = _mm_set1_epi16((1 << green_bits_16bits) - 1);
+			const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+			for (; i + 8 <= count; i += 8)
+			{
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+
+				auto r = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, 11), mask_5bits), _mm_set1_epi16(1053)), 7);
+				auto g = _mm_and_si128(_mm_srli_epi16(v, green_shift_16bits), mask_green);
+				if (6 == green_bits_16bits)
+					g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(259)), _mm_set1_epi16(3)), 6);
+				else
+					g = _mm_srli_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(1053)), 7);
+				auto b = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, blue_shift_16bits), mask_5bits), _mm_set1_epi16(1053)), 7);
+
+				auto bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+
+				auto dp = reinterpret_cast<__m128i*>(d + i);
+				_mm_storeu_si128(dp, _mm_or_si128(_mm_unpacklo_epi16(bg, r), _mm_and_si128(_mm_loadu_si128(dp), alpha_mask)));
+				_mm_storeu_si128(dp + 1, _mm_or_si128(_mm_unpackhi_epi16(bg, r), _mm_and_si128(_mm_loadu_si128(dp + 1), alpha_mask)));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				d[i].element.red = static_cast<unsigned char>(expand_5bits((s[i] >> 11) & 0x1F));
+				d[i].element.green = static_cast<unsigned char>(expand_bits<green_bits_16bits>((s[i] >> green_shift_16bits) & ((1 << green_bits_16bits) - 1)));
+				d[i].element.blue = static_cast<unsigned char>(expand_5bits((s[i] >> blue_shift_16bits) & 0x1F));
+			}
+		}
+
+#if defined(NANA_X11)
+		//Converts a row of pixels to 565 format
+		void convert_to_565(unsigned short* d, const pixel_color_t* s, std::size_t count)
+		{
+			std::size_t i = 0;
+#if defined(NANA_PIXEL_BUFFER_SSE2)
+			const __m128i byte_mask = _mm_set1_epi32(0xFF);
+			for (; i + 8 <= count; i += 8)
+			{
+				auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+				auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 4));
+
+				//The channels are extended to 16-bit, the values are not saturated because they are less than 256.
+				auto b = _mm_packs_epi32(_mm_and_si128(lo, byte_mask), _mm_and_si128(hi, byte_mask));
+				auto g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), byte_mask), _mm_and_si128(_mm_srli_epi32(hi, 8), byte_mask));
+				auto r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), byte_mask), _mm_and_si128(_mm_srli_epi32(hi, 16), byte_mask));
+
+				b = _mm_mulhi_epu16(b, _mm_set1_epi16(7968));
+				g = _mm_mulhi_epu16(g, _mm_set1_epi16(16192));
+				r = _mm_mulhi_epu16(r, _mm_set1_epi16(7968));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_or_si128(_mm_slli_epi16(r, 11), _mm_or_si128(_mm_slli_epi16(g, 5), b)));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				d[i] = static_cast<unsigned short>((reduce_5bits(s[i].element.red) << 11) | (reduce_6bits(s[i].element.green) << 5) | reduce_5bits(s[i].element.blue));
+			}
+		}
+#endif
+	}
+
 	struct pixel_buffer::pixel_buffer_storage
 		: private nana::noncopyable
 	{
@@ -191,117 +346,38 @@ namespace nana{	namespace paint
 				return;
 
 			auto rawptr = raw_pixel_buffer;
-			if(32 == bits_per_pixel)
+			if((32 == bits_per_pixel) && (pixel_size.width == width) && (pixel_size.height == height) && is_negative)
 			{
-				if((pixel_size.width == width) && (pixel_size.height == height) && is_negative)
-				{
-					memcpy(rawptr, rawbits, (pixel_size.width * pixel_size.height) * 4);
-				}
-				else
-				{
-					std::size_t line_bytes = (pixel_size.width < width ? pixel_size.width : width) * sizeof(pixel_color_t);
-
-					if(pixel_size.height < height)
-						height = pixel_size.height;
-
-					auto d = rawptr;
-					const unsigned char* s;
-					int src_line_bytes;
-
-					if (is_negative)
-					{
-						s = rawbits;
-						src_line_bytes = -static_cast<int>(bytes_per_line);
-					}
-					else
-					{
-						s = rawbits + bytes_per_line * (height - 1);
-						src_line_bytes = static_cast<int>(bytes_per_line);
-					}
-
-					for(std::size_t i = 0; i < height; ++i)
-					{
-						memcpy(d, s, line_bytes);
-						d += pixel_size.width;
-						s -= src_line_bytes;
-					}
-				}
+				memcpy(rawptr, rawbits, (pixel_size.width * pixel_size.height) * 4);
+				return;
 			}
-			else if(24 == bits_per_pixel)
-			{
-				if(pixel_size.width < width)
-					width = pixel_size.width;
 
-				if(pixel_size.height < height)
-					height = pixel_size.height;
+			if(pixel_size.width < width)
+				width = pixel_size.width;
 
-				auto d = rawptr;
-				const unsigned char* s;
+			if(pixel_size.height < height)
+				height = pixel_size.height;
 
-				if (is_negative)
-					s = rawbits;
-				else
-					s = rawbits + bytes_per_line * (height - 1);
+			if ((32 != bits_per_pixel) && (24 != bits_per_pixel) && (16 != bits_per_pixel))
+				return;
 
-				for(std::size_t i = 0; i < height; ++i)
-				{
-					auto p = d;
-					const auto end = p + width;
-					const unsigned char* s_p = s;
-					for(; p < end; ++p)
-					{
-						p->element.blue = s_p[0];
-						p->element.green = s_p[1];
-						p->element.red = s_p[2];
-						s_p += 3;
-					}
-					d += pixel_size.width;
-					s -= bytes_per_line;
-				}
-			}
-			else if(16 == bits_per_pixel)
+			//The rows are stored bottom-up if is_negative is false.
+			auto const dst_width = pixel_size.width;
+			detail::parallel_rows(height, width, [=](std::size_t begin, std::size_t end)
 			{
-				if(pixel_size.width < width)
-					width = pixel_size.width;
-
-				if(pixel_size.height < height)
-					height = pixel_size.height;
-
-				unsigned char rgb_table[32];
-				for(std::size_t i =0; i < 32; ++i)
-					rgb_table[i] = static_cast<unsigned char>(i * 255 / 31);
-
-				int src_bytes_per_line;
-				if (!is_negative)
+				for (auto row = begin; row < end; ++row)
 				{
-					rawbits += bytes_per_line * (height - 1);
-					src_bytes_per_line = static_cast<int>(bytes_per_line);
-				}
-				else
-					src_bytes_per_line = -static_cast<int>(bytes_per_line);
+					auto d = rawptr + dst_width * row;
+					auto s = rawbits + bytes_per_line * (is_negative ? row : height - 1 - row);
 
-				auto d = rawptr;
-				for (std::size_t i = 0; i < height; ++i)
-				{
-					auto p = d;
-					const auto end = p + width;
-					auto s_p = reinterpret_cast<const unsigned short*>(rawbits);
-					for (; p < end; ++p)
-					{
-						p->element.red = rgb_table[(*s_p >> 11) & 0x1F];
-#if defined(NANA_X11)
-						p->element.green = (*s_p >> 5) & 0x3F;
-						p->element.blue = rgb_table[*s_p & 0x1F];
-#else
-						p->element.green = rgb_table[(*s_p >> 6) & 0x1F];
-						p->element.blue = rgb_table[(*s_p >> 1) & 0x1F];
-#endif
-						++s_p;
-					}
-					d += pixel_size.width;
-					rawbits -= src_bytes_per_line;
+					if (32 == bits_per_pixel)
+						memcpy(d, s, width * sizeof(pixel_color_t));
+					else if (24 == bits_per_pixel)
+						convert_24bits<false>(d, s, width);
+					else
+						convert_16bits(d, reinterpret_cast<const unsigned short*>(s), width);
 				}
-			}
+			});
 		}
 
 #if defined(NANA_X11)
@@ -328,43 +404,29 @@ namespace nana{	namespace paint
 			else if(16 == depth)
 			{
 				//The format of Xorg 16bits depth is 565
-				std::unique_ptr<unsigned short[]> table_5_6bit_holder(new unsigned short[512]);
-				auto * const table_5bit = table_5_6bit_holder.get();
-				auto * const table_6bit = table_5_6bit_holder.get() + 256;
-				for(int i = 0; i < 256; ++i)
-				{
-					table_5bit[i] = i * 31 / 255;
-					table_6bit[i] = i * 63 / 255;
-				}
-
 				std::size_t length = width * height;
 
 				std::unique_ptr<unsigned short[]> px_holder(new unsigned short[length]);
-				unsigned short * pixbuf_16bits = px_holder.get();
+				unsigned short * const pixbuf_16bits = px_holder.get();
 
 				if(length == pixel_size.width * pixel_size.height)
 				{
-					for(auto i = raw_pixel_buffer, end = raw_pixel_buffer + length; i != end; ++i)
+					auto const src = raw_pixel_buffer;
+					detail::parallel_rows(height, width, [=](std::size_t begin, std::size_t end)
 					{
-						*(pixbuf_16bits++) = (table_5bit[i->element.red] << 11) | ( (table_6bit[i->element.green] << 5) | table_5bit[i->element.blue]);
-					}
+						convert_to_565(pixbuf_16bits + width * begin, src + width * begin, width * (end - begin));
+					});
 				}
-				else if(height)
+				else
 				{
-					unsigned sp_line_len = pixel_size.width;
-					auto sp = raw_pixel_buffer + (src_x + sp_line_len * src_y);
+					const std::size_t sp_line_len = pixel_size.width;
+					auto const sp = raw_pixel_buffer + (src_x + sp_line_len * src_y);
 
-					unsigned top = 0;
-					while(true)
+					detail::parallel_rows(height, width, [=](std::size_t begin, std::size_t end)
 					{
-						for(auto i = sp, end = sp + width; i != end; ++i)
-						{
-							*(pixbuf_16bits++) = (table_5bit[i->element.red] << 11) | (table_6bit[i->element.green] << 5) | table_5bit[i->element.blue];
-						}
-
-						if(++top < height)
-								sp += sp_line_len;
-					}
+						for (auto row = begin; row < end; ++row)
+							convert_to_565(pixbuf_16bits + width * row, sp + sp_line_len * row, width);
+					});
 				}
 
 				img->data = reinterpret_cast<char*>(px_holder.get());
@@ -484,13 +546,8 @@ namespace nana{	namespace paint
 		return (want_r.height == read_lines);
 #elif defined(NANA_X11)
 		nana::detail::platform_spec & spec = nana::detail::platform_spec::instance();
-		Window root;
-		int x, y;
-		unsigned width, height;
-		unsigned border, depth;
 		nana::detail::platform_scope_guard psg;
 		::XFlush(spec.open_display());
-		::XGetGeometry(spec.open_display(), drawable->pixmap, &root, &x, &y, &width, &height, &border, &depth);
 		XImage * image = ::XGetImage(spec.open_display(), drawable->pixmap, r.x, r.y, r.width, r.height, AllPlanes, ZPixmap);
 
 		storage_ = std::make_shared<pixel_buffer_storage>(want_r.width, want_r.height);
@@ -515,32 +572,24 @@ namespace nana{	namespace paint
 		else if(16 == image->depth)
 		{
 			//The format of Xorg 16bits depth is 565
-			std::unique_ptr<unsigned[]> table_holder{new unsigned[96]};
-			auto * const table_5bit = table_holder.get();
-			for(std::size_t i = 0; i < 32; ++i)
-				table_5bit[i] = (i * 255 / 31);
-
-			auto * const table_6bit = table_holder.get() + 32;
-			for(std::size_t i = 0; i < 64; ++i)
-				table_6bit[i] = (i* 255 / 63); 
-
 			pixbuf += (r.x - want_r.x);
 			pixbuf += (r.y - want_r.y) * want_r.width;
-			const char* img_data = image->data;
-			for(int i = 0; i < image->height; ++i)
-			{
-				const unsigned short * const px_data = reinterpret_cast<const unsigned short*>(img_data);
 
-				for(int x = 0; x < image->width; ++x)
+			auto const img_data = image->data;
+			auto const img_width = static_cast<std::size_t>(image->width);
+			auto const img_bytes_per_line = static_cast<std::size_t>(image->bytes_per_line);
+			auto const pixbuf_width = want_r.width;
+			detail::parallel_rows(image->height, img_width, [=](std::size_t begin, std::size_t end)
+			{
+				for (auto row = begin; row < end; ++row)
 				{
-					pixbuf[x].element.red	= table_5bit[(px_data[x] >> 11) & 0x1F];
-					pixbuf[x].element.green	= table_6bit[(px_data[x] >> 5) & 0x3F];
-					pixbuf[x].element.blue	= table_5bit[px_data[x] & 0x1F];
-					pixbuf[x].element.alpha_channel = 0;
+					auto const d = pixbuf + pixbuf_width * row;
+
+					//The alpha channels are cleared, the conversion keeps the alpha channels of destination.
+					std::memset(d, 0, img_width * sizeof(pixel_color_t));
+					convert_16bits(d, reinterpret_cast<const unsigned short*>(img_data + img_bytes_per_line * row), img_width);
 				}
-				img_data += image->bytes_per_line;
-				pixbuf += want_r.width;
-			}
+			});
 		}
 		else
 		{
@@ -644,46 +693,9 @@ namespace nana{	namespace paint
 			std::memcpy(row_ptr, buffer, px_count * 4);
 		}
 		else if (24 == bits_per_pixel)
-		{
-			for (auto p = row_ptr, end = row_ptr + px_count; p != end; ++p)
-			{
-				p->element.red = buffer[0];
-				p->element.green = buffer[1];
-				p->element.blue = buffer[2];
-
-				buffer += 3;
-			}
-		}
+			convert_24bits<true>(row_ptr, buffer, px_count);
 		else if (16 == bits_per_pixel)
-		{
-			unsigned char palette[32];
-			for (std::size_t i = 0; i < 32; ++i)
-				palette[i] = static_cast<unsigned char>(i * 255 / 31);
-
-#if defined(NANA_X11)
-			unsigned char palette_6bits[64];
-			for (std::size_t i = 0; i < 64; ++i)
-				palette_6bits[i] = static_cast<unsigned char>(i * 255 / 63);
-#endif
-
-			auto px = reinterpret_cast<const unsigned short*>(buffer);
-
-			for (auto p = row_ptr, end = row_ptr + px_count; p != end; ++p)
-			{
-				p->element.red = palette[(*px >> 11) & 0x1F];
-
-				//16-bits RGB format under X is 565, under Windows is 555
-#if defined(NANA_X11)
-				p->element.green = palette_6bits[(*px >> 5) & 0x3F];
-				p->element.blue = palette[*px & 0x1F];
-#else
-				p->element.green = palette[(*px >> 6) & 0x1F];
-				p->element.blue = palette[(*px >> 1) & 0x1F];
-#endif
-				++px;
-			}
-		}
-
+			convert_16bits(row_ptr, reinterpret_cast<const unsigned short*>(buffer), px_count);
 	}
 
 	void pixel_buffer::put(const unsigned char* rawbits, std::size_t width, std::size_t height, std::size_t bits_per_pixel, std::size_t bytes_per_line, bool is_negative)
@@ -1125,6 +1137,40 @@ namespace nana{	namespace paint
 			(*(sp->img_pro.blur))->process(*this, good_r, radius);
 	}
 
+	void pixel_buffer::polyline(const std::vector<basic_point<double>>& points, double width, const ::nana::color& clr, bool closed)
+	{
+		if (storage_)
+		{
+			detail::rasterizer rast;
+			rast.polyline(points.data(), points.size(), width, closed);
+			rast.render(*this, point{}, clr);
+		}
+	}
+
+	void pixel_buffer::polygon(const std::vector<basic_point<double>>& points, const ::nana::color& clr)
+	{
+		if (storage_)
+		{
+			detail::rasterizer rast;
+			rast.polygon(points.data(), points.size());
+			rast.render(*this, point{}, clr);
+		}
+	}
+
+	void pixel_buffer::round_rectangle(const ::nana::rectangle& r, double radius, const ::nana::color& clr, bool solid)
+	{
+		if (storage_ && !r.empty())
+		{
+			detail::rasterizer rast;
+			if (solid)
+				rast.round_rectangle({ double(r.x), double(r.y) }, { double(r.right()), double(r.bottom()) }, radius, 0);
+			else	//The outline runs through the centers of the border pixels.
+				rast.round_rectangle({ r.x + 0.5, r.y + 0.5 }, { r.right() - 0.5, r.bottom() - 0.5 }, radius - 0.5, 1);
+
+			rast.render(*this, point{}, clr);
+		}
+	}
+
 
 	//x' = x*cos(angle) - y*sin(angle)
 	//y' = y*cos(angle) - x*sin(angle)
@@ -1143,7 +1189,7 @@ namespace nana{	namespace paint
 		{
 		}
 
-		basic_point<double> from(const point& p)
+		basic_point<double> from(const point& p) const
 		{
 			switch (specific_)
 			{
@@ -1163,7 +1209,17 @@ namespace nana{	namespace paint
 			};
 		}
 
-		basic_point<double> to(const point& p)
+		double sin_a() const
+		{
+			return sin_a_;
+		}
+
+		double cos_a() const
+		{
+			return cos_a_;
+		}
+
+		basic_point<double> to(const point& p) const
 		{
 			switch (specific_)
 			{
@@ -1202,7 +1258,7 @@ namespace nana{	namespace paint
 		const basic_point<double> origin_;
 	};
 
-	pixel_buffer pixel_buffer::rotate(double angle, const color& extend_color)
+	pixel_buffer pixel_buffer::rotate(double angle, const color& extend_color, bool bilinear)
 	{
 		auto sp = storage_.get();
 		if (!sp)
@@ -1218,11 +1274,12 @@ namespace nana{	namespace paint
 
 		nana::size size_rotated{ sp->pixel_size };
 
+		const bool exact = (90 == angle || 180 == angle || 270 == angle);
 		if (90 == angle || 270 == angle)
 		{
 			size_rotated.shift();
 		}
-		else
+		else if (!exact)
 		{
 			point pw, ph;
 			if (angle < 180)
@@ -1240,32 +1297,130 @@ namespace nana{	namespace paint
 
 		pixel_buffer rotated_pxbuf{ size_rotated.width, size_rotated.height };
 
-		const basic_point<double> rotated_origin{ (size_rotated.width - 1) / 2.0, (size_rotated.height - 1) / 2.0 };
-
-		for (int y = 0; y < static_cast<int>(size_rotated.height); ++y)
-		{
-			auto buf = rotated_pxbuf.raw_ptr(y);
+		auto const src = reinterpret_cast<const char*>(sp->raw_pixel_buffer);
+		auto const src_bytes_per_line = sp->bytes_per_line;
+		auto const src_width = sp->pixel_size.width;
+		auto const src_height = sp->pixel_size.height;
 
-			basic_point<double> dest{ -rotated_origin.x, y - rotated_origin.y };
-			dest = dest + origin;
+		auto const dst = reinterpret_cast<char*>(rotated_pxbuf.storage_->raw_pixel_buffer);
+		auto const dst_bytes_per_line = rotated_pxbuf.storage_->bytes_per_line;
+		auto const dst_width = size_rotated.width;
 
-			const int right_point = static_cast<int>(dest.x) + static_cast<int>(size_rotated.width);
+		if (exact)
+		{
+			//The exact rotations only move the pixels. A quarter turn reads the source by columns, therefore the
+			//destination is filled in square blocks so that the touched rows of the source stay in cache.
+			const std::size_t block = 64;
+			const int turns = static_cast<int>(angle) / 90;
 
-			for (point point_dest{ static_cast<int>(dest.x), static_cast<int>(dest.y) }; point_dest.x < right_point; ++point_dest.x)
+			detail::parallel_rows(size_rotated.height, dst_width, [=](std::size_t begin, std::size_t end)
 			{
-				auto point_source = point_rotate.to(point_dest) + origin;
+				if (2 == turns)
+				{
+					for (auto y = begin; y < end; ++y)
+					{
+						auto d = reinterpret_cast<pixel_color_t*>(dst + dst_bytes_per_line * y);
+						auto s = reinterpret_cast<const pixel_color_t*>(src + src_bytes_per_line * (src_height - 1 - y)) + src_width;
+						for (auto end_d = d + dst_width; d != end_d; ++d)
+							*d = *--s;
+					}
+					return;
+				}
 
-				if (0 <= point_source.x && point_source.x <= static_cast<double>(sp->pixel_size.width - 1) && 0 <= point_source.y && point_source.y <= static_cast<double>(sp->pixel_size.height - 1))
+				for (auto block_y = begin; block_y < end; block_y += block)
 				{
-					*buf = this->raw_ptr(static_cast<std::size_t>(point_source.y))[static_cast<int>(point_source.x)];
+					auto const block_y_end = (std::min)(block_y + block, end);
+					for (std::size_t block_x = 0; block_x < dst_width; block_x += block)
+					{
+						auto const block_x_end = (std::min)(block_x + block, static_cast<std::size_t>(dst_width));
+						for (auto y = block_y; y < block_y_end; ++y)
+						{
+							auto d = reinterpret_cast<pixel_color_t*>(dst + dst_bytes_per_line * y);
+							if (1 == turns)
+							{
+								//dst(x, y) = src(width - 1 - y, x)
+								auto s = reinterpret_cast<const pixel_color_t*>(src) + (src_width - 1 - y);
+								for (auto x = block_x; x < block_x_end; ++x)
+									d[x] = *reinterpret_cast<const pixel_color_t*>(reinterpret_cast<const char*>(s) + src_bytes_per_line * x);
+							}
+							else
+							{
+								//dst(x, y) = src(y, height - 1 - x)
+								auto s = reinterpret_cast<const pixel_color_t*>(src) + y;
+								for (auto x = block_x; x < block_x_end; ++x)
+									d[x] = *reinterpret_cast<const pixel_color_t*>(reinterpret_cast<const char*>(s) + src_bytes_per_line * (src_height - 1 - x));
+							}
+						}
+					}
 				}
-				else
-					*buf = extend_color.px_color();
+			});
 
-				++buf;
-			}
+			return rotated_pxbuf;
 		}
 
+		const basic_point<double> rotated_origin{ (size_rotated.width - 1) / 2.0, (size_rotated.height - 1) / 2.0 };
+
+		//The source position is stepped along a destination row in fixed-point with 32 fractional bits,
+		//it is computed by the trigonometric functions only once for each row.
+		const double fixed_one = 4294967296.0;
+		const std::int64_t step_x = static_cast<std::int64_t>(point_rotate.cos_a() * fixed_one);
+		const std::int64_t step_y = static_cast<std::int64_t>(point_rotate.sin_a() * fixed_one);
+		const std::int64_t max_x = static_cast<std::int64_t>(src_width - 1) << 32;
+		const std::int64_t max_y = static_cast<std::int64_t>(src_height - 1) << 32;
+		const auto extend_px = extend_color.px_color();
+
+		detail::parallel_rows(size_rotated.height, dst_width, [&](std::size_t begin, std::size_t end)
+		{
+			for (auto y = begin; y < end; ++y)
+			{
+				auto buf = reinterpret_cast<pixel_color_t*>(dst + dst_bytes_per_line * y);
+
+				basic_point<double> dest{ -rotated_origin.x, static_cast<int>(y) - rotated_origin.y };
+				dest = dest + origin;
+
+				auto const point_source = point_rotate.to(point{ static_cast<int>(dest.x), static_cast<int>(dest.y) }) + origin;
+
+				auto sx = static_cast<std::int64_t>(point_source.x * fixed_one);
+				auto sy = static_cast<std::int64_t>(point_source.y * fixed_one);
+
+				for (auto end_buf = buf + dst_width; buf != end_buf; ++buf, sx += step_x, sy += step_y)
+				{
+					if (sx < 0 || sx > max_x || sy < 0 || sy > max_y)
+					{
+						*buf = extend_px;
+						continue;
+					}
+
+					auto const x = static_cast<std::size_t>(sx >> 32);
+					auto const row = src + src_bytes_per_line * static_cast<std::size_t>(sy >> 32);
+					if (!bilinear)
+					{
+						*buf = reinterpret_cast<const pixel_color_t*>(row)[x];
+						continue;
+					}
+
+					//Interpolates the 4 neighbors with 8-bit weights.
+					auto const x1 = (x + 1 < src_width ? x + 1 : x);
+					auto const next_row = (sy + (std::int64_t(1) << 32) <= max_y ? row + src_bytes_per_line : row);
+					auto const fx = static_cast<unsigned>(sx >> 24) & 0xFF;
+					auto const fy = static_cast<unsigned>(sy >> 24) & 0xFF;
+
+					auto const p00 = reinterpret_cast<const pixel_color_t*>(row)[x].value;
+					auto const p01 = reinterpret_cast<const pixel_color_t*>(row)[x1].value;
+					auto const p10 = reinterpret_cast<const pixel_color_t*>(next_row)[x].value;
+					auto const p11 = reinterpret_cast<const pixel_color_t*>(next_row)[x1].value;
+
+					unsigned value = 0;
+					for (unsigned shift = 0; shift < 32; shift += 8)
+					{
+						auto const top = ((p00 >> shift) & 0xFF) * (256 - fx) + ((p01 >> shift) & 0xFF) * fx;
+						auto const bottom = ((p10 >> shift) & 0xFF) * (256 - fx) + ((p11 >> shift) & 0xFF) * fx;
+						value |= (((top * (256 - fy) + bottom * fy) >> 16) & 0xFF) << shift;
+					}
+					buf->value = value;
+				}
+			}
+		});
 
 		return rotated_pxbuf;
 	}
@@ -603,9 +603,32 @@ namespace nana
 			text_align_ex_(text_align_ex)
 		{}
 
+		static void aligned_pos(align text_align, point& pos, unsigned width, unsigned text_px)
+		{
+			switch (text_align)
+			{
+			case align::center:
+				pos.x += static_cast<int>(width - text_px) / 2;
+				break;
+			case align::right:
+				pos.x += static_cast<int>(width - text_px);
+			default:
+				break;
+			}
+		}
+
 		// Draws a text with specified text alignment.
 		void aligner::draw(const std::string& text, point pos, unsigned width)
 		{
+			//Draws the UTF-8 text directly if it doesn't need an ellipsis.
+			auto text_px = graph_.text_extent_size(text).width;
+			if (text_px <= width)
+			{
+				aligned_pos(text_align_, pos, width, text_px);
+				graph_.bidi_string(pos, text.c_str(), text.size());
+				return;
+			}
+
 			draw(to_wstring(text), pos, width);
 		}
 
@@ -614,17 +637,7 @@ namespace nana
 			auto text_px = graph_.text_extent_size(text).width;
 			if (text_px <= width)
 			{
-				switch (text_align_)
-				{
-				case align::center:
-					pos.x += static_cast<int>(width - text_px) / 2;
-					break;
-				case align::right:
-					pos.x += static_cast<int>(width - text_px);
-				default:
-					break;
-				}
-
+				aligned_pos(text_align_, pos, width, text_px);
 				graph_.bidi_string(pos, text.c_str(), text.size());
 				return;
 			}
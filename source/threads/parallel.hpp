@@ -0,0 +1,42 @@
+/*
+ *	Parallel Execution on the Shared Thread Pool
+ *	Copyright(C) 2003-2018 Jinhao(cnjinhao@hotmail.com)
+ *
+ *	Distributed under the Boost Software License, Version 1.0.
+ *	(See accompanying file LICENSE_1_0.txt or copy at
+ *	http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *	@file: nana/threads/parallel.hpp
+ *	@brief: A private header, it is used by the library for the tasks which run in background or in parallel.
+ */
+
+#ifndef NANA_THREADS_PARALLEL_HPP
+#define NANA_THREADS_PARALLEL_HPP
+
+#include <nana/threads/pool.hpp>
+#include <functional>
+#include <cstddef>
+
+namespace nana
+{
+namespace threads
+{
+namespace detail
+{
+	/// Returns the thread pool which is shared by the library, it has a thread per core.
+	/**
+	 * The background tasks and the parallel loops use the same pool, so that they don't oversubscribe the cores.
+	 */
+	pool& shared_pool();
+
+	/// Runs fn(0) ... fn(count - 1) on the shared pool and returns when all of them are finished.
+	/**
+	 * The calling thread runs the tasks which are not started by the pool, therefore it doesn't deadlock
+	 * when it is called by a thread of the pool or when the pool is busy.
+	 */
+	void parallel_run(std::size_t count, const std::function<void(std::size_t)>& fn);
+}//end namespace detail
+}//end namespace threads
+}//end namespace nana
+
+#endif
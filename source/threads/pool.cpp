@@ -12,18 +12,23 @@
 
 #include <nana/threads/pool.hpp>
 #include <nana/system/platform.hpp>
+#include "parallel.hpp"
+#include <algorithm>
 #include <time.h>
 #include <deque>
 #include <vector>
 #include <atomic>
+#include <memory>
 
 #if defined(STD_THREAD_NOT_SUPPORTED)
+    #include <nana/std_thread.hpp>
     #include <nana/std_mutex.hpp>
     #include <nana/std_condition_variable.hpp>
 
 #else
     #include <condition_variable>
     #include <mutex>
+    #include <thread>
 #endif
 
 #if defined(NANA_WINDOWS)
@@ -413,5 +418,59 @@ namespace threads
 		}
 	//end class pool
 
+namespace detail
+{
+	pool& shared_pool()
+	{
+		static pool pool_obj((std::max)(2u, std::thread::hardware_concurrency()));
+		return pool_obj;
+	}
+
+	void parallel_run(std::size_t count, const std::function<void(std::size_t)>& fn)
+	{
+		if (count < 2)
+		{
+			if (count)
+				fn(0);
+			return;
+		}
+
+		struct state_type
+		{
+			std::atomic<std::size_t> next{ 0 };
+			std::size_t finished{ 0 };
+			std::mutex mutex;
+			std::condition_variable condition;
+		};
+
+		auto state = std::make_shared<state_type>();
+
+		//A task which is started after all the indexes are taken returns without accessing fn,
+		//so it is safe to be run after parallel_run returns.
+		auto run = [state, count, &fn]
+		{
+			while (true)
+			{
+				auto i = state->next++;
+				if (i >= count)
+					return;
+
+				fn(i);
+
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (++(state->finished) == count)
+					state->condition.notify_all();
+			}
+		};
+
+		for (std::size_t i = 1; i < count; ++i)
+			shared_pool().push(run);
+
+		run();
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->condition.wait(lock, [&state, count]{ return (state->finished == count); });
+	}
+}//end namespace detail
 }//end namespace threads
 }//end namespace nana
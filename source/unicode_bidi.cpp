@@ -1,4 +1,9 @@
 #include <nana/unicode_bidi.hpp>
+#include <nana/std_mutex.hpp>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <string>
 
 namespace nana
 {
@@ -8,497 +13,257 @@ namespace nana
 				PDF, EN, ES, ET, AN, CS, NSM, BN,
 				B, S, WS, ON};
 
-		static unsigned char charmap_0x0000_0x00C0[192] = {
-			BN, BN, BN, BN, BN, BN, BN, BN, BN, S,  B,  S,  WS, B, BN, BN,
-			BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, B,  B,  B,  S, 
-			WS, ON, ON, ET, ET, ET, ON, ON, ON, ON, ON, ES, CS, ES, CS, CS,
-			EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, CS, ON, ON, ON, ON, ON,
-			ON, L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,
-			L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  ON, ON, ON, ON, ON,
-			ON, L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,
-			L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  ON, ON, ON, ON, BN,
-			BN, BN, BN, BN, BN, B,  BN, BN, BN, BN, BN, BN, BN, BN, BN, BN,
-			BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN,
-			CS, ON, ET, ET, ET, ET, ON, ON, ON, ON, L,  ON, ON, BN, ON, ON,
-			ET, ET, EN, EN, ON, L,  ON, ON, ON, EN, L,  ON, ON, ON, ON, ON
+		//The bidi classes of BMP characters in a two-stage lookup table, generated from UnicodeData.
+		//The stage 1 is indexed by (ch >> 5) and gives a block of 32 classes in stage 2, the identical
+		//blocks are shared.
+		static const unsigned char stage1[0x10000 >> 5] = {
+			0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 9, 10, 11, 11, 11, 12, 13, 7, 7, 14,
+			7, 7, 7, 7, 15, 7, 7, 7, 7, 7, 7, 7, 16, 17, 18, 19, 20, 21, 22, 23, 21, 21, 24, 25, 26, 27, 28, 21, 21, 29, 30, 31,
+			32, 33, 34, 21, 21, 35, 11, 11, 36, 37, 38, 39, 40, 41, 42, 43, 36, 41, 44, 45, 36, 41, 46, 47, 40, 48, 49, 39, 50, 7, 51, 52,
+			7, 53, 54, 55, 7, 41, 56, 39, 7, 7, 42, 39, 7, 7, 57, 7, 7, 58, 59, 7, 7, 60, 61, 7, 62, 63, 7, 64, 65, 66, 67, 7,
+			7, 68, 69, 70, 71, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 72, 7, 73, 7, 7, 7,
+			74, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 75, 7, 7, 7, 76, 76, 77, 78, 7, 79, 80, 81,
+			82, 7, 7, 7, 7, 83, 7, 7, 84, 85, 86, 7, 7, 7, 87, 88, 89, 7, 90, 91, 7, 92, 11, 11, 93, 94, 50, 95, 96, 97, 7, 98,
+			7, 99, 7, 7, 7, 7, 100, 101, 7, 7, 7, 7, 7, 7, 11, 11, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 102, 103, 104,
+			105, 106, 107, 108, 109, 110, 11, 111, 112, 113, 114, 7, 115, 88, 88, 88, 116, 88, 88, 88, 88, 88, 88, 88, 88, 117, 7, 87, 118, 88, 88, 88,
+			88, 88, 88, 88, 119, 7, 7, 81, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 120, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88,
+			7, 7, 7, 7, 7, 7, 7, 7, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 121, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 122, 7, 7, 7, 123, 7, 7, 123, 11, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88,
+			124, 125, 7, 7, 126, 74, 7, 127, 7, 7, 7, 7, 7, 87, 88, 128, 129, 7, 130, 131, 7, 132, 133, 7, 7, 7, 7, 134, 7, 7, 135, 136,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 137, 88, 88, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 138, 88, 139, 7, 7, 7, 7, 7, 7, 7, 7, 7, 140, 7, 7, 141, 123, 7, 7, 142, 88, 143, 7, 7, 144, 7, 7, 7,
+			145, 146, 7, 147, 7, 7, 148, 149, 7, 150, 151, 84, 36, 152, 7, 7, 7, 153, 154, 7, 7, 155, 40, 156, 7, 7, 7, 7, 7, 7, 7, 157,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+			7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 158, 159, 160, 21, 21, 21, 21, 21,
+			21, 21, 21, 21, 21, 21, 21, 21, 21, 161, 21, 21, 21, 21, 21, 162, 163, 164, 165, 166, 21, 21, 21, 167, 168, 2, 2, 86, 7, 7, 169, 170
+		};
+
+		static const unsigned char stage2[171][32] = {
+			{ BN, BN, BN, BN, BN, BN, BN, BN, BN, S, B, S, WS, B, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, B, B, B, S },
+			{ WS, ON, ON, ET, ET, ET, ON, ON, ON, ON, ON, ES, CS, ES, CS, CS, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, CS, ON, ON, ON, ON, ON },
+			{ ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON },
+			{ ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, BN },
+			{ BN, BN, BN, BN, BN, B, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN },
+			{ CS, ON, ET, ET, ET, ET, ON, ON, ON, ON, L, ON, ON, BN, ON, ON, ET, ET, EN, EN, ON, L, ON, ON, ON, EN, L, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, L, L, L, L, L },
+			{ L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, ON, ON, L, L, L, L, L, L, L, L, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, L, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, ON, NSM, NSM, NSM, NSM, ET, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, R, NSM },
+			{ R, NSM, NSM, R, NSM, NSM, R, NSM, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, AN, AN, AN, AN, AN, AN, AN, AN, AN, AN, AN },
+			{ AN, AN, AN, AN, AN, ON, ON, ON, AL, ET, ET, AL, CS, AL, ON, ON, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ AN, AN, AN, AN, AN, AN, AN, AN, AN, AN, ET, AN, AN, AL, AL, AL, NSM, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, NSM, NSM, NSM, NSM, NSM, NSM, NSM, AN, ON, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, AL, AL, NSM, NSM, ON, NSM, NSM, NSM, NSM, AL, AL, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, NSM, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, AL, R, R, R, R, R, R, R, R, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, R, R, ON, ON, ON, ON, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, NSM, NSM, NSM, NSM, R, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, R, NSM, NSM, NSM, R, NSM, NSM, NSM, NSM, NSM, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, NSM, NSM, NSM, AL, AL, R, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, NSM, L, L, L },
+			{ L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, NSM, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, L },
+			{ L, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ET, ET, L, L, L, L, L, L, L, ET, NSM, NSM, NSM, NSM },
+			{ L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, ET, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, NSM },
+			{ L, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ NSM, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ET, ON, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM },
+			{ NSM, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, ET },
+			{ L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L },
+			{ L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, NSM, L, NSM, ON, ON, ON, ON, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L },
+			{ NSM, NSM, NSM, NSM, NSM, L, NSM, NSM, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L },
+			{ L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, L, NSM, NSM, NSM, NSM, NSM, NSM, L, NSM, NSM, L, L, NSM, NSM, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, NSM, NSM },
+			{ NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, L, L, NSM, NSM, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, L, L, L, L, L },
+			{ ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ WS, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L },
+			{ L, L, L, L, L, L, NSM, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, ET, L, NSM, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, NSM, NSM, NSM, WS, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, L, L, L, L, NSM, NSM, L, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, NSM, NSM, NSM, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, L, NSM, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, NSM, NSM, NSM, NSM, NSM, L, NSM, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM },
+			{ NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, NSM, NSM, NSM, L, L, NSM, NSM, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, NSM, L, NSM, NSM, L, L, L, NSM, L, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, NSM, NSM, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, NSM, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, L, ON },
+			{ ON, ON, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, WS },
+			{ WS, WS, WS, WS, WS, WS, WS, WS, WS, WS, WS, BN, BN, BN, L, R, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, WS, B, LRE, RLE, PDF, LRO, RLO, CS, ET, ET, ET, ET, ET, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, CS, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, WS },
+			{ BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, EN, L, EN, EN, EN, EN, EN, EN, EN, EN, ES, ES, ON, ON, ON, L },
+			{ EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, ES, ES, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ET, ET, ET },
+			{ ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, ET, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, L, ON, ON, ON, ON, L, ON, ON, L, L, L, L, L, L, L, L, L, L, ON, L, ON, ON, ON, L, L, L, L, L, ON, ON },
+			{ ON, ON, ON, ON, L, ON, L, ON, L, ON, L, L, L, L, ET, L, L, L, L, L, L, L, L, L, L, L, ON, ON, L, L, L, L },
+			{ ON, ON, ON, ON, ON, L, L, L, L, L, ON, ON, ON, ON, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ES, ET, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, L, L, L, L },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, L, L, L, L, L, L },
+			{ L, L, L, L, L, ON, ON, ON, ON, ON, ON, L, L, L, L, NSM, NSM, NSM, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM },
+			{ WS, ON, ON, ON, ON, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, L, L, ON, L, L, L, L, L, ON, ON, L, L, L, L, L, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, ON, ON, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, L, L, L, L },
+			{ ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, ON, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, ON, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, NSM, L, L, L, NSM, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, NSM, NSM, L, ON, ON, ON, ON, L, L, L, L, L, L, L, L, L, L, L, L, ET, ET, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ON, ON, ON, ON, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, L, NSM, NSM, NSM, NSM, L, L, NSM, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, NSM, NSM, NSM, NSM, NSM, NSM, L, L, NSM, NSM, L, L, NSM, NSM, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, NSM, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, NSM, L, NSM, NSM, NSM, L, L, NSM, NSM, L, L, L, L, L, NSM, NSM },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, NSM, NSM, L, L, L, L, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, NSM, L, L, NSM, L, L, L, L, NSM, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, R, R, R, R, R, R, NSM, R },
+			{ R, R, R, R, R, R, R, R, R, ES, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },
+			{ R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, ON, ON },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, ON, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, NSM, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, NSM, NSM, NSM, NSM, NSM, NSM },
+			{ NSM, NSM, NSM, NSM, NSM, NSM, NSM, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON },
+			{ ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, CS, ON, CS, ON, ON, CS, ON, ON, ON, ON, ON, ON, ON, ON, ON, ET },
+			{ ON, ON, ES, ES, ON, ON, ON, ON, ON, ET, ET, ON, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL },
+			{ AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, ON, ON, BN },
+			{ ON, ON, ON, ET, ET, ET, ON, ON, ON, ON, ON, ES, CS, ES, CS, CS, EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, CS, ON, ON, ON, ON, ON },
+			{ L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L, ET, ET, ET },
+			{ ET, ET, ON, ON, ON, ET, ET, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON, ON }
 		};
 
 		t bidi_char_type(wchar_t ch)
 		{
-			if(ch <= 0x0FC6)
-			{
-				if(ch < 0x00C0)	return static_cast<bidi_charmap::t>(charmap_0x0000_0x00C0[ch]);
-				if(ch == 0x00D7 || ch == 0x00F7) return ON;
-				if(ch <= 0x02B8) return L;	//N = 449
-				if(ch <= 0x02BA) return ON;	//N = 2
-				if(ch <= 0x02C1) return L;	//N = 7
-				if(ch <= 0x02CF) return ON;	//N = 14
-				if(ch <= 0x02D1) return L;	//N = 2
-				if(ch <= 0x02DF) return ON;	//N = 14
-				if(ch <= 0x02E4) return L;	//N = 5
-				if(0x02EE == ch) return L;
-				if(ch <= 0x02FF) return ON;	//N = 17
-				if(ch <= 0x036F) return NSM;	//N = 112
-				if(ch <= 0x0373) return L;	//N = 4
-				if(ch <= 0x0375) return ON;	//N = 2
-				if(ch <= 0x037D) return L;	//N = 8
-				if(ch <= 0x0385) return ON;	//N = 8
-				if(0x0387 == ch || 0x03F6 == ch) return ON;
-				if(ch <= 0x0482) return L;	//N = 140
-				if(ch <= 0x0489) return NSM;	//N = 7
-				if(ch <= 0x0589) return L;	//N = 256
-				if(0x058A == ch) return ON;
-				if(0x058F == ch) return ET;
-				if(0x05BE == ch || 0x05C0 == ch || 0x05C3 == ch || 0x05C6 == ch) return R;
-				if(ch <= 0x05C7) return NSM;
-				if(ch <= 0x05F4) return R;	//N = 37
-				if(ch <= 0x0604) return AN;	//N = 5
-				if(ch <= 0x0607) return ON;	//N = 2
-				if(0x0608 == ch) return AL;
-				if(ch <= 0x060A) return ET;	//N = 2
-				if(0x060B == ch) return AL;
-				if(0x060C == ch) return CS;
-				if(0x060D == ch) return AL;
-				if(ch <= 0x060F) return ON;		//N = 2
-				if(ch <= 0x061A) return NSM;	//N = 11
-				if(ch <= 0x064A) return AL;		//N = 48
-				if(ch <= 0x065F) return NSM;	//N = 21
-				if (0x066A == ch) return ET;
-				if(ch <= 0x066C) return AN;	//N = 2
-				if (0x0670 == ch) return NSM;
-				if(ch <= 0x06D5) return AL;	//N = 101
-				if(0x06DD == ch) return AN;
-				if(0x06DE == ch) return ON;
-				if(ch <= 0x06E4) return NSM;	//N = 6
-				if(ch <= 0x06E6) return AL;	//N = 2
-				if(0x06E9 == ch) return ON;
-				if(ch <= 0x06ED) return NSM;	//N = 4
-				if(ch <= 0x06EF) return AL;	//N = 2
-				if(ch <= 0x06F9) return EN;	//N = 10
-				if(0x0711 == ch) return NSM;
-				if(ch <= 0x072F) return AL;	//N = 30
-				if(ch <= 0x074A) return NSM;	//N = 27
-				if(ch <= 0x07A5) return AL;	//N = 89
-				if(ch <= 0x07B0) return NSM;	//N = 11
-				if(0x07B1 == ch) return AL;
-				if(ch <= 0x07EA) return R;	//N = 43
-				if(ch <= 0x07F3) return NSM;	//N = 9
-				if(ch <= 0x07F5) return R;	//N = 2
-				if(ch <= 0x07F9) return ON;	//N = 4
-				if(ch <= 0x0815) return R;	//N = 28
-				if(0x081A == ch || 0x0824 == ch || 0x0828 == ch) return R;
-				if(ch <= 0x082D) return NSM;	//N = 5
-				if(ch <= 0x0858) return R;	//N = 41
-				if(ch <= 0x085B) return NSM;	//N = 3
-				if(0x085E == ch) return R;
-				if(ch <= 0x08AC) return AL;	//N = 13
-				if(ch <= 0x0902) return NSM;	//N = 31
-				if(0x093A == ch || 0x093C == ch) return NSM;
-				if(ch <= 0x0940) return L;	//N = 4
-				if(ch <= 0x0948) return NSM;	//N = 8
-				if(0x094D == ch) return NSM;
-				if(ch <= 0x0950) return L;	//N = 3
-				if(ch <= 0x0957) return NSM;	//N = 7
-				if(ch <= 0x0961) return L;	//N = 10
-				if(ch <= 0x0963) return NSM;	//N = 2
-				if(0x0981 == ch || 0x09BC == ch) return NSM;
-				if(ch <= 0x09C0) return L;	//N = 4
-				if(ch <= 0x09C4) return NSM;	//N = 4
-				if(0x09CD == ch) return NSM;
-				if(ch <= 0x09E1) return L;	//N = 20
-				if(ch <= 0x09E3) return NSM;	//N = 2
-				if(ch <= 0x09F1) return L;	//N = 12
-				if(ch <= 0x09F3) return ET;	//N = 2
-				if(ch <= 0x09FA) return L;	//N = 7
-				if(0x09FB == ch) return ET;
-				if(ch <= 0x0A02) return NSM;	//N = 2
-				if(0x0A3C == ch) return NSM;
-				if(ch <= 0x0A40) return L;	//N = 3
-				if(ch <= 0x0A51) return NSM;	//N = 17
-				if(ch <= 0x0A6F) return L;	//N = 23
-				if(ch <= 0x0A71) return NSM;	//N = 2
-				if(ch <= 0x0A74) return L;	//N = 3
-				if(ch <= 0x0A82) return NSM;	//N = 14
-				if(0x0ABC == ch) return NSM;
-				if(ch <= 0x0AC0) return L;	//N = 4
-				if(ch <= 0x0AC8) return NSM;	//N = 8
-				if(0x0ACD == ch) return NSM;
-				if(ch <= 0x0AE1) return L;	//N = 18
-				if(ch <= 0x0AE3) return NSM;	//N = 2
-				if(0x0AF1 == ch) return ET;
-				if(0x0B01 == ch || 0x0B3C == ch || 0x0B3F == ch) return NSM;
-				if(ch <= 0x0B40) return L;
-				if(ch <= 0x0B44) return NSM;	//N = 4
-				if(ch <= 0x0B4C) return L;	//N = 6
-				if(ch <= 0x0B56) return NSM;	//N = 10
-				if(ch <= 0x0B61) return L;	//N = 11
-				if(ch <= 0x0B63) return NSM;	//N = 2
-				if(0x0B82 == ch || 0x0BC0 == ch || 0x0BCD == ch) return NSM;
-				if(ch <= 0x0BF2) return L;	//N = 35
-				if(0x0BF9 == ch) return ET;
-				if(ch <= 0x0BFA) return ON;
-				if(ch <= 0x0C3D) return L;	//N = 61
-				if(ch <= 0x0C40) return NSM;	//N = 3
-				if(ch <= 0x0C44) return L;	//N = 4
-				if(ch <= 0x0C56) return NSM;	//N = 17
-				if(ch <= 0x0C61) return L;	//N = 10
-				if(ch <= 0x0C63) return NSM;	//N = 2
-				if(ch <= 0x0C6F) return L;	//N = 10
-				if(ch <= 0x0C7E) return ON;	//N = 7
-				if(0x0CBC == ch) return NSM;
-				if(ch <= 0x0CCB) return L;	//N = 15
-				if(ch <= 0x0CCD) return NSM;	//N = 2
-				if(ch <= 0x0CE1) return L;	//N = 13
-				if(ch <= 0x0CE3) return NSM;	//N = 2
-				if(ch <= 0x0D40) return L;	//N = 91
-				if(ch <= 0x0D44) return NSM;	//N = 4
-				if(0x0D4D == ch) return NSM;
-				if(ch <= 0x0D61) return L;	//N = 20
-				if(ch <= 0x0D63) return NSM;	//N = 2
-				if(0x0DCA == ch) return NSM;
-				if(ch <= 0x0DD1) return L;	//N = 3
-				if(ch <= 0x0DD6) return NSM;	//N = 5
-				if(0x0E31 == ch) return NSM;
-				if(ch <= 0x0E33) return L;	//N = 2
-				if(ch <= 0x0E3A) return NSM;	//N = 7
-				if(0x0E3F == ch) return ET;
-				if(ch <= 0x0E46) return L;	//N = 7
-				if(ch <= 0x0E4E) return NSM;	//N = 8
-				if(0x0EB1 == ch) return NSM;
-				if(ch <= 0x0EB3) return L;	//N = 2
-				if(ch <= 0x0EBC) return NSM;	//N = 9
-				if(ch <= 0x0EC6) return L;	//N = 10
-				if(ch <= 0x0ECD) return NSM;	//N = 6
-				if(ch <= 0x0F17) return L;	//N = 72
-				if(ch <= 0x0F19) return NSM;	//N = 2
-				if(ch <= 0x0F34) return L;	//N = 27
-				if(ch <= 0x0F39) return (ch & 1 ? NSM : L);
-				if(ch <= 0x0F3D) return ON;	//N = 4
-				if(ch <= 0x0F6C) return L;	//N = 47
-				if(0x0F7F == ch || 0x0F85 == ch) return L;
-				if(ch <= 0x0F87) return NSM;	//N = 2
-				if(ch <= 0x0F8C) return L;	//N = 5
-				if(ch <= 0x0FBC) return NSM;	//N = 48
-				if(ch <= 0x0FC5) return L;	//N = 8
-				if(0x0FC6 == ch) return NSM;
-			}
+			auto const code = static_cast<unsigned long>(ch);
+			if (code > 0xFFFF)
+				return ON;
 
-			if(ch <= 0x1FFE)
-			{
-				if(ch <= 0x102C) return L;	//N = 102
-				if(0x1031 == ch || 0x1038 == ch) return L;
-				if(ch <= 0x103A) return NSM;	//N = 2
-				if(ch <= 0x103C) return L;	//N = 2
-				if(ch <= 0x103E) return NSM;	//N = 2
-				if(ch <= 0x1057) return L;	//N = 25
-				if(ch <= 0x1059) return NSM;	//N = 2
-				if(ch <= 0x105D) return L;	//N = 4
-				if(ch <= 0x1060) return NSM;	//N = 3
-				if(ch <= 0x1070) return L;	//N = 16
-				if(ch <= 0x1074) return NSM;	//N = 4
-				if(0x1082 == ch) return NSM;
-				if(ch <= 0x1084) return L;	//N = 2
-				if(ch <= 0x1086) return NSM;	//N = 2
-				if(0x108D == ch || 0x109D == ch) return NSM;
-				if(ch <= 0x135A) return L;	//N = 701
-				if(ch <= 0x135F) return NSM;	//N = 3
-				if(ch <= 0x138F) return L;	//N = 48
-				if(ch <= 0x1399) return ON;	//N = 10
-				if(0x1400 == ch) return ON;
-				if(0x1680 == ch) return WS;
-				if(ch <= 0x169A) return L;	//N = 26
-				if(ch <= 0x169C) return ON;	//N = 2
-				if(ch <= 0x1711) return L;	//N = 114
-				if(ch <= 0x1714) return NSM;	//N = 3
-				if(ch <= 0x1731) return L;	//N = 18
-				if(ch <= 0x1734) return NSM;	//N = 3
-				if(ch <= 0x1751) return L;	//N = 29
-				if(ch <= 0x1753) return NSM;	//N = 2
-				if(ch <= 0x1770) return L;	//N = 17
-				if(ch <= 0x1773) return NSM;	//N = 2
-				if(ch <= 0x17B3) return L;	//N = 52
-				if(0x17B6 == ch) return L;
-				if(ch <= 0x17BD) return NSM;	//N = 7
-				if(0x17C6 == ch) return NSM;
-				if(ch <= 0x17C8) return L;	//N = 2
-				if(ch <= 0x17D3) return NSM;	//N = 11
-				if(0x17DB == ch) return ET;
-				if(0x17DD == ch) return NSM;
-				if(ch <= 0x17E9) return L;	//N = 10
-				if(ch <= 0x180A) return ON;	//N = 27
-				if(ch <= 0x180D) return NSM;	//N = 3
-				if(0x180E == ch) return WS;
-				if(0x18A9 == ch) return NSM;
-				if(ch <= 0x191C) return L;	//N = 115
-				if(ch <= 0x1922) return NSM;	//N = 3
-				if(ch <= 0x1926) return L;	//N = 4
-				if(ch <= 0x1928) return NSM;	//N = 2
-				if(0x1932 == ch) return NSM;
-				if(ch <= 0x1938) return L;	//N = 6
-				if(ch <= 0x193B) return NSM;	//N = 3
-				if(ch <= 0x1945) return ON;	//N = 6
-				if(ch <= 0x19DA) return L;	//N = 149
-				if(ch <= 0x19FF) return ON;	//N = 34
-				if(ch <= 0x1A16) return L;	//N = 23
-				if(ch <= 0x1A18) return NSM;	//N = 2
-				if(ch <= 0x1A55) return L;	//N = 61
-				if(0x1A57 == ch) return L;	
-				if(ch <= 0x1A60) return NSM;	//N = 9
-				if(0x1A62 == ch) return NSM;
-				if(ch <= 0x1A64) return L;	//N = 2
-				if(ch <= 0x1A6C) return NSM;	//N = 8
-				if(ch <= 0x1A72) return L;	//N = 6
-				if(ch <= 0x1A7F) return NSM;	//N = 13
-				if(ch <= 0x1AAD) return L;	//N = 46
-				if(ch <= 0x1B03) return NSM;	//N = 4
-				if(ch <= 0x1B33) return L;	//N = 48
-				if(0x1B35 == ch || 0x1B3B == ch) return L;
-				if(ch <= 0x1B3C) return NSM;
-				if(0x1B42 == ch) return NSM;
-				if(ch <= 0x1B6A) return L;	//N = 40
-				if(ch <= 0x1B73) return NSM;	//N = 9
-				if(ch <= 0x1B7C) return L;	//N = 9
-				if(ch <= 0x1B81) return NSM;	//N = 2
-				if(ch <= 0x1BA1) return L;	//N = 32
-				if(ch <= 0x1BA5) return NSM;	//N = 4
-				if(ch <= 0x1BA7) return L;	//N = 2
-				if(ch <= 0x1BA9) return NSM;	//N = 2
-				if(0x1BAB == ch || 0x1BE6 == ch) return NSM;
-				if(ch <= 0x1BE7) return L;
-				if(ch <= 0x1BE9) return NSM;	//N = 2
-				if(ch <= 0x1BEC) return L;	//N = 3
-				if(0x1BEE == ch) return L;
-				if(ch <= 0x1BF1) return NSM;	//N = 3
-				if(ch <= 0x1C2B) return L;	//N = 58
-				if(ch <= 0x1C33) return NSM;	//N = 8
-				if(ch <= 0x1C35) return L;	//N = 2
-				if(ch <= 0x1C37) return NSM;	//N = 2
-				if(ch <= 0x1CC7) return L;	//N = 141
-				if(0x1CD3 == ch || 0x1CE1 == ch) return L;
-				if(ch <= 0x1CE8) return NSM;	//N = 7
-				if(0x1CED == ch || 0x1CF4 == ch) return NSM;
-				if(ch <= 0x1DBF) return L;	//N = 203
-				if(ch <= 0x1DFF) return NSM;	//N = 64
-				if(ch <= 0x1FBC) return L;	//N = 445
-				if(0x1FBE == ch) return L;
-				if(ch <= 0x1FC1) return ON;	//N = 3
-				if(ch <= 0x1FCC) return L;	//N = 11
-				if(ch <= 0x1FCF) return ON;	//N = 3
-				if(ch <= 0x1FDB) return L;	//N = 12
-				if(ch <= 0x1FDF) return ON;	//N = 3
-				if(ch <= 0x1FEC) return L;	//N = 13
-				if(ch <= 0x1FEF) return ON;	//N = 3
-				if(ch <= 0x1FFC) return L;	//N = 11
-				if(ch <= 0x1FFE) return ON;	//N = 2
-			}
-			if(ch <= 0x200A) return WS;	//N = 11
-			if(ch <= 0x200D) return BN;	//N = 3
-			if(0x200E == ch) return L;
-			if(0x200F == ch) return R;
-			if(ch <= 0x2027) return ON;	//N = 24
-			if(0x2028 == ch) return WS;
-			if(0x2029 == ch) return B;
-			if(0x202A == ch) return LRE;
-			if(0x202B == ch) return RLE;
-			if(0x202C == ch) return PDF;
-			if(0x202D == ch) return LRO;
-			if(0x202E == ch) return RLO;
-			if(0x202F == ch) return CS;
-			if(ch <= 0x2034) return ET;	//N = 5
-			if(ch <= 0x2043) return ON;	//N = 15
-			if(0x2044 == ch) return CS;
-			if(ch <= 0x205E) return ON;	//N = 26
-			if(0x205F == ch) return WS;
-			if(ch <= 0x206F) return BN;	//N = 16
-			if(0x2070 == ch) return EN;
-			if(0x2071 == ch) return L;
-			if(ch <= 0x2079) return EN;	//N = 6
-			if(ch <= 0x207B) return ES;	//N = 2
-			if(ch <= 0x207E) return ON;	//N = 3
-			if(0x207F == ch) return L;
-			if(ch <= 0x2089) return EN;	//N = 10
-			if(ch <= 0x208B) return ES;	//N = 2
-			if(ch <= 0x208E) return ON;	//N = 3
-			if(ch <= 0x209C) return L;	//N = 13
-			if(ch <= 0x20B9) return ET;	//N = 26
-			if(ch <= 0x20F0) return NSM;	//N = 33
-			if(0x2102 == ch) return L;
-			if(0x2107 == ch) return L;
-			if(ch <= 0x2109) return ON;	//N = 2
-			if(ch <= 0x2113) return L;	//N = 10
-			if(0x2115 == ch) return L;
-			if(ch <= 0x2118) return ON;	//N = 3
-			if(ch <= 0x211D) return L;	//N = 5
-			if(ch <= 0x2123) return ON;	//N = 6
-			if(ch <= 0x2129) return (ch & 1 ? ON : L);
-			if(0x212E == ch) return ET;
-			if(ch <= 0x2139) return L;	//N = 11
-			if(ch <= 0x213B) return ON;	//N = 2
-			if(ch <= 0x213F) return L;	//N = 4
-			if(ch <= 0x2144) return ON;	//N = 5
-			if(ch <= 0x2149) return L;	//N = 5
-			if(ch <= 0x214D) return ON;	//N = 4
-			if(ch <= 0x214F) return L;	//N = 2
-			if(ch <= 0x215F) return ON;	//N = 16
-			if(ch <= 0x2188) return L;	//N = 41
-			if(ch <= 0x2211) return ON;	//N = 137
-			if(0x2212 == ch) return ES;
-			if(0x2213 == ch) return ET;
-			if(ch <= 0x2335) return ON;	//N = 290
-			if(ch <= 0x237A) return L;	//N = 69
-			if(0x2395 == ch) return L;
-			if(ch <= 0x2487) return ON;	//N = 242
-			if(ch <= 0x249B) return EN;	//N = 20
-			if(ch <= 0x24E9) return L;	//N = 78
-			if(0x26AC == ch) return L;
-			if(ch <= 0x27FF) return ON;	//N = 339
-			if(ch <= 0x28FF) return L;	//N = 256
-			if(ch <= 0x2B59) return ON;	//N = 602
-			if(ch <= 0x2CE4) return L;	//N = 229
-			if(ch <= 0x2CEA) return ON;	//N = 6
-			if(ch <= 0x2CEE) return L;	//N = 4
-			if(ch <= 0x2CF1) return NSM;	//N = 3
-			if(ch <= 0x2CF3) return L;	//N = 2
-			if(ch <= 0x2CFF) return ON;	//N = 7
-			if(0x2D7F == ch) return NSM;
-			if(ch <= 0x2DDE) return L;	//N = 95
-			if(ch <= 0x2DFF) return NSM;	//N = 32
-			if(0x3000 == ch) return WS;
-			if(ch <= 0x3004) return ON;	//N = 4
-			if(ch <= 0x3007) return L;	//N = 3
-			if(ch <= 0x3020) return ON;	//N = 25
-			if(ch <= 0x3029) return L;	//N = 9
-			if(ch <= 0x302D) return NSM;	//N = 4
-			if(0x3030 == ch) return ON;
-			if(ch <= 0x3035) return L;	//N = 5
-			if(ch <= 0x3037) return ON;	//N = 2
-			if(ch <= 0x303C) return L;	//N = 5
-			if(ch <= 0x303F) return ON;	//N = 3
-			if(ch <= 0x3096) return L;	//N = 86
-			if(ch <= 0x309A) return NSM;	//N = 2
-			if(ch <= 0x309C) return ON;	//N = 2
-			if(0x30A0 == ch) return ON;
-			if(0x30FB == ch) return ON;
-			if(ch <= 0x31BA) return L;	//N = 191
-			if(ch <= 0x31E3) return ON;	//N = 36
-			if(ch <= 0x321C) return L;	//N = 45
-			if(ch <= 0x321E) return ON;	//N = 2
-			if(ch <= 0x324F) return L;	//N = 48
-			if(ch <= 0x325F) return ON;	//N = 16
-			if(ch <= 0x327B) return L;	//N = 28
-			if(ch <= 0x327E) return ON;	//N = 3
-			if(ch <= 0x32B0) return L;	//N = 50
-			if(ch <= 0x32BF) return ON;	//N = 15
-			if(ch <= 0x32CB) return L;	//N = 12
-			if(ch <= 0x32CF) return ON;	//N = 4
-			if(ch <= 0x3376) return L;	//N = 167
-			if(ch <= 0x337A) return ON;	//N = 4
-			if(ch <= 0x33DD) return L;	//N = 99
-			if(ch <= 0x33DF) return ON;	//N = 2
-			if(0x33FF == ch) return ON;
-			if(ch <= 0x4DB5) return L;	//N = 6582
-			if(ch <= 0x4DFF) return ON;	//N = 64
-			if(ch <= 0xA48C) return L;	//N = 22157
-			if(ch <= 0xA4C6) return ON;	//N = 55
-			if(ch <= 0xA60C) return L;	//N = 317
-			if(ch <= 0xA60F) return ON;	//N = 3
-			if(ch <= 0xA66E) return L;	//N = 95
-			if(0xA673 == ch) return ON;
-			if(ch <= 0xA67D) return NSM;	//N = 10
-			if(ch <= 0xA67F) return ON;	//N = 2
-			if(0xA69F == ch) return NSM;
-			if(ch <= 0xA6EF) return L;	//N = 80
-			if(ch <= 0xA6F1) return NSM;	//N = 2
-			if(ch <= 0xA6F7) return L;	//N = 6
-			if(ch <= 0xA721) return ON;	//N = 34
-			if(0xA788 == ch) return ON;
-			if(0xA802 == ch) return NSM;
-			if(0xA806 == ch) return NSM;
-			if(0xA80B == ch) return NSM;
-			if(ch <= 0xA824) return L;	//N = 25
-			if(ch <= 0xA826) return NSM;	//N = 2
-			if(0xA827 == ch) return L;
-			if(ch <= 0xA82B) return ON;	//N = 4
-			if(ch <= 0xA837) return L;	//N = 8
-			if(ch <= 0xA839) return ET;	//N = 2
-			if(ch <= 0xA873) return L;	//N = 52
-			if(ch <= 0xA877) return ON;	//N = 4
-			if(0xA8C4 == ch) return NSM;
-			if(ch <= 0xA8D9) return L;	//N = 12
-			if(ch <= 0xA8F1) return NSM;	//N = 18
-			if(ch <= 0xA925) return L;	//N = 52
-			if(ch <= 0xA92D) return NSM;	//N = 8
-			if(ch <= 0xA946) return L;	//N = 25
-			if(ch <= 0xA951) return NSM;	//N = 11
-			if(ch <= 0xA97C) return L;	//N = 43
-			if(ch <= 0xA982) return NSM;	//N = 3
-			if(0xA9B3 == ch) return NSM;
-			if(ch <= 0xA9B5) return L;	//N = 2
-			if(ch <= 0xA9B9) return NSM;	//N = 4
-			if(0xA9BC == ch) return NSM;
-			if(ch <= 0xAA28) return L;	//N = 108
-			if(ch <= 0xAA2E) return NSM;	//N = 6
-			if(ch <= 0xAA30) return L;	//N = 2
-			if(ch <= 0xAA32) return NSM;	//N = 2
-			if(ch <= 0xAA34) return L;	//N = 2
-			if(ch <= 0xAA36) return NSM;	//N = 2
-			if(0xAA43 == ch) return NSM;
-			if(0xAA4C == ch) return NSM;
-			if(0xAAB0 == ch) return NSM;
-			if(ch <= 0xAAB1) return L;
-			if(ch <= 0xAAB4) return NSM;	//N = 3
-			if(ch <= 0xAAB6) return L;	//N = 2
-			if(ch <= 0xAAB8) return NSM;	//N = 2
-			if(ch <= 0xAABD) return L;	//N = 5
-			if(ch <= 0xAABF) return NSM;	//N = 2
-			if(0xAAC1 == ch) return NSM;
-			if(ch <= 0xAAEB) return L;	//N = 42
-			if(ch <= 0xAAED) return NSM;	//N = 2
-			if(0xAAF6 == ch) return NSM;
-			if(0xABE5 == ch) return NSM;
-			if(0xABE8 == ch) return NSM;
-			if(0xABED == ch) return NSM;
-			if(ch <= 0xFB17) return L;	//N = 20264
-			if(0xFB1E == ch) return NSM;
-			if(0xFB29 == ch) return ES;
-			if(ch <= 0xFB4F) return R;	//N = 38
-			if(ch <= 0xFD3D) return AL;	//N = 494
-			if(ch <= 0xFD3F) return ON;	//N = 2
-			if(ch <= 0xFDFC) return AL;	//N = 173
-			if(0xFDFD == ch) return ON;
-			if(ch <= 0xFE0F) return NSM;	//N = 16
-			if(ch <= 0xFE19) return ON;	//N = 10
-			if(ch <= 0xFE26) return NSM;	//N = 7
-			if(ch <= 0xFE4F) return ON;	//N = 32
-			if(ch <= 0xFE52) return (ch & 1 ? ON : CS);
-			if(0xFE55 == ch) return CS;
-			if(0xFE5F == ch) return ET;
-			if(ch <= 0xFE61) return ON;	//N = 2
-			if(ch <= 0xFE63) return ES;	//N = 2
-			if(ch <= 0xFE68) return ON;	//N = 5
-			if(ch <= 0xFE6A) return ET;	//N = 2
-			if(0xFE6B == ch) return ON;
-			if(ch <= 0xFEFC) return AL;	//N = 141
-			if(0xFEFF == ch) return BN;
-			if(ch <= 0xFF02) return ON;	//N = 2
-			if(ch <= 0xFF05) return ET;	//N = 3
-			if(ch <= 0xFF0A) return ON;	//N = 5
-			if(ch <= 0xFF0D) return (ch & 1 ? ES : CS);
-			if(ch <= 0xFF0F) return CS;	//N = 2
-			if(ch <= 0xFF19) return EN;	//N = 10
-			if(0xFF1A == ch) return CS;
-			if(ch <= 0xFF20) return ON;	//N = 6
-			if(ch <= 0xFF3A) return L;	//N = 26
-			if(ch <= 0xFF40) return ON;	//N = 6
-			if(ch <= 0xFF5A) return L;	//N = 26
-			if(ch <= 0xFF65) return ON;	//N = 11
-			if(ch <= 0xFFDC) return L;	//N = 119
-			if(ch <= 0xFFE1) return ET;	//N = 2
-			if(ch <= 0xFFE4) return ON;	//N = 3
-			if(ch <= 0xFFE6) return ET;	//N = 2
-			if(ch <= 0xFFFD) return ON;	//N = 22
-
-			return ON;
+			return static_cast<t>(stage2[stage1[code >> 5]][code & 0x1F]);
 		}
 	}
 
@@ -508,6 +273,15 @@ namespace nana
 			levels_.clear();
 			const char_type * const end = str + len;
 
+			//A text without any RTL character is rendered in logical order as a whole.
+			if (!requires_reordering(str, len))
+			{
+				std::vector<unicode_bidi::entity> reordered;
+				if (len)
+					reordered.push_back(entity{ str, end, bidi_char::L, 0 });
+				return reordered;
+			}
+
 			std::vector<remember> stack;
 
 			remember cur = { 0, directional_override_status::neutral };
@@ -591,6 +365,32 @@ namespace nana
 			return reordered;
 		}
 
+		bool unicode_bidi::requires_reordering(const char_type* str, std::size_t len)
+		{
+			for (auto i = str, end = str + len; i != end; ++i)
+			{
+				//ASCII characters are never RTL
+				if (*i < 0x80)
+					continue;
+
+				switch (bidi_charmap::bidi_char_type(*i))
+				{
+				case bidi_charmap::R:
+				case bidi_charmap::AL:
+				case bidi_charmap::AN:
+				case bidi_charmap::LRE:
+				case bidi_charmap::LRO:
+				case bidi_charmap::RLE:
+				case bidi_charmap::RLO:
+				case bidi_charmap::PDF:
+					return true;
+				default:
+					break;
+				}
+			}
+			return false;
+		}
+
 		unsigned unicode_bidi::_m_paragraph_level(const char_type * begin, const char_type * end)
 		{
 			for(const char_type* i = begin; i != end; ++i)
@@ -942,8 +742,89 @@ namespace nana
 		}
 	//end class unicode_bidi
 
+	namespace
+	{
+		//Caches the results of recently reordered texts. The results are kept in offsets and
+		//relocated to the text of the caller.
+		class reorder_cache
+		{
+			using entity = unicode_bidi::entity;
+
+			struct run
+			{
+				std::size_t begin, end;
+				unicode_bidi::bidi_char bidi_char_type;
+				unsigned level;
+			};
+
+			struct item
+			{
+				std::size_t hash;
+				std::wstring text;
+				std::vector<run> runs;
+			};
+
+			static const std::size_t capacity = 32;
+			static const std::size_t max_length = 1024;	//The longer text is not cached.
+		public:
+			std::vector<entity> reorder(const wchar_t* text, std::size_t len)
+			{
+				if ((len > max_length) || !unicode_bidi::requires_reordering(text, len))
+					return unicode_bidi{}.reorder(text, len);
+
+				std::lock_guard<std::mutex> lock(mutex_);
+
+				auto const hash = _m_hash(text, len);
+				for (auto i = items_.begin(); i != items_.end(); ++i)
+				{
+					if ((i->hash == hash) && (i->text.size() == len) && std::equal(text, text + len, i->text.begin()))
+					{
+						//Move the item to the front as the most recently used
+						items_.splice(items_.begin(), items_, i);
+
+						std::vector<entity> reordered;
+						reordered.reserve(i->runs.size());
+						for (auto & r : i->runs)
+							reordered.push_back(entity{ text + r.begin, text + r.end, r.bidi_char_type, r.level });
+
+						return reordered;
+					}
+				}
+
+				auto reordered = bidi_.reorder(text, len);
+
+				if (items_.size() >= capacity)
+					items_.pop_back();
+
+				items_.emplace_front();
+				auto & i = items_.front();
+				i.hash = hash;
+				i.text.assign(text, len);
+				i.runs.reserve(reordered.size());
+				for (auto & e : reordered)
+					i.runs.push_back(run{ static_cast<std::size_t>(e.begin - text), static_cast<std::size_t>(e.end - text), e.bidi_char_type, e.level });
+
+				return reordered;
+			}
+		private:
+			static std::size_t _m_hash(const wchar_t* text, std::size_t len)
+			{
+				//FNV-1a
+				std::size_t hash = 2166136261u;
+				for (auto end = text + len; text != end; ++text)
+					hash = (hash ^ static_cast<std::size_t>(*text)) * 16777619u;
+				return hash;
+			}
+		private:
+			std::mutex mutex_;
+			unicode_bidi bidi_;	//Reused for keeping the capacity of its internal buffer
+			std::list<item> items_;
+		};
+	}
+
 	std::vector<unicode_bidi::entity> unicode_reorder(const wchar_t* text, std::size_t length)
 	{
-		return unicode_bidi{}.reorder(text, length);
+		static reorder_cache cache;
+		return cache.reorder(text, length);
 	}
 }//end namespace nana